@@ -1,14 +1,37 @@
 // NOLINTBEGIN
 #include "option.hpp"
+#include "option_batch.hpp"
+#include "option_column_stats.hpp"
+#include "option_group_by.hpp"
+#include "option_hash_join.hpp"
+#include "option_iter.hpp"
+#include "option_kleene.hpp"
+#include "option_masked_column.hpp"
+#include "option_ranges.hpp"
+#include "option_result.hpp"
+#include "option_sort.hpp"
+#include "option_text.hpp"
+#include "option_ts.hpp"
+#include "perf_counters.hpp"
+#include <algorithm>
 #include <benchmark/benchmark.h>
 #include <cstddef>
+#include <cstdint>
+#include <expected>
+#include <limits>
 #include <optional>
+#include <ranges>
 #include <string>
+#include <string_view>
+#include <unordered_map>
+#include <unordered_set>
+#include <utility>
 #include <vector>
 
 static void BM_opt_option_massive(benchmark::State &state) {
+    bench::perf_region perf{ state };
     size_t sum = 0;
-    for (auto _ : state) {
+    for (auto _ : perf) {
         for (size_t i = 0; i < 1000000; ++i) {
             auto opt1 = opt::some(i % 1000);
             auto opt2 = (i % 2 == 0) ? opt::some(i % 500) : opt::none;
@@ -21,8 +44,9 @@ static void BM_opt_option_massive(benchmark::State &state) {
 BENCHMARK(BM_opt_option_massive);
 
 static void BM_std_optional_massive(benchmark::State &state) {
+    bench::perf_region perf{ state };
     size_t sum = 0;
-    for (auto _ : state) {
+    for (auto _ : perf) {
         for (size_t i = 0; i < 1000000; ++i) {
             auto opt1 = std::make_optional(i % 1000);
             auto opt2 = (i % 2 == 0) ? std::make_optional(i % 500) : std::nullopt;
@@ -35,8 +59,9 @@ static void BM_std_optional_massive(benchmark::State &state) {
 BENCHMARK(BM_std_optional_massive);
 
 static void BM_opt_option_string(benchmark::State &state) {
+    bench::perf_region perf{ state };
     size_t sum = 0;
-    for (auto _ : state) {
+    for (auto _ : perf) {
         for (size_t i = 0; i < 500000; ++i) {
             auto opt1    = opt::some(std::string("test_") + std::to_string(i % 100));
             auto opt2    = (i % 3 == 0) ? opt::some(std::string("value")) : opt::none;
@@ -51,8 +76,9 @@ static void BM_opt_option_string(benchmark::State &state) {
 BENCHMARK(BM_opt_option_string);
 
 static void BM_std_optional_string(benchmark::State &state) {
+    bench::perf_region perf{ state };
     size_t sum = 0;
-    for (auto _ : state) {
+    for (auto _ : perf) {
         for (size_t i = 0; i < 500000; ++i) {
             auto opt1    = std::make_optional(std::string("test_") + std::to_string(i % 100));
             auto opt2    = (i % 3 == 0) ? std::make_optional(std::string("value")) : std::nullopt;
@@ -67,8 +93,9 @@ static void BM_std_optional_string(benchmark::State &state) {
 BENCHMARK(BM_std_optional_string);
 
 static void BM_opt_option_chain(benchmark::State &state) {
+    bench::perf_region perf{ state };
     size_t sum = 0;
-    for (auto _ : state) {
+    for (auto _ : perf) {
         for (size_t i = 0; i < 1000000; ++i) {
             auto opt    = opt::some(i % 100);
             auto result = opt.map([](auto x) { return x * 2; });
@@ -85,8 +112,9 @@ static void BM_opt_option_chain(benchmark::State &state) {
 BENCHMARK(BM_opt_option_chain);
 
 static void BM_std_optional_chain(benchmark::State &state) {
+    bench::perf_region perf{ state };
     size_t sum = 0;
-    for (auto _ : state) {
+    for (auto _ : perf) {
         for (size_t i = 0; i < 1000000; ++i) {
             auto opt    = std::make_optional(i % 100);
             auto result = opt.transform([](auto x) { return x * 2; });
@@ -103,8 +131,9 @@ static void BM_std_optional_chain(benchmark::State &state) {
 BENCHMARK(BM_std_optional_chain);
 
 static void BM_opt_option_memory(benchmark::State &state) {
+    bench::perf_region perf{ state };
     size_t sum = 0;
-    for (auto _ : state) {
+    for (auto _ : perf) {
         for (size_t i = 0; i < 10000; ++i) {
             std::vector<opt::option<int>> options;
             options.reserve(100);
@@ -125,8 +154,9 @@ static void BM_opt_option_memory(benchmark::State &state) {
 BENCHMARK(BM_opt_option_memory);
 
 static void BM_std_optional_memory(benchmark::State &state) {
+    bench::perf_region perf{ state };
     size_t sum = 0;
-    for (auto _ : state) {
+    for (auto _ : perf) {
         for (size_t i = 0; i < 10000; ++i) {
             std::vector<std::optional<int>> options;
             options.reserve(100);
@@ -147,9 +177,10 @@ static void BM_std_optional_memory(benchmark::State &state) {
 BENCHMARK(BM_std_optional_memory);
 
 static void BM_opt_option_unwrap_none(benchmark::State &state) {
+    bench::perf_region perf{ state };
     opt::option<int> none = opt::none;
     int cnt               = 0;
-    for (auto _ : state) {
+    for (auto _ : perf) {
         for (int i = 0; i < 10000; ++i) {
             try {
                 cnt += none.unwrap();
@@ -163,9 +194,10 @@ static void BM_opt_option_unwrap_none(benchmark::State &state) {
 BENCHMARK(BM_opt_option_unwrap_none);
 
 static void BM_std_optional_value_nullopt(benchmark::State &state) {
+    bench::perf_region perf{ state };
     std::optional<int> none = std::nullopt;
     int cnt                 = 0;
-    for (auto _ : state) {
+    for (auto _ : perf) {
         for (int i = 0; i < 10000; ++i) {
             try {
                 cnt += none.value();
@@ -179,8 +211,9 @@ static void BM_std_optional_value_nullopt(benchmark::State &state) {
 BENCHMARK(BM_std_optional_value_nullopt);
 
 static void BM_opt_option_flatten(benchmark::State &state) {
+    bench::perf_region perf{ state };
     size_t sum = 0;
-    for (auto _ : state) {
+    for (auto _ : perf) {
         for (int i = 0; i < 1000000; ++i) {
             auto nested = (i % 2 == 0) ? opt::some(opt::some(i)) : opt::none;
             sum += nested.flatten().unwrap_or(0);
@@ -191,8 +224,9 @@ static void BM_opt_option_flatten(benchmark::State &state) {
 BENCHMARK(BM_opt_option_flatten);
 
 static void BM_std_optional_flatten(benchmark::State &state) {
+    bench::perf_region perf{ state };
     size_t sum = 0;
-    for (auto _ : state) {
+    for (auto _ : perf) {
         for (int i = 0; i < 1000000; ++i) {
             auto nested = (i % 2 == 0) ? std::make_optional(std::make_optional(i)) : std::nullopt;
             // flatten: if nested.has_value() && nested->has_value() return value, else 0
@@ -204,9 +238,10 @@ static void BM_std_optional_flatten(benchmark::State &state) {
 BENCHMARK(BM_std_optional_flatten);
 
 static void BM_opt_option_ptr(benchmark::State &state) {
+    bench::perf_region perf{ state };
     int v      = 42;
     size_t sum = 0;
-    for (auto _ : state) {
+    for (auto _ : perf) {
         for (int i = 0; i < 10000000; ++i) {
             auto o = (i % 2 == 0) ? opt::some(&v) : opt::none;
             sum += o.unwrap_or(nullptr) ? 1 : 0;
@@ -217,9 +252,10 @@ static void BM_opt_option_ptr(benchmark::State &state) {
 BENCHMARK(BM_opt_option_ptr);
 
 static void BM_std_optional_ptr(benchmark::State &state) {
+    bench::perf_region perf{ state };
     int v    = 42;
     size_t sum = 0;
-    for (auto _ : state) {
+    for (auto _ : perf) {
         for (int i = 0; i < 10000000; ++i) {
             auto o = (i % 2 == 0) ? std::make_optional(&v) : std::nullopt;
             sum += o.value_or(nullptr) ? 1 : 0;
@@ -230,7 +266,8 @@ static void BM_std_optional_ptr(benchmark::State &state) {
 BENCHMARK(BM_std_optional_ptr);
 
 static void BM_opt_option_vector_move(benchmark::State &state) {
-    for (auto _ : state) {
+    bench::perf_region perf{ state };
+    for (auto _ : perf) {
         std::vector v(100, 42);
         auto o = opt::some(std::move(v));
         benchmark::DoNotOptimize(o);
@@ -239,7 +276,8 @@ static void BM_opt_option_vector_move(benchmark::State &state) {
 BENCHMARK(BM_opt_option_vector_move);
 
 static void BM_std_optional_vector_move(benchmark::State &state) {
-    for (auto _ : state) {
+    bench::perf_region perf{ state };
+    for (auto _ : perf) {
         std::vector v(100, 42);
         auto o = std::make_optional(std::move(v));
         benchmark::DoNotOptimize(o);
@@ -248,8 +286,9 @@ static void BM_std_optional_vector_move(benchmark::State &state) {
 BENCHMARK(BM_std_optional_vector_move);
 
 static void BM_opt_option_and(benchmark::State &state) {
+    bench::perf_region perf{ state };
     size_t sum = 0;
-    for (auto _ : state) {
+    for (auto _ : perf) {
         for (int i = 0; i < 1000000; ++i) {
             auto o1 = (i % 2 == 0) ? opt::some(i) : opt::none;
             auto o2 = (i % 3 == 0) ? opt::some(i * 2) : opt::none;
@@ -261,8 +300,9 @@ static void BM_opt_option_and(benchmark::State &state) {
 BENCHMARK(BM_opt_option_and);
 
 static void BM_std_optional_and(benchmark::State &state) {
+    bench::perf_region perf{ state };
     size_t sum = 0;
-    for (auto _ : state) {
+    for (auto _ : perf) {
         for (int i = 0; i < 1000000; ++i) {
             auto o1     = (i % 2 == 0) ? std::make_optional(i) : std::nullopt;
             auto o2     = (i % 3 == 0) ? std::make_optional(i * 2) : std::nullopt;
@@ -275,8 +315,9 @@ static void BM_std_optional_and(benchmark::State &state) {
 BENCHMARK(BM_std_optional_and);
 
 static void BM_opt_option_or(benchmark::State &state) {
+    bench::perf_region perf{ state };
     size_t sum = 0;
-    for (auto _ : state) {
+    for (auto _ : perf) {
         for (int i = 0; i < 1000000; ++i) {
             auto o1 = (i % 2 == 0) ? opt::some(i) : opt::none;
             auto o2 = (i % 3 == 0) ? opt::some(i * 2) : opt::none;
@@ -288,8 +329,9 @@ static void BM_opt_option_or(benchmark::State &state) {
 BENCHMARK(BM_opt_option_or);
 
 static void BM_std_optional_or(benchmark::State &state) {
+    bench::perf_region perf{ state };
     size_t sum = 0;
-    for (auto _ : state) {
+    for (auto _ : perf) {
         for (int i = 0; i < 1000000; ++i) {
             auto o1     = (i % 2 == 0) ? std::make_optional(i) : std::nullopt;
             auto o2     = (i % 3 == 0) ? std::make_optional(i * 2) : std::nullopt;
@@ -302,8 +344,9 @@ static void BM_std_optional_or(benchmark::State &state) {
 BENCHMARK(BM_std_optional_or);
 
 static void BM_opt_option_xor(benchmark::State &state) {
+    bench::perf_region perf{ state };
     size_t sum = 0;
-    for (auto _ : state) {
+    for (auto _ : perf) {
         for (int i = 0; i < 1000000; ++i) {
             auto o1 = (i % 2 == 0) ? opt::some(i) : opt::none;
             auto o2 = (i % 3 == 0) ? opt::some(i * 2) : opt::none;
@@ -315,8 +358,9 @@ static void BM_opt_option_xor(benchmark::State &state) {
 BENCHMARK(BM_opt_option_xor);
 
 static void BM_std_optional_xor(benchmark::State &state) {
+    bench::perf_region perf{ state };
     size_t sum = 0;
-    for (auto _ : state) {
+    for (auto _ : perf) {
         for (int i = 0; i < 1000000; ++i) {
             auto o1     = (i % 2 == 0) ? std::make_optional(i) : std::nullopt;
             auto o2     = (i % 3 == 0) ? std::make_optional(i * 2) : std::nullopt;
@@ -328,5 +372,703 @@ static void BM_std_optional_xor(benchmark::State &state) {
 }
 BENCHMARK(BM_std_optional_xor);
 
-BENCHMARK_MAIN();
+static void BM_opt_ranges_find(benchmark::State &state) {
+    bench::perf_region perf{ state };
+    const int n = static_cast<int>(state.range(0));
+    std::vector<int> values(static_cast<size_t>(n));
+    for (int i = 0; i < n; ++i) {
+        values[static_cast<size_t>(i)] = i;
+    }
+    size_t sum = 0;
+    int key = 0;
+    for (auto _ : perf) {
+        key = (key + 7919) % n;
+        sum += opt::ranges::find(values, key).map([](const int &v) { return static_cast<size_t>(v); }).unwrap_or(0);
+    }
+    benchmark::DoNotOptimize(sum);
+}
+BENCHMARK(BM_opt_ranges_find)->Arg(64)->Arg(1024)->Arg(65536);
+
+static void BM_std_ranges_find(benchmark::State &state) {
+    bench::perf_region perf{ state };
+    const int n = static_cast<int>(state.range(0));
+    std::vector<int> values(static_cast<size_t>(n));
+    for (int i = 0; i < n; ++i) {
+        values[static_cast<size_t>(i)] = i;
+    }
+    size_t sum = 0;
+    int key = 0;
+    for (auto _ : perf) {
+        key = (key + 7919) % n;
+        auto it = std::ranges::find(values, key);
+        sum += it != values.end() ? static_cast<size_t>(*it) : 0;
+    }
+    benchmark::DoNotOptimize(sum);
+}
+BENCHMARK(BM_std_ranges_find)->Arg(64)->Arg(1024)->Arg(65536);
+
+static auto sorted_ids(size_t n) -> std::vector<int> {
+    std::vector<int> ids(n);
+    for (size_t i = 0; i < n; ++i) {
+        ids[i] = static_cast<int>(i * 3);
+    }
+    return ids;
+}
+
+static auto probe_keys(size_t n) -> std::vector<int> {
+    std::vector<int> keys(4096);
+    uint64_t x = 0x9e3779b97f4a7c15ULL;
+    for (auto &key : keys) {
+        x ^= x << 13;
+        x ^= x >> 7;
+        x ^= x << 17;
+        key = static_cast<int>(x % (3 * n));
+    }
+    return keys;
+}
+
+static void BM_std_lower_bound(benchmark::State &state) {
+    bench::perf_region perf{ state };
+    const auto ids = sorted_ids(static_cast<size_t>(state.range(0)));
+    const auto keys = probe_keys(ids.size());
+    size_t sum = 0;
+    for (auto _ : perf) {
+        for (const int key : keys) {
+            auto it = std::lower_bound(ids.begin(), ids.end(), key);
+            sum += it != ids.end() && *it == key ? static_cast<size_t>(it - ids.begin()) : 0;
+        }
+    }
+    benchmark::DoNotOptimize(sum);
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * keys.size()));
+}
+BENCHMARK(BM_std_lower_bound)->Arg(1 << 10)->Arg(1 << 20)->Arg(10'000'000);
+
+static void BM_opt_binary_position(benchmark::State &state) {
+    bench::perf_region perf{ state };
+    const auto ids = sorted_ids(static_cast<size_t>(state.range(0)));
+    const auto keys = probe_keys(ids.size());
+    size_t sum = 0;
+    for (auto _ : perf) {
+        for (const int key : keys) {
+            sum += opt::ranges::binary_position(ids, key).unwrap_or(0);
+        }
+    }
+    benchmark::DoNotOptimize(sum);
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * keys.size()));
+}
+BENCHMARK(BM_opt_binary_position)->Arg(1 << 10)->Arg(1 << 20)->Arg(10'000'000);
+
+static void BM_opt_binary_positions(benchmark::State &state) {
+    bench::perf_region perf{ state };
+    const auto ids = sorted_ids(static_cast<size_t>(state.range(0)));
+    const auto keys = probe_keys(ids.size());
+    std::vector<opt::option<size_t>> found(keys.size());
+    size_t sum = 0;
+    for (auto _ : perf) {
+        opt::ranges::binary_positions(ids, keys, found.begin());
+        for (const auto &i : found) {
+            sum += i.unwrap_or(0);
+        }
+    }
+    benchmark::DoNotOptimize(sum);
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * keys.size()));
+}
+BENCHMARK(BM_opt_binary_positions)->Arg(1 << 10)->Arg(1 << 20)->Arg(10'000'000);
+
+static void BM_opt_eytzinger(benchmark::State &state) {
+    bench::perf_region perf{ state };
+    const opt::ranges::eytzinger<int> ids{ sorted_ids(static_cast<size_t>(state.range(0))) };
+    const auto keys = probe_keys(ids.size());
+    size_t sum = 0;
+    for (auto _ : perf) {
+        for (const int key : keys) {
+            sum += ids.position(key).unwrap_or(0);
+        }
+    }
+    benchmark::DoNotOptimize(sum);
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * keys.size()));
+}
+BENCHMARK(BM_opt_eytzinger)->Arg(1 << 10)->Arg(1 << 20)->Arg(10'000'000);
+
+static auto nullable_column(size_t n) -> std::vector<opt::option<int>> {
+    std::vector<opt::option<int>> column(n);
+    uint64_t x = 0x2545f4914f6cdd1dULL;
+    for (auto &value : column) {
+        x ^= x << 13;
+        x ^= x >> 7;
+        x ^= x << 17;
+        if (x % 5 != 0) {
+            value = static_cast<int>(x >> 32);
+        }
+    }
+    return column;
+}
+
+static void BM_opt_sort_nullable(benchmark::State &state) {
+    bench::perf_region perf{ state };
+    const auto column = nullable_column(static_cast<size_t>(state.range(0)));
+    for (auto _ : perf) {
+        auto sorted = column;
+        opt::sort(sorted, opt::none_position::last);
+        benchmark::DoNotOptimize(sorted.data());
+    }
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * column.size()));
+}
+BENCHMARK(BM_opt_sort_nullable)->Arg(1 << 10)->Arg(1 << 20);
+
+static void BM_std_sort_nullable(benchmark::State &state) {
+    bench::perf_region perf{ state };
+    const auto column = nullable_column(static_cast<size_t>(state.range(0)));
+    for (auto _ : perf) {
+        auto sorted = column;
+        std::sort(sorted.begin(), sorted.end(), [](const opt::option<int> &a, const opt::option<int> &b) {
+            return a.is_some() && (b.is_none() || *a < *b);
+        });
+        benchmark::DoNotOptimize(sorted.data());
+    }
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * column.size()));
+}
+BENCHMARK(BM_std_sort_nullable)->Arg(1 << 10)->Arg(1 << 20);
+
+// `n` rows over `groups` distinct keys, with 20% `none` keys and values.
+static auto grouping_columns(size_t n, size_t groups)
+    -> std::pair<std::vector<opt::option<int>>, std::vector<opt::option<int>>> {
+    auto keys = nullable_column(n);
+    for (auto &key : keys) {
+        if (key.is_some()) {
+            key = static_cast<int>(static_cast<unsigned>(*key) % groups * 2654435761U);
+        }
+    }
+    auto values = nullable_column(n);
+    std::ranges::reverse(values);
+    return { std::move(keys), std::move(values) };
+}
+
+static void BM_opt_group_by(benchmark::State &state) {
+    bench::perf_region perf{ state };
+    const auto [keys, values]
+        = grouping_columns(static_cast<size_t>(state.range(0)), static_cast<size_t>(state.range(1)));
+    const opt::group_by_options options{ .min = false, .max = false, .first = false, .last = false };
+    for (auto _ : perf) {
+        auto groups = opt::group_by(keys, values, options);
+        benchmark::DoNotOptimize(groups.sum.data());
+    }
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * keys.size()));
+}
+BENCHMARK(BM_opt_group_by)->Args({ 1 << 20, 1 << 10 })->Args({ 1 << 20, 1 << 18 });
+
+static void BM_std_unordered_map_group_by(benchmark::State &state) {
+    bench::perf_region perf{ state };
+    const auto [keys, values]
+        = grouping_columns(static_cast<size_t>(state.range(0)), static_cast<size_t>(state.range(1)));
+    for (auto _ : perf) {
+        std::unordered_map<int, std::pair<size_t, long long>> groups;
+        std::pair<size_t, long long> null_group{};
+        for (size_t i = 0; i < keys.size(); ++i) {
+            auto &group = keys[i].is_some() ? groups[*keys[i]] : null_group;
+            if (values[i].is_some()) {
+                ++group.first;
+                group.second += *values[i];
+            }
+        }
+        benchmark::DoNotOptimize(groups.size());
+    }
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * keys.size()));
+}
+BENCHMARK(BM_std_unordered_map_group_by)->Args({ 1 << 20, 1 << 10 })->Args({ 1 << 20, 1 << 18 });
+
+// Probes `n` rows against a build side of `n / 4` rows with distinct keys.
+static auto join_columns(size_t n) -> std::pair<std::vector<opt::option<int>>, std::vector<opt::option<int>>> {
+    auto probe = nullable_column(n);
+    for (auto &key : probe) {
+        if (key.is_some()) {
+            key = static_cast<int>(static_cast<unsigned>(*key) % (n / 2));
+        }
+    }
+    std::vector<opt::option<int>> build(n / 4);
+    for (size_t i = 0; i < build.size(); ++i) {
+        build[i] = static_cast<int>(2 * i);
+    }
+    return { std::move(probe), std::move(build) };
+}
+
+static void BM_opt_hash_join(benchmark::State &state) {
+    bench::perf_region perf{ state };
+    const auto [probe, build] = join_columns(static_cast<size_t>(state.range(0)));
+    for (auto _ : perf) {
+        auto joined = opt::hash_join(probe, build);
+        benchmark::DoNotOptimize(joined.left.data());
+    }
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * probe.size()));
+}
+BENCHMARK(BM_opt_hash_join)->Arg(1 << 16)->Arg(1 << 22);
+
+static void BM_std_unordered_multimap_join(benchmark::State &state) {
+    bench::perf_region perf{ state };
+    const auto [probe, build] = join_columns(static_cast<size_t>(state.range(0)));
+    for (auto _ : perf) {
+        std::unordered_multimap<int, size_t> table;
+        table.reserve(build.size());
+        for (size_t i = 0; i < build.size(); ++i) {
+            if (build[i].is_some()) {
+                table.emplace(*build[i], i);
+            }
+        }
+        std::vector<std::pair<size_t, size_t>> joined;
+        for (size_t i = 0; i < probe.size(); ++i) {
+            if (probe[i].is_some()) {
+                const auto [first, last] = table.equal_range(*probe[i]);
+                for (auto it = first; it != last; ++it) {
+                    joined.emplace_back(i, it->second);
+                }
+            }
+        }
+        benchmark::DoNotOptimize(joined.data());
+    }
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * probe.size()));
+}
+BENCHMARK(BM_std_unordered_multimap_join)->Arg(1 << 16)->Arg(1 << 22);
+
+// A price series with 1% of the rows missing.
+static auto gappy_series(size_t n) -> std::vector<opt::option<double>> {
+    std::vector<opt::option<double>> series(n);
+    uint64_t x = 0x9e3779b97f4a7c15ULL;
+    for (size_t i = 0; i < n; ++i) {
+        x ^= x << 13;
+        x ^= x >> 7;
+        x ^= x << 17;
+        if (x % 100 != 0) {
+            series[i] = static_cast<double>(i);
+        }
+    }
+    return series;
+}
+
+static void BM_opt_ts_ffill(benchmark::State &state) {
+    bench::perf_region perf{ state };
+    const auto series = gappy_series(static_cast<size_t>(state.range(0)));
+    for (auto _ : perf) {
+        auto filled = series;
+        opt::ts::ffill(filled);
+        benchmark::DoNotOptimize(filled.data());
+    }
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * series.size()));
+}
+BENCHMARK(BM_opt_ts_ffill)->Arg(1 << 20);
+
+static void BM_opt_ts_ffill_masked(benchmark::State &state) {
+    bench::perf_region perf{ state };
+    const opt::masked_column series{ gappy_series(static_cast<size_t>(state.range(0))) };
+    for (auto _ : perf) {
+        auto filled = series;
+        opt::ts::ffill(filled);
+        benchmark::DoNotOptimize(filled.values().data());
+    }
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * series.size()));
+}
+BENCHMARK(BM_opt_ts_ffill_masked)->Arg(1 << 20);
+
+static void BM_naive_ffill(benchmark::State &state) {
+    bench::perf_region perf{ state };
+    const auto series = gappy_series(static_cast<size_t>(state.range(0)));
+    for (auto _ : perf) {
+        auto filled = series;
+        opt::option<double> last;
+        for (auto &value : filled) {
+            if (value.is_none()) {
+                value = last;
+            } else {
+                last = value;
+            }
+        }
+        benchmark::DoNotOptimize(filled.data());
+    }
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * series.size()));
+}
+BENCHMARK(BM_naive_ffill)->Arg(1 << 20);
+
+static void BM_opt_ts_rolling_mean(benchmark::State &state) {
+    bench::perf_region perf{ state };
+    const auto series = gappy_series(1 << 20);
+    const auto window = static_cast<size_t>(state.range(0));
+    for (auto _ : perf) {
+        auto means = opt::ts::rolling_mean(series, window);
+        benchmark::DoNotOptimize(means.data());
+    }
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * series.size()));
+}
+BENCHMARK(BM_opt_ts_rolling_mean)->Arg(16)->Arg(256);
+
+// Recomputes every window, O(n * window).
+static void BM_naive_rolling_mean(benchmark::State &state) {
+    bench::perf_region perf{ state };
+    const auto series = gappy_series(1 << 20);
+    const auto window = static_cast<size_t>(state.range(0));
+    for (auto _ : perf) {
+        std::vector<opt::option<double>> means(series.size());
+        for (size_t i = 0; i < series.size(); ++i) {
+            double sum = 0;
+            size_t count = 0;
+            for (size_t j = i + 1 > window ? i + 1 - window : 0; j <= i; ++j) {
+                if (series[j].is_some()) {
+                    sum += *series[j];
+                    ++count;
+                }
+            }
+            if (count != 0) {
+                means[i] = sum / static_cast<double>(count);
+            }
+        }
+        benchmark::DoNotOptimize(means.data());
+    }
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * series.size()));
+}
+BENCHMARK(BM_naive_rolling_mean)->Arg(16)->Arg(256);
+
+// Predicates that are 1/8 `none`, 3/8 `false` and 1/2 `true`.
+static auto predicate_columns(size_t n, size_t count) -> std::vector<std::vector<opt::option<bool>>> {
+    std::vector<std::vector<opt::option<bool>>> predicates(count, std::vector<opt::option<bool>>(n));
+    uint64_t x = 0x2545f4914f6cdd1dULL;
+    for (auto &predicate : predicates) {
+        for (auto &value : predicate) {
+            x ^= x << 13;
+            x ^= x >> 7;
+            x ^= x << 17;
+            if (x % 8 != 0) {
+                value = x % 8 > 3;
+            }
+        }
+    }
+    return predicates;
+}
+
+static void BM_opt_kleene_column_and(benchmark::State &state) {
+    bench::perf_region perf{ state };
+    std::vector<opt::kleene::column> predicates;
+    for (const auto &predicate : predicate_columns(1 << 20, 8)) {
+        predicates.emplace_back(predicate);
+    }
+    for (auto _ : perf) {
+        auto all = predicates.front();
+        for (size_t p = 1; p < predicates.size(); ++p) {
+            all &= predicates[p];
+        }
+        benchmark::DoNotOptimize(all.values().data());
+    }
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * 8 * (1 << 20)));
+}
+BENCHMARK(BM_opt_kleene_column_and);
+
+static void BM_opt_kleene_scalar_and(benchmark::State &state) {
+    bench::perf_region perf{ state };
+    const auto predicates = predicate_columns(1 << 20, 8);
+    for (auto _ : perf) {
+        auto all = predicates.front();
+        for (size_t p = 1; p < predicates.size(); ++p) {
+            for (size_t i = 0; i < all.size(); ++i) {
+                all[i] = opt::kleene::and_(all[i], predicates[p][i]);
+            }
+        }
+        benchmark::DoNotOptimize(all.data());
+    }
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * 8 * (1 << 20)));
+}
+BENCHMARK(BM_opt_kleene_scalar_and);
+
+static void BM_opt_batch_div_masked(benchmark::State &state) {
+    bench::perf_region perf{ state };
+    const opt::masked_column<double> prices{ gappy_series(1 << 20) };
+    const opt::masked_column<double> volumes{ gappy_series(1 << 20) };
+    for (auto _ : perf) {
+        auto ratio = opt::batch::div(prices, volumes);
+        benchmark::DoNotOptimize(ratio.values().data());
+    }
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * (1 << 20)));
+}
+BENCHMARK(BM_opt_batch_div_masked);
+
+static void BM_opt_batch_div_options(benchmark::State &state) {
+    bench::perf_region perf{ state };
+    const auto prices = gappy_series(1 << 20);
+    const auto volumes = gappy_series(1 << 20);
+    for (auto _ : perf) {
+        auto ratio = opt::batch::div(prices, volumes);
+        benchmark::DoNotOptimize(ratio.data());
+    }
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * (1 << 20)));
+}
+BENCHMARK(BM_opt_batch_div_options);
+
+static void BM_opt_zip_with_div(benchmark::State &state) {
+    bench::perf_region perf{ state };
+    const auto prices = gappy_series(1 << 20);
+    const auto volumes = gappy_series(1 << 20);
+    for (auto _ : perf) {
+        std::vector<opt::option<double>> ratio(prices.size());
+        for (size_t i = 0; i < prices.size(); ++i) {
+            ratio[i] = prices[i]
+                           .zip_with(volumes[i],
+                                     [](double p, double v) -> opt::option<double> {
+                                         if (v == 0) {
+                                             return opt::none;
+                                         }
+                                         return p / v;
+                                     })
+                           .flatten();
+        }
+        benchmark::DoNotOptimize(ratio.data());
+    }
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * (1 << 20)));
+}
+BENCHMARK(BM_opt_zip_with_div);
+
+// A million join matches into a table of 4M prices, one in five unmatched.
+static auto join_matches() -> std::vector<opt::option<std::uint32_t>> {
+    std::vector<opt::option<std::uint32_t>> matches(1 << 20);
+    std::uint32_t seed = 12345;
+    for (auto &match : matches) {
+        seed = seed * 1664525U + 1013904223U;
+        if (seed % 5 != 0) {
+            match = (seed >> 8) % (1U << 22);
+        }
+    }
+    return matches;
+}
+
+static void BM_opt_batch_gather(benchmark::State &state) {
+    bench::perf_region perf{ state };
+    const std::vector<double> prices(1 << 22, 1.5);
+    const auto matches = join_matches();
+    for (auto _ : perf) {
+        auto joined = opt::batch::gather(prices, matches);
+        benchmark::DoNotOptimize(joined.data());
+    }
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * (1 << 20)));
+}
+BENCHMARK(BM_opt_batch_gather);
+
+static void BM_branchy_gather(benchmark::State &state) {
+    bench::perf_region perf{ state };
+    const std::vector<double> prices(1 << 22, 1.5);
+    const auto matches = join_matches();
+    for (auto _ : perf) {
+        std::vector<opt::option<double>> joined(matches.size());
+        for (size_t i = 0; i < matches.size(); ++i) {
+            if (matches[i].is_some()) {
+                joined[i] = prices[*matches[i]];
+            }
+        }
+        benchmark::DoNotOptimize(joined.data());
+    }
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * (1 << 20)));
+}
+BENCHMARK(BM_branchy_gather);
+
+static void BM_opt_stats_profile(benchmark::State &state) {
+    bench::perf_region perf{ state };
+    const auto column = nullable_column(1 << 20);
+    opt::stats::profile_options options;
+    options.histogram = { .lo = std::numeric_limits<int>::min(), .hi = std::numeric_limits<int>::max(), .bins = 64 };
+    for (auto _ : perf) {
+        auto profile = opt::stats::profile(column, options);
+        benchmark::DoNotOptimize(profile.distinct());
+    }
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * (1 << 20)));
+}
+BENCHMARK(BM_opt_stats_profile);
+
+// None count, bounds, histogram and exact distinct count in four passes.
+static void BM_four_pass_profile(benchmark::State &state) {
+    bench::perf_region perf{ state };
+    const auto column = nullable_column(1 << 20);
+    for (auto _ : perf) {
+        const auto nones = std::ranges::count_if(column, [](const auto &o) { return o.is_none(); });
+        int lo = std::numeric_limits<int>::max();
+        int hi = std::numeric_limits<int>::min();
+        for (const auto &o : column) {
+            if (o.is_some()) {
+                lo = std::min(lo, *o);
+                hi = std::max(hi, *o);
+            }
+        }
+        std::vector<uint64_t> bins(64);
+        for (const auto &o : column) {
+            if (o.is_some()) {
+                ++bins[static_cast<size_t>((static_cast<int64_t>(*o) - std::numeric_limits<int>::min()) >> 26)];
+            }
+        }
+        std::unordered_set<int> distinct;
+        for (const auto &o : column) {
+            if (o.is_some()) {
+                distinct.insert(*o);
+            }
+        }
+        benchmark::DoNotOptimize(nones + lo + hi + bins[0] + distinct.size());
+    }
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * (1 << 20)));
+}
+BENCHMARK(BM_four_pass_profile);
+
+enum class token_error : uint8_t { empty, bad_digit };
+
+[[gnu::noinline]] static auto parse_result(std::string_view token) -> opt::result<int, token_error> {
+    if (token.empty()) {
+        return opt::err(token_error::empty);
+    }
+    int value = 0;
+    for (const char c : token) {
+        if (c < '0' || c > '9') {
+            return opt::err(token_error::bad_digit);
+        }
+        value = value * 10 + (c - '0');
+    }
+    return value;
+}
+
+[[gnu::noinline]] static auto parse_expected(std::string_view token) -> std::expected<int, token_error> {
+    if (token.empty()) {
+        return std::unexpected(token_error::empty);
+    }
+    int value = 0;
+    for (const char c : token) {
+        if (c < '0' || c > '9') {
+            return std::unexpected(token_error::bad_digit);
+        }
+        value = value * 10 + (c - '0');
+    }
+    return value;
+}
+
+// Numbers, of which one in `errors_per_8` out of 8 is not one.
+static auto parse_tokens(int64_t errors_per_8) -> std::vector<std::string> {
+    std::vector<std::string> tokens;
+    for (int i = 0; i < 1 << 16; ++i) {
+        tokens.push_back((i % 8 < errors_per_8 ? "x" : "") + std::to_string(i));
+    }
+    return tokens;
+}
+
+static void BM_opt_result_parse(benchmark::State &state) {
+    bench::perf_region perf{ state };
+    const auto tokens = parse_tokens(state.range(0));
+    for (auto _ : perf) {
+        int64_t sum = 0;
+        for (const auto &token : tokens) {
+            sum += parse_result(token).unwrap_or(-1);
+        }
+        benchmark::DoNotOptimize(sum);
+    }
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * tokens.size()));
+}
+BENCHMARK(BM_opt_result_parse)->Arg(0)->Arg(4);
+
+static void BM_std_expected_parse(benchmark::State &state) {
+    bench::perf_region perf{ state };
+    const auto tokens = parse_tokens(state.range(0));
+    for (auto _ : perf) {
+        int64_t sum = 0;
+        for (const auto &token : tokens) {
+            sum += parse_expected(token).value_or(-1);
+        }
+        benchmark::DoNotOptimize(sum);
+    }
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * tokens.size()));
+}
+BENCHMARK(BM_std_expected_parse)->Arg(0)->Arg(4);
+
+// Readings in [0, 1000), run through the same filter, transform and
+// take-while pipeline by both protocols; no reading stops the take-while.
+static auto pipeline_readings() -> std::vector<int> {
+    std::vector<int> readings(1 << 16);
+    for (size_t i = 0; i < readings.size(); ++i) {
+        readings[i] = static_cast<int>((i * 2654435761U) % 1000);
+    }
+    return readings;
+}
+
+static void BM_opt_iter_pipeline(benchmark::State &state) {
+    bench::perf_region perf{ state };
+    const auto readings = pipeline_readings();
+    for (auto _ : perf) {
+        const int64_t sum = opt::iter::from(readings)
+                                .filter([](int x) { return x % 3 != 0; })
+                                .map([](int x) { return int64_t{ x } * x; })
+                                .take_while([](int64_t x) { return x < 1000000; })
+                                .fold(int64_t{ 0 }, std::plus{});
+        benchmark::DoNotOptimize(sum);
+    }
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * readings.size()));
+}
+BENCHMARK(BM_opt_iter_pipeline);
+
+static void BM_std_views_pipeline(benchmark::State &state) {
+    bench::perf_region perf{ state };
+    const auto readings = pipeline_readings();
+    for (auto _ : perf) {
+        int64_t sum = 0;
+        for (const int64_t x : readings | std::views::filter([](int x) { return x % 3 != 0; })
+                                   | std::views::transform([](int x) { return int64_t{ x } * x; })
+                                   | std::views::take_while([](int64_t x) { return x < 1000000; })) {
+            sum += x;
+        }
+        benchmark::DoNotOptimize(sum);
+    }
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * readings.size()));
+}
+BENCHMARK(BM_std_views_pipeline);
+
+// Numbers separated by spaces, with a tab every fifth.
+static auto token_line() -> std::string {
+    std::string line;
+    for (int i = 0; i < 1 << 16; ++i) {
+        line += std::to_string(i * 7919 % 100000) + (i % 5 != 0 ? " " : "\t");
+    }
+    return line;
+}
+
+static void BM_opt_text_tokenize(benchmark::State &state) {
+    bench::perf_region perf{ state };
+    const std::string line = token_line();
+    for (auto _ : perf) {
+        const size_t chars = opt::text::tokenizer{ line, " \t" }.fold(
+            size_t{ 0 }, [](size_t n, std::string_view token) { return n + token.size(); });
+        benchmark::DoNotOptimize(chars);
+    }
+    state.SetBytesProcessed(static_cast<int64_t>(state.iterations() * line.size()));
+}
+BENCHMARK(BM_opt_text_tokenize);
+
+static void BM_std_find_first_of_tokenize(benchmark::State &state) {
+    bench::perf_region perf{ state };
+    const std::string line = token_line();
+    for (auto _ : perf) {
+        const std::string_view rest = line;
+        size_t chars = 0;
+        for (size_t start = rest.find_first_not_of(" \t"); start != std::string_view::npos;
+             start = rest.find_first_not_of(" \t", start)) {
+            size_t end = rest.find_first_of(" \t", start);
+            if (end == std::string_view::npos) {
+                end = rest.size();
+            }
+            chars += end - start;
+            start = end;
+        }
+        benchmark::DoNotOptimize(chars);
+    }
+    state.SetBytesProcessed(static_cast<int64_t>(state.iterations() * line.size()));
+}
+BENCHMARK(BM_std_find_first_of_tokenize);
+
+int main(int argc, char **argv) {
+    benchmark::Initialize(&argc, argv);
+    if (benchmark::ReportUnrecognizedArguments(argc, argv)) {
+        return 1;
+    }
+    benchmark::AddCustomContext("perf_counters", bench::perf_counters::describe());
+    benchmark::AddCustomContext("option_debug_perf", OPT_OPTION_DEBUG_PERF ? "on" : "off");
+    benchmark::AddCustomContext("option_simd", OPT_OPTION_SIMD_X86 ? "x86" : "off");
+    benchmark::RunSpecifiedBenchmarks();
+    benchmark::Shutdown();
+    return 0;
+}
 // NOLINTEND
\ No newline at end of file
@@ -0,0 +1,74 @@
+-- Helpers shared by the compile-time benchmark tasks.
+
+import("core.base.option")
+import("lib.detect.find_tool")
+
+function split_list(value)
+    local result = {}
+    for item in tostring(value):gmatch("[^,%s]+") do
+        table.insert(result, item)
+    end
+    return result
+end
+
+function find_compiler()
+    local cxx = option.get("cxx")
+    if cxx then
+        return cxx
+    end
+    for _, name in ipairs({"clang++", "g++"}) do
+        local tool = find_tool(name)
+        if tool then
+            return tool.program
+        end
+    end
+    raise("no C++ compiler found, pass one with --cxx=<compiler>")
+end
+
+function compiler_family(cxx)
+    local version = os.iorunv(cxx, {"--version"})
+    if version:find("clang", 1, true) then
+        return "clang"
+    end
+    return "gcc"
+end
+
+-- The compiler (`--cxx`), its family, GNU time and the base flags (`-std`, the
+-- include directory and `--flags`). Outputs go to `--outputdir`, by default
+-- build/<name>.
+function context(name)
+    local ctx = {}
+    ctx.cxx       = find_compiler()
+    ctx.family    = compiler_family(ctx.cxx)
+    ctx.outputdir = path.absolute(option.get("outputdir") or path.join(os.projectdir(), "build", name))
+    ctx.time_tool = os.isfile("/usr/bin/time") and "/usr/bin/time" or nil
+
+    local includedir = path.join(os.projectdir(), "include")
+    if ctx.family == "clang" then
+        ctx.flags = {"-std=c++2c", "-stdlib=libc++", "-I" .. includedir}
+    else
+        ctx.flags = {"-std=c++26", "-I" .. includedir}
+    end
+    table.join2(ctx.flags, os.argv(option.get("flags") or ""))
+    return ctx
+end
+
+-- Runs a compiler command, returning the wall time in milliseconds and the
+-- peak resident set size in MiB (nil without GNU time).
+function measure(ctx, argv, logfile)
+    local memfile = logfile .. ".rss"
+    local start   = os.mclock()
+    if ctx.time_tool then
+        os.execv(ctx.time_tool, table.join({"-f", "%M", "-o", memfile, ctx.cxx}, argv), {stderr = logfile})
+    else
+        os.execv(ctx.cxx, argv, {stderr = logfile})
+    end
+    local elapsed = os.mclock() - start
+
+    local rss
+    if ctx.time_tool and os.isfile(memfile) then
+        local kib = tonumber(io.readfile(memfile):match("(%d+)%s*$"))
+        rss = kib and kib / 1024
+    end
+    return elapsed, rss
+end
@@ -0,0 +1,148 @@
+-- Driver for `xmake constexpr_bench`, see xmake.lua next to this file.
+
+import("core.base.option")
+import("common")
+
+-- Each operation runs ITERATIONS times inside one constant evaluation. `baseline`
+-- is the bare loop, which is subtracted from the others.
+local operations = {
+    {name = "baseline", body = "acc += i;"},
+    {name = "map",      body = [[
+            acc += opt::some(i)
+                       .map([](int x) { return x + 1; })
+                       .map([](int x) { return x * 2; })
+                       .map([](int x) { return x - 3; })
+                       .unwrap_or(0);]]},
+    {name = "and_then", body = [[
+            acc += opt::some(i)
+                       .and_then([](int x) { return x % 3 != 0 ? opt::some(x) : opt::option<int>{}; })
+                       .and_then([](int x) { return x % 5 != 0 ? opt::some(x + 1) : opt::option<int>{}; })
+                       .unwrap_or(0);]]},
+    {name = "compare",  body = [[
+            acc += (opt::some(i) == opt::some(i + 1)) + (opt::some(i) < opt::some(2)) + (opt::some(i) == i)
+                 + (opt::option<int>{} == opt::none);]]},
+    {name = "zip",      body = [[
+            acc += opt::some(i).zip(opt::some(i * 2)).map([](auto p) { return p.first + p.second; }).unwrap_or(0);]]},
+    {name = "take",     body = [[
+            opt::option<int> o{ i };
+            acc += o.take().unwrap_or(0) + o.replace(i).is_none() + *o;]]},
+    {name = "insert",   body = [[
+            opt::option<int> o;
+            acc += o.get_or_insert_with([i] { return i; });
+            o.emplace(i + 1);
+            acc += o.unwrap();]]}
+}
+
+local source_template = [[
+// Generated by `xmake constexpr_bench`.
+#include "option.hpp"
+
+constexpr auto run() -> long long {
+    long long acc = 0;
+    for (int i = 0; i < ITERATIONS; ++i) {
+BODY
+    }
+    return acc;
+}
+
+static_assert(run() != -1);
+]]
+
+local function _generate(op, iterations)
+    local body = op.body:find("\n") and op.body or ("            " .. op.body)
+    return (source_template:gsub("ITERATIONS", tostring(iterations)):gsub("BODY", function () return body end))
+end
+
+-- The flag that bounds constant evaluation: clang counts evaluation steps, GCC
+-- counts operations (and limits loop iterations separately).
+local function _limit_flags(ctx, limit)
+    if ctx.family == "clang" then
+        return {"-fconstexpr-steps=" .. limit}
+    end
+    return {"-fconstexpr-ops-limit=" .. limit, "-fconstexpr-loop-limit=2147483647"}
+end
+
+local function _compiles(ctx, source, limit)
+    local argv = table.join(ctx.flags, _limit_flags(ctx, limit), {"-fsyntax-only", source})
+    return try { function () os.runv(ctx.cxx, argv); return true end } or false
+end
+
+-- The smallest limit that still evaluates `run()`, found by doubling and then
+-- bisecting to within 1%.
+local function _steps(ctx, source)
+    local lo, hi = 0, 1024
+    while not _compiles(ctx, source, hi) do
+        lo = hi
+        hi = hi * 2
+        if hi > 1099511627776 then
+            raise("%s does not compile at any limit, see `%s`", path.filename(source), source)
+        end
+    end
+    while hi - lo > math.max(1, math.floor(hi / 100)) do
+        local mid = math.floor((lo + hi) / 2)
+        if _compiles(ctx, source, mid) then
+            hi = mid
+        else
+            lo = mid
+        end
+    end
+    return hi
+end
+
+function main()
+    local ctx        = common.context("constexpr_bench")
+    local iterations = math.max(1, tonumber(option.get("iterations")) or 1)
+    local repeat_    = math.max(1, tonumber(option.get("repeat")) or 1)
+    local selected   = option.get("operations") and common.split_list(option.get("operations"))
+
+    os.mkdir(ctx.outputdir)
+    cprint("${bright}constexpr_bench${clear}: %s (%s), flags: %s", ctx.cxx, ctx.family, table.concat(ctx.flags, " "))
+
+    local rows = {}
+    local baseline
+    for _, op in ipairs(operations) do
+        if op.name == "baseline" or not selected or table.contains(selected, op.name) then
+            local source = path.join(ctx.outputdir, op.name .. ".cpp")
+            io.writefile(source, _generate(op, iterations))
+
+            local row  = {name = op.name, steps = _steps(ctx, source)}
+            local argv = table.join(ctx.flags, _limit_flags(ctx, 2147483647), {"-fsyntax-only", source})
+            for _ = 1, repeat_ do
+                local ms = common.measure(ctx, argv, path.join(ctx.outputdir, op.name .. ".log"))
+                row.ms   = row.ms and math.min(row.ms, ms) or ms
+            end
+
+            baseline = baseline or row
+            if row ~= baseline then
+                row.steps_per_iter = (row.steps - baseline.steps) / iterations
+                row.us_per_iter    = (row.ms - baseline.ms) * 1000 / iterations
+            end
+            table.insert(rows, row)
+            print("  %-10s %12d steps  %8.1f ms", row.name, row.steps, row.ms)
+        end
+    end
+
+    local unit   = ctx.family == "clang" and "steps" or "ops"
+    local report = {}
+    table.insert(report, "# option constant-evaluation benchmark")
+    table.insert(report, "")
+    table.insert(report, format("Compiler: `%s` (%s), flags: `%s`, %d iterations per operation, best of %d.",
+                                ctx.cxx, ctx.family, table.concat(ctx.flags, " "), iterations, repeat_))
+    table.insert(report, format("`%s` is the smallest `%s` that still evaluates the loop (within 1%%).", unit,
+                                _limit_flags(ctx, "N")[1]))
+    table.insert(report, "")
+    table.insert(report, format("| operation | %s | %s per iteration | wall ms | µs per iteration |", unit, unit))
+    table.insert(report, "|---|---:|---:|---:|---:|")
+    for _, row in ipairs(rows) do
+        table.insert(report, format("| %s | %d | %s | %.1f | %s |", row.name, row.steps,
+                                    row.steps_per_iter and format("%.1f", row.steps_per_iter) or "-", row.ms,
+                                    row.us_per_iter and format("%.2f", row.us_per_iter) or "-"))
+    end
+
+    local text       = table.concat(report, "\n") .. "\n"
+    local reportfile = path.join(ctx.outputdir, "report.md")
+    io.writefile(reportfile, text)
+    print("")
+    print(text)
+    cprint("${bright}report written to %s", reportfile)
+end
@@ -0,0 +1,324 @@
+-- Driver for `xmake compile_bench`, see xmake.lua next to this file.
+
+import("core.base.option")
+import("core.base.json")
+import("common")
+
+-- One synthetic payload type per index. `exercise<I>` touches the members a
+-- typical call site uses, so every explicit instantiation pulls in the same
+-- slice of the overload set for a new `T`.
+local exercise_source = [[
+template <int I>
+struct payload {
+    int value;
+
+    friend constexpr bool operator==(payload, payload) = default;
+};
+
+template <int I>
+int exercise(int x) {
+    OPTION<payload<I>> a{ payload<I>{ x } };
+    OPTION<payload<I>> b;
+    auto doubled = a.map([](payload<I> p) { return p.value * 2; });
+    auto chained = a.and_then([](payload<I> p) { return p.value > 0 ? OPTION<payload<I>>{ p } : OPTION<payload<I>>{}; });
+    auto kept    = chained.filter([](const payload<I> &p) { return p.value % 2 == 0; });
+    b            = kept.take();
+    return doubled.unwrap_or(0) + (a == b) + b.is_some() + kept.is_none() + b.unwrap_or(payload<I>{ 1 }).value;
+}
+]]
+
+-- How each variant spells the include/import and the option type.
+local variants = {
+    header      = {prologue = "#include \"option.hpp\"",      option = "opt::option"},
+    module      = {prologue = "import option;",               option = "opt::option", module = true},
+    core        = {prologue = "#include \"option_core.hpp\"", option = "opt::core::option"},
+    core_module = {prologue = "import option;",               option = "opt::core::option", module = true}
+}
+
+local function _generate(variant, count)
+    local spec  = variants[variant]
+    local body  = exercise_source:gsub("OPTION", spec.option)
+    local lines = {"// Generated by `xmake compile_bench`.", spec.prologue, "", body}
+    for i = 0, count - 1 do
+        table.insert(lines, format("template int exercise<%d>(int);", i))
+    end
+    return table.concat(lines, "\n") .. "\n"
+end
+
+-- The module units in dependency order: partitions first (following their
+-- `import :name;` lines), then the primary interface `src/option.cppm`.
+local function _module_units()
+    local srcdir  = path.join(os.projectdir(), "src")
+    local primary = path.join(srcdir, "option.cppm")
+    local units   = {}
+    local visited = {}
+
+    local function visit(name)
+        if visited[name] then
+            return
+        end
+        visited[name] = true
+        local file = path.join(srcdir, "option", name .. ".cppm")
+        for dep in io.readfile(file):gmatch("import%s+:([%w_]+)%s*;") do
+            visit(dep)
+        end
+        table.insert(units, {file = file, bmi = "option-" .. name})
+    end
+
+    for name in io.readfile(primary):gmatch("import%s+:([%w_]+)%s*;") do
+        visit(name)
+    end
+    table.insert(units, {file = primary, bmi = "option"})
+    return units
+end
+
+-- Builds `import std;` and the option module once; the importing TUs reuse it.
+local function _build_module(ctx)
+    local bmidir = path.join(ctx.outputdir, "bmi")
+    os.mkdir(bmidir)
+
+    local start = os.mclock()
+    local oldir = os.cd(bmidir)
+    if ctx.family == "clang" then
+        local manifest = os.iorunv(ctx.cxx, {"-stdlib=libc++", "-print-library-module-manifest-path"}):trim()
+        if manifest == "" or not os.isfile(manifest) then
+            raise("%s does not ship the libc++ std module (see -print-library-module-manifest-path)", ctx.cxx)
+        end
+        local stdsrc
+        for _, entry in ipairs(json.loadfile(manifest).modules or {}) do
+            if entry["logical-name"] == "std" then
+                stdsrc = entry["source-path"]
+                if not path.is_absolute(stdsrc) then
+                    stdsrc = path.join(path.directory(manifest), stdsrc)
+                end
+            end
+        end
+        os.vrunv(ctx.cxx, table.join(ctx.flags, {"-Wno-reserved-module-identifier", "--precompile", "-x",
+                                                 "c++-module", stdsrc, "-o", "std.pcm"}))
+        for _, unit in ipairs(_module_units()) do
+            os.vrunv(ctx.cxx, table.join(ctx.flags, {"-fprebuilt-module-path=.", "--precompile", "-x", "c++-module",
+                                                     unit.file, "-o", unit.bmi .. ".pcm"}))
+        end
+    else
+        -- GCC writes the compiled interfaces to ./gcm.cache, next to the BMIs.
+        os.vrunv(ctx.cxx, table.join(ctx.flags, {"-fmodules", "-fsearch-include-path", "bits/std.cc", "-c", "-o",
+                                                 "std.o"}))
+        for _, unit in ipairs(_module_units()) do
+            os.vrunv(ctx.cxx, table.join(ctx.flags, {"-fmodules", "-x", "c++", unit.file, "-c", "-o",
+                                                     unit.bmi .. ".o"}))
+        end
+    end
+    os.cd(oldir)
+
+    ctx.bmidir = bmidir
+    return os.mclock() - start
+end
+
+local function _compile_args(ctx, variant, source, object)
+    local argv = table.join(ctx.flags, {"-c", source, "-o", object})
+    if variants[variant].module then
+        if ctx.family == "clang" then
+            table.insert(argv, "-fprebuilt-module-path=" .. ctx.bmidir)
+        else
+            table.insert(argv, "-fmodules")
+        end
+    end
+    if ctx.family == "clang" then
+        table.join2(argv, {"-ftime-trace", "-ftime-trace-granularity=100"})
+    else
+        table.insert(argv, "-ftime-report")
+    end
+    return argv
+end
+
+-- Operator names that contain angle brackets, longest first.
+local angle_operators = {"<=>", "<<=", ">>=", "<<", ">>", "<=", ">=", "->", "<", ">"}
+
+-- `opt::option<payload<3>>::unwrap_or<int>` -> `opt::option::unwrap_or`, so that
+-- instantiations of one overload set (or one trait) are counted together.
+local function _strip_template_args(name)
+    local result = {}
+    local depth  = 0
+    local i      = 1
+    while i <= #name do
+        local token
+        if depth == 0 and name:sub(i, i + 7) == "operator" then
+            token = "operator"
+            for _, op in ipairs(angle_operators) do
+                if name:sub(i + 8, i + 7 + #op) == op then
+                    token = token .. op
+                    break
+                end
+            end
+        end
+        if token then
+            table.insert(result, token)
+            i = i + #token
+        else
+            local c = name:sub(i, i)
+            if c == "<" then
+                depth = depth + 1
+            elseif c == ">" and depth > 0 then
+                depth = depth - 1
+            elseif depth == 0 then
+                table.insert(result, c)
+            end
+            i = i + 1
+        end
+    end
+    return table.concat(result)
+end
+
+-- Clang: instantiation counts from the `Total ...` events of the trace, and the
+-- inclusive time of every event that names an entity (instantiations, parsed
+-- classes, included headers, ...).
+local function _read_time_trace(file, hotspots)
+    local counts = {}
+    for _, event in ipairs(json.loadfile(file).traceEvents or {}) do
+        local name = event.name or ""
+        if name:startswith("Total ") then
+            if event.args and event.args.count then
+                counts[name:sub(7)] = event.args.count
+            end
+        elseif hotspots and event.dur and event.args and event.args.detail then
+            local key   = name .. "\t" .. _strip_template_args(event.args.detail)
+            local entry = hotspots[key] or {count = 0, ms = 0}
+            entry.count   = entry.count + 1
+            entry.ms      = entry.ms + event.dur / 1000
+            hotspots[key] = entry
+        end
+    end
+    return counts
+end
+
+-- GCC: wall time of each `-ftime-report` phase ("template instantiation",
+-- "constraint satisfaction", "overload resolution", ...).
+local function _read_time_report(file, hotspots)
+    for line in io.readfile(file):gmatch("[^\n]+") do
+        local phase, wall = line:match("^%s*(.-)%s*:%s*[%d%.]+%s*%(%s*%d+%%%)%s*[%d%.]+%s*%(%s*%d+%%%)%s*([%d%.]+)")
+        if phase and phase ~= "TOTAL" then
+            local key   = "phase\t" .. phase
+            local entry = hotspots[key] or {count = 0, ms = 0}
+            entry.count   = entry.count + 1
+            entry.ms      = entry.ms + tonumber(wall) * 1000
+            hotspots[key] = entry
+        end
+    end
+end
+
+local function _sorted_hotspots(hotspots, top)
+    local list = {}
+    for key, entry in pairs(hotspots) do
+        local kind, entity = key:match("^(.-)\t(.*)$")
+        table.insert(list, {kind = kind, entity = entity, count = entry.count, ms = entry.ms})
+    end
+    table.sort(list, function (a, b) return a.ms > b.ms end)
+    local result = {}
+    for i = 1, math.min(top, #list) do
+        result[i] = list[i]
+    end
+    return result
+end
+
+local function _fmt(value, spec)
+    return value and format(spec, value) or "-"
+end
+
+function main()
+    local ctx = common.context("compile_bench")
+
+    local counts  = {}
+    for _, n in ipairs(common.split_list(option.get("types"))) do
+        table.insert(counts, tonumber(n))
+    end
+    table.sort(counts)
+    local largest = counts[#counts]
+    local repeat_ = math.max(1, tonumber(option.get("repeat")) or 1)
+    local top     = tonumber(option.get("top")) or 20
+
+    os.mkdir(ctx.outputdir)
+    cprint("${bright}compile_bench${clear}: %s (%s), flags: %s", ctx.cxx, ctx.family, table.concat(ctx.flags, " "))
+
+    local rows        = {}
+    local hotspots    = {}
+    local module_time
+    for _, variant in ipairs(common.split_list(option.get("variants"))) do
+        if not variants[variant] then
+            raise("unknown variant '%s'", variant)
+        end
+        if variants[variant].module and not ctx.bmidir then
+            module_time = _build_module(ctx)
+        end
+        hotspots[variant] = {}
+
+        local baseline
+        for _, n in ipairs(counts) do
+            local stem   = path.join(ctx.outputdir, format("%s_%d", variant, n))
+            local source = stem .. ".cpp"
+            io.writefile(source, _generate(variant, n))
+
+            -- GCC looks up compiled module interfaces in ./gcm.cache.
+            local oldir = variants[variant].module and ctx.family == "gcc" and os.cd(ctx.bmidir)
+            local row   = {variant = variant, types = n}
+            for _ = 1, repeat_ do
+                local ms, rss = common.measure(ctx, _compile_args(ctx, variant, source, stem .. ".o"), stem .. ".log")
+                row.ms  = row.ms and math.min(row.ms, ms) or ms
+                row.rss = rss and math.max(row.rss or 0, rss) or row.rss
+            end
+            if oldir then
+                os.cd(oldir)
+            end
+
+            local hot = n == largest and hotspots[variant] or nil
+            if ctx.family == "clang" then
+                local total       = _read_time_trace(stem .. ".json", hot)
+                row.classes   = total.InstantiateClass
+                row.functions = total.InstantiateFunction
+            elseif hot then
+                _read_time_report(stem .. ".log", hot)
+            end
+
+            baseline = baseline or row
+            if n > baseline.types then
+                row.per_type = (row.ms - baseline.ms) / (n - baseline.types)
+            end
+            table.insert(rows, row)
+            print("  %-8s %5d types  %8.1f ms", variant, n, row.ms)
+        end
+    end
+
+    local report = {}
+    table.insert(report, "# option compile-time benchmark")
+    table.insert(report, "")
+    table.insert(report, format("Compiler: `%s` (%s), flags: `%s`, best of %d.", ctx.cxx, ctx.family,
+                                table.concat(ctx.flags, " "), repeat_))
+    if module_time then
+        table.insert(report, format("Building `std` and `option` module interfaces once: %.1f ms.", module_time))
+    end
+    table.insert(report, "")
+    table.insert(report, "| variant | types | wall ms | ms per extra type | peak MiB | class inst. | function inst. |")
+    table.insert(report, "|---|---:|---:|---:|---:|---:|---:|")
+    for _, row in ipairs(rows) do
+        table.insert(report, format("| %s | %d | %.1f | %s | %s | %s | %s |", row.variant, row.types, row.ms,
+                                    _fmt(row.per_type, "%.2f"), _fmt(row.rss, "%.1f"), _fmt(row.classes, "%d"),
+                                    _fmt(row.functions, "%d")))
+    end
+
+    for _, variant in ipairs(common.split_list(option.get("variants"))) do
+        table.insert(report, "")
+        table.insert(report, format("## Hotspots: %s, %d types (inclusive)", variant, largest))
+        table.insert(report, "")
+        table.insert(report, "| event | entity | count | ms |")
+        table.insert(report, "|---|---|---:|---:|")
+        for _, entry in ipairs(_sorted_hotspots(hotspots[variant], top)) do
+            table.insert(report, format("| %s | `%s` | %d | %.1f |", entry.kind, entry.entity, entry.count, entry.ms))
+        end
+    end
+
+    local text       = table.concat(report, "\n") .. "\n"
+    local reportfile = path.join(ctx.outputdir, "report.md")
+    io.writefile(reportfile, text)
+    print("")
+    print(text)
+    cprint("${bright}report written to %s", reportfile)
+end
@@ -0,0 +1,45 @@
+-- Compile-time benchmark: `xmake compile_bench`.
+--
+-- Generates synthetic translation units that instantiate N distinct `option<T>`
+-- types, compiles each one through `#include "option.hpp"` and through
+-- `import option;`, and reports wall time, peak memory, template instantiation
+-- counts and the most expensive instantiations and compiler phases. The `core`
+-- variants do the same with the lightweight `opt::core::option` from
+-- `option_core.hpp`.
+
+task("compile_bench")
+    set_category("plugin")
+    on_run("main")
+    set_menu {
+        usage = "xmake compile_bench [options]",
+        description = "Measure the compile cost of option<T> via #include and import.",
+        options = {
+            {'c', "cxx",       "kv", nil,             "The C++ compiler to use (default: clang++, then g++ from PATH)."},
+            {'n', "types",     "kv", "0,16,64,256",   "Comma-separated numbers of distinct option<T> types per TU."},
+            {nil, "variants",  "kv", "header,module", "Comma-separated variants to compile (header, module, core, core_module)."},
+            {'r', "repeat",    "kv", "3",             "Compile every TU this many times and keep the fastest run."},
+            {nil, "flags",     "kv", "-O2",           "Extra compiler flags, e.g. \"-O0 -g\"."},
+            {'t', "top",       "kv", "20",            "Number of hotspots to list per variant."},
+            {'o', "outputdir", "kv", nil,             "Where to put generated sources and the report (default: build/compile_bench)."}
+        }
+    }
+
+-- `xmake constexpr_bench`: evaluates common option pipelines (`map` chains,
+-- `and_then`, comparisons, `zip`, `take`/`replace`, insertion) in a loop inside one
+-- `static_assert`, and reports the smallest constexpr step limit that still
+-- compiles it along with the compile time.
+task("constexpr_bench")
+    set_category("plugin")
+    on_run("constexpr")
+    set_menu {
+        usage = "xmake constexpr_bench [options]",
+        description = "Measure the constant-evaluation cost of option operations.",
+        options = {
+            {'c', "cxx",        "kv", nil,     "The C++ compiler to use (default: clang++, then g++ from PATH)."},
+            {nil, "iterations", "kv", "1000",  "Loop iterations per operation inside the constant evaluation."},
+            {nil, "operations", "kv", nil,     "Comma-separated operations (map, and_then, compare, zip, take, insert)."},
+            {'r', "repeat",     "kv", "3",     "Compile every TU this many times and keep the fastest run."},
+            {nil, "flags",      "kv", "",      "Extra compiler flags."},
+            {'o', "outputdir",  "kv", nil,     "Where to put generated sources and the report (default: build/constexpr_bench)."}
+        }
+    }
@@ -0,0 +1,286 @@
+// NOLINTBEGIN
+//
+// Hardware performance counters for the benchmarks.
+//
+// On Linux the counters are read through `perf_event_open(2)` (no daemon, no
+// libpfm): cycles, instructions, branches, branch misses and L1D read misses are
+// opened as one event group, so they are scheduled on the PMU together and can be
+// compared with each other. Every benchmark that opens a `perf_region` gets them
+// reported next to Google Benchmark's timings, normalized per iteration, plus IPC.
+//
+// When the counters cannot be opened (non-Linux, `perf_event_paranoid` too
+// strict, containers and VMs without a virtual PMU, ...) the affected counters are
+// simply left out and the benchmarks run as before. Set `OPT_BENCH_PERF=0` in the
+// environment to skip them explicitly.
+#pragma once
+
+#include <benchmark/benchmark.h>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+
+#if defined(__linux__)
+    #include <linux/perf_event.h>
+    #include <sys/ioctl.h>
+    #include <sys/syscall.h>
+    #include <unistd.h>
+#endif
+
+namespace bench {
+    enum class perf_event : std::size_t {
+        cycles,
+        instructions,
+        branches,
+        branch_misses,
+        l1d_misses,
+    };
+
+    inline constexpr std::size_t perf_event_count = 5;
+
+    inline constexpr std::array<const char *, perf_event_count> perf_event_names{
+        "cycles", "instructions", "branches", "branch-misses", "L1D-misses",
+    };
+
+    class perf_counters {
+    public:
+        perf_counters() noexcept {
+#if defined(__linux__)
+            if (disabled_by_env()) {
+                return;
+            }
+            for (std::size_t i = 0; i < perf_event_count; ++i) {
+                fds[i] = open_event(static_cast<perf_event>(i), leader_fd());
+            }
+#endif
+        }
+
+        perf_counters(const perf_counters &)            = delete;
+        perf_counters &operator=(const perf_counters &) = delete;
+
+        ~perf_counters() {
+#if defined(__linux__)
+            for (auto fd : fds) {
+                if (fd >= 0) {
+                    ::close(fd);
+                }
+            }
+#endif
+        }
+
+        bool available() const noexcept {
+            return leader_fd() >= 0;
+        }
+
+        bool available(perf_event e) const noexcept {
+            return fds[static_cast<std::size_t>(e)] >= 0;
+        }
+
+        void start() noexcept {
+#if defined(__linux__)
+            if (available()) {
+                ::ioctl(leader_fd(), PERF_EVENT_IOC_RESET, PERF_IOC_FLAG_GROUP);
+                ::ioctl(leader_fd(), PERF_EVENT_IOC_ENABLE, PERF_IOC_FLAG_GROUP);
+            }
+#endif
+        }
+
+        void stop() noexcept {
+#if defined(__linux__)
+            if (available()) {
+                ::ioctl(leader_fd(), PERF_EVENT_IOC_DISABLE, PERF_IOC_FLAG_GROUP);
+            }
+#endif
+        }
+
+        // Returns the counts accumulated between `start()` and `stop()`, scaled up
+        // when the kernel had to multiplex the group. Counters that are unavailable,
+        // or that never got scheduled, read as -1.
+        std::array<double, perf_event_count> read() const noexcept {
+            std::array<double, perf_event_count> result{};
+            result.fill(-1.0);
+#if defined(__linux__)
+            for (std::size_t i = 0; i < perf_event_count; ++i) {
+                if (fds[i] < 0) {
+                    continue;
+                }
+                // PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING
+                std::uint64_t buf[3]{};
+                if (::read(fds[i], buf, sizeof(buf)) != static_cast<ssize_t>(sizeof(buf)) || buf[2] == 0) {
+                    continue;
+                }
+                result[i] = static_cast<double>(buf[0]) * (static_cast<double>(buf[1]) / static_cast<double>(buf[2]));
+            }
+#endif
+            return result;
+        }
+
+        // Adds the counters to `state`, averaged over the iterations of the run.
+        void report(benchmark::State &state) const {
+            const auto values = read();
+            for (std::size_t i = 0; i < perf_event_count; ++i) {
+                if (values[i] >= 0) {
+                    state.counters[perf_event_names[i]] =
+                        benchmark::Counter(values[i], benchmark::Counter::kAvgIterations);
+                }
+            }
+
+            const auto cycles       = values[static_cast<std::size_t>(perf_event::cycles)];
+            const auto instructions = values[static_cast<std::size_t>(perf_event::instructions)];
+            if (cycles > 0 && instructions >= 0) {
+                state.counters["IPC"] = instructions / cycles;
+            }
+        }
+
+        // A one-line description of which counters could be opened, for the
+        // benchmark context header.
+        static std::string describe() {
+            const perf_counters probe;
+            if (!probe.available()) {
+#if defined(__linux__)
+                return disabled_by_env() ? "disabled (OPT_BENCH_PERF=0)"
+                                         : "unavailable (perf_event_open failed, see perf_event_paranoid)";
+#else
+                return "unavailable (not Linux)";
+#endif
+            }
+
+            std::string result;
+            for (std::size_t i = 0; i < perf_event_count; ++i) {
+                if (probe.available(static_cast<perf_event>(i))) {
+                    if (!result.empty()) {
+                        result += ',';
+                    }
+                    result += perf_event_names[i];
+                }
+            }
+            return result;
+        }
+
+    private:
+        std::array<int, perf_event_count> fds{ -1, -1, -1, -1, -1 };
+
+        int leader_fd() const noexcept {
+            for (auto fd : fds) {
+                if (fd >= 0) {
+                    return fd;
+                }
+            }
+            return -1;
+        }
+
+#if defined(__linux__)
+        static bool disabled_by_env() noexcept {
+            const char *env = std::getenv("OPT_BENCH_PERF");
+            return env != nullptr && std::strcmp(env, "0") == 0;
+        }
+
+        static int open_event(perf_event e, int group_fd) noexcept {
+            perf_event_attr attr{};
+            attr.size           = sizeof(attr);
+            attr.disabled       = group_fd < 0 ? 1 : 0;
+            attr.exclude_kernel = 1;
+            attr.exclude_hv     = 1;
+            attr.read_format    = PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+
+            switch (e) {
+            case perf_event::cycles:
+                attr.type   = PERF_TYPE_HARDWARE;
+                attr.config = PERF_COUNT_HW_CPU_CYCLES;
+                break;
+            case perf_event::instructions:
+                attr.type   = PERF_TYPE_HARDWARE;
+                attr.config = PERF_COUNT_HW_INSTRUCTIONS;
+                break;
+            case perf_event::branches:
+                attr.type   = PERF_TYPE_HARDWARE;
+                attr.config = PERF_COUNT_HW_BRANCH_INSTRUCTIONS;
+                break;
+            case perf_event::branch_misses:
+                attr.type   = PERF_TYPE_HARDWARE;
+                attr.config = PERF_COUNT_HW_BRANCH_MISSES;
+                break;
+            case perf_event::l1d_misses:
+                attr.type   = PERF_TYPE_HW_CACHE;
+                attr.config = PERF_COUNT_HW_CACHE_L1D
+                            | (PERF_COUNT_HW_CACHE_OP_READ << 8)
+                            | (PERF_COUNT_HW_CACHE_RESULT_MISS << 16);
+                break;
+            }
+
+            const long fd = ::syscall(SYS_perf_event_open, &attr, 0, -1, group_fd, 0);
+            return fd < 0 ? -1 : static_cast<int>(fd);
+        }
+#endif
+    };
+
+    // Counts the timed loop of a benchmark and reports into `state` when it goes
+    // out of scope. Loop over it instead of over `state`, so that the counters
+    // start and stop with the timer and leave out the setup around the loop:
+    //
+    //     static void BM_foo(benchmark::State &state) {
+    //         bench::perf_region perf{ state };
+    //         auto input = make_input();
+    //         for (auto _ : perf) { ... }
+    //     }
+    class perf_region {
+    public:
+        // `state`'s iterator; reaching the end stops the counters.
+        class iterator {
+        public:
+            iterator(benchmark::State::StateIterator it, perf_counters *counters) noexcept
+                : it{ it }, counters{ counters } {}
+
+            auto operator*() const {
+                return *it;
+            }
+
+            iterator &operator++() {
+                ++it;
+                return *this;
+            }
+
+            bool operator!=(const iterator &end) {
+                if (it != end.it) {
+                    return true;
+                }
+                if (counters != nullptr) {
+                    counters->stop();
+                }
+                return false;
+            }
+
+        private:
+            benchmark::State::StateIterator it;
+            perf_counters *counters;
+        };
+
+        explicit perf_region(benchmark::State &state) noexcept : state{ state } {}
+
+        perf_region(const perf_region &)            = delete;
+        perf_region &operator=(const perf_region &) = delete;
+
+        ~perf_region() {
+            counters.stop();
+            counters.report(state);
+        }
+
+        iterator begin() {
+            const auto it = state.begin();
+            counters.start();
+            return { it, &counters };
+        }
+
+        iterator end() {
+            return { state.end(), nullptr };
+        }
+
+    private:
+        benchmark::State &state;
+        perf_counters counters;
+    };
+} // namespace bench
+
+// NOLINTEND
@@ -0,0 +1,487 @@
+#ifndef OPT_OPTION_COLUMN_STATS_HPP
+#define OPT_OPTION_COLUMN_STATS_HPP
+
+// Single-pass profiles of nullable columns.
+//
+// `opt::stats::profile` reads a column of `option<T>` once, and counts its
+// rows and `none`s, finds its least and greatest values, estimates how many
+// distinct values it has, and, for arithmetic `T`, fills a histogram:
+//
+//     opt::stats::profile_options options;
+//     options.histogram = { .lo = 1.0, .hi = 1e6, .bins = 24, .scale = opt::stats::histogram_scale::log };
+//     options.threads = 8;
+//     auto p = opt::stats::profile(latencies, options);
+//     p.nones();                  // rows that are `none`
+//     p.min();                    // option<double>, `none` if every row is
+//     p.distinct();               // estimated distinct values, `none` aside
+//     p.histogram().counts();     // per bin, with `below()` and `above()` apart
+//
+// The distinct count is a HyperLogLog sketch of `2^precision` one-byte
+// registers, of standard error about `1.04 / sqrt(2^precision)` (1.6% at the
+// default 12), fed with `std::hash<T>` passed through a 64-bit finalizer.
+// Histograms are equi-width (`linear`) or equi-ratio (`log`, for `lo > 0`)
+// between fixed bounds, so that two of them always line up.
+//
+// NaNs are present values: they count in `somes()`, feed the sketch and land
+// in the histogram's `below()`, but `min()` and `max()` skip them, whether the
+// rows come one at a time or in blocks, so bounds do not depend on block
+// boundaries or on the number of threads.
+//
+// Every part merges: `column_profile::merge` folds in a profile of other rows
+// taken with the same options, exactly for counts, bounds and histograms, and
+// as the register-wise maximum for the sketch. `profile` uses that to split
+// contiguous columns across `threads`. Rows can also be added one at a time.
+//
+// Contiguous columns of arithmetic `T`, and `opt::masked_column<T>`, are read
+// in blocks: the present values of a block are first packed together without
+// branches, and the bounds and histogram bins are then computed over the
+// packed values in loops the compiler vectorizes.
+
+#include <algorithm>
+#include <bit>
+#include <cmath>
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <limits>
+#include <ranges>
+#include <span>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+#include "option.hpp"
+#include "option_group_by.hpp"
+#include "option_masked_column.hpp"
+
+namespace opt::stats {
+    enum class histogram_scale : std::uint8_t {
+        linear,
+        log,
+    };
+
+    struct histogram_spec {
+        double lo = 0.0;
+        double hi = 0.0;
+        // 0 for no histogram.
+        std::size_t bins = 0;
+        histogram_scale scale = histogram_scale::linear;
+
+        friend constexpr auto operator==(const histogram_spec &, const histogram_spec &) noexcept -> bool = default;
+    };
+
+    struct profile_options {
+        histogram_spec histogram{};
+        // log2 of the number of sketch registers, in [4, 18].
+        unsigned precision = 12;
+        // Threads for large contiguous columns; 0 means `std::thread::hardware_concurrency()`.
+        std::size_t threads = 1;
+    };
+
+    // Bins between `lo` and `hi`, the last one closed, plus the values below
+    // `lo` (and NaNs) and above `hi`.
+    class histogram {
+    public:
+        histogram() = default;
+
+        explicit histogram(const histogram_spec &spec) : shape{ spec }, tally(spec.bins == 0 ? 0 : spec.bins + 2) {
+            if (spec.bins == 0) {
+                return;
+            }
+            if (!(spec.lo < spec.hi) || (spec.scale == histogram_scale::log && !(spec.lo > 0.0))) {
+                throw option_panic("opt::stats::histogram: bounds must satisfy lo < hi, and 0 < lo on a log scale");
+            }
+            origin = spec.scale == histogram_scale::log ? std::log(spec.lo) : spec.lo;
+            const double end = spec.scale == histogram_scale::log ? std::log(spec.hi) : spec.hi;
+            per_unit = static_cast<double>(spec.bins) / (end - origin);
+        }
+
+        auto spec() const noexcept -> const histogram_spec & {
+            return shape;
+        }
+
+        auto counts() const noexcept -> std::span<const std::uint64_t> {
+            return tally.empty() ? std::span<const std::uint64_t>{} : std::span{ tally }.subspan(1, shape.bins);
+        }
+
+        auto below() const noexcept -> std::uint64_t {
+            return tally.empty() ? 0 : tally.front();
+        }
+
+        auto above() const noexcept -> std::uint64_t {
+            return tally.empty() ? 0 : tally.back();
+        }
+
+        // The lower bound of bin `i`; `edge(bins)` is `hi`.
+        auto edge(std::size_t i) const noexcept -> double {
+            const double at = origin + static_cast<double>(i) / per_unit;
+            return shape.scale == histogram_scale::log ? std::exp(at) : at;
+        }
+
+        // Index into the tally: 0 below, `bins + 1` above.
+        auto slot_of(double x) const noexcept -> std::size_t {
+            const double t = shape.scale == histogram_scale::log ? std::log(x) : x;
+            const double at = (t - origin) * per_unit;
+            const double bin = std::min(std::floor(at), static_cast<double>(shape.bins) - 1.0);
+            const bool inside = (x >= shape.lo) & (x <= shape.hi);
+            const std::size_t above_slot = shape.bins + 1;
+            return inside ? static_cast<std::size_t>(bin) + 1 : (x > shape.hi ? above_slot : 0);
+        }
+
+        void add(double x) noexcept {
+            if (!tally.empty()) {
+                ++tally[slot_of(x)];
+            }
+        }
+
+        void add_slot(std::size_t slot) noexcept {
+            ++tally[slot];
+        }
+
+        auto enabled() const noexcept -> bool {
+            return !tally.empty();
+        }
+
+        void merge(const histogram &other) {
+            if (shape != other.shape) {
+                throw option_panic("opt::stats::histogram: merged histograms differ in bounds or bins");
+            }
+            for (std::size_t i = 0; i < tally.size(); ++i) {
+                tally[i] += other.tally[i];
+            }
+        }
+
+    private:
+        histogram_spec shape{};
+        double origin = 0.0;
+        double per_unit = 0.0;
+        std::vector<std::uint64_t> tally;
+    };
+
+    // A HyperLogLog sketch of the distinct 64-bit hashes it was fed.
+    class distinct_sketch {
+    public:
+        explicit distinct_sketch(unsigned precision = 12) : bits{ precision } {
+            if (precision < 4 || precision > 18) {
+                throw option_panic("opt::stats::distinct_sketch: precision must be in [4, 18]");
+            }
+            registers.resize(std::size_t{ 1 } << precision);
+        }
+
+        auto precision() const noexcept -> unsigned {
+            return bits;
+        }
+
+        // The top `precision` bits pick a register, which keeps the longest run
+        // of leading zeros (plus one) seen in the rest.
+        void add_hash(std::uint64_t h) noexcept {
+            const std::size_t r = static_cast<std::size_t>(h >> (64 - bits));
+            const std::uint64_t rest = (h << bits) | (std::uint64_t{ 1 } << (bits - 1));
+            const auto rank = static_cast<std::uint8_t>(std::countl_zero(rest) + 1);
+            registers[r] = std::max(registers[r], rank);
+        }
+
+        void merge(const distinct_sketch &other) {
+            if (bits != other.bits) {
+                throw option_panic("opt::stats::distinct_sketch: merged sketches differ in precision");
+            }
+            for (std::size_t r = 0; r < registers.size(); ++r) {
+                registers[r] = std::max(registers[r], other.registers[r]);
+            }
+        }
+
+        auto estimate() const noexcept -> double {
+            const auto m = static_cast<double>(registers.size());
+            double inverse_sum = 0.0;
+            std::size_t zeros = 0;
+            for (const std::uint8_t rank : registers) {
+                inverse_sum += std::ldexp(1.0, -static_cast<int>(rank));
+                zeros += rank == 0;
+            }
+            const double alpha = bits == 4 ? 0.673 : bits == 5 ? 0.697 : bits == 6 ? 0.709 : 0.7213 / (1.0 + 1.079 / m);
+            const double raw = alpha * m * m / inverse_sum;
+            // Linear counting is more accurate while many registers are empty.
+            if (raw <= 2.5 * m && zeros != 0) {
+                return m * std::log(m / static_cast<double>(zeros));
+            }
+            return raw;
+        }
+
+    private:
+        unsigned bits;
+        std::vector<std::uint8_t> registers;
+    };
+
+    namespace detail {
+        template <typename T>
+        concept histogrammable = std::is_arithmetic_v<T> && !std::same_as<T, bool>;
+
+        template <typename R>
+        concept profile_column = std::ranges::input_range<R> && opt::detail::option_type<std::ranges::range_value_t<R>>;
+
+        template <typename R>
+        concept contiguous_profile_column = profile_column<R> && std::ranges::contiguous_range<R>
+                                         && std::ranges::sized_range<R>;
+
+        // Below this many rows per thread, starting a thread costs more than it saves.
+        inline constexpr std::size_t profile_parallel_rows = std::size_t{ 1 } << 16;
+
+        inline constexpr std::size_t profile_block_rows = 256;
+
+        // NaNs have no place in `min` and `max`.
+        template <typename T>
+        constexpr auto orderable(const T &value) noexcept -> bool {
+            if constexpr (std::floating_point<T>) {
+                return value == value;
+            } else {
+                return true;
+            }
+        }
+
+        // `std::hash` of floating-point values may hash their bytes; their bits
+        // (with `-0.0` as `0.0`, which compares equal) go through the same
+        // finalizer as integers instead.
+        template <typename T>
+        auto sketch_hash(const T &value) noexcept -> std::uint64_t {
+            if constexpr (std::same_as<T, float>) {
+                return opt::detail::group_hash(std::bit_cast<std::uint32_t>(value + 0.0f));
+            } else if constexpr (std::same_as<T, double>) {
+                return opt::detail::group_hash(std::bit_cast<std::uint64_t>(value + 0.0));
+            } else {
+                return opt::detail::group_hash(value);
+            }
+        }
+    } // namespace detail
+
+    template <typename T>
+    class column_profile {
+    public:
+        explicit column_profile(const profile_options &options = {}) :
+            sketch{ options.precision }, bins{ options.histogram } {
+            if constexpr (!detail::histogrammable<T>) {
+                if (options.histogram.bins != 0) {
+                    throw option_panic("opt::stats::profile: histograms need arithmetic values");
+                }
+            }
+        }
+
+        void add(const option<T> &row) {
+            ++total;
+            if (row.is_none()) {
+                ++none_rows;
+                return;
+            }
+            if constexpr (std::totally_ordered<T>) {
+                if (detail::orderable(*row)) {
+                    widen(*row, *row);
+                }
+            }
+            sketch.add_hash(detail::sketch_hash(*row));
+            if constexpr (detail::histogrammable<T>) {
+                bins.add(static_cast<double>(*row));
+            }
+        }
+
+        // Folds in the profile of other rows, taken with the same options.
+        void merge(const column_profile &other) {
+            total += other.total;
+            none_rows += other.none_rows;
+            if constexpr (std::totally_ordered<T>) {
+                if (other.least.is_some()) {
+                    widen(*other.least, *other.greatest);
+                }
+            }
+            sketch.merge(other.sketch);
+            bins.merge(other.bins);
+        }
+
+        auto rows() const noexcept -> std::size_t {
+            return total;
+        }
+
+        auto nones() const noexcept -> std::size_t {
+            return none_rows;
+        }
+
+        auto somes() const noexcept -> std::size_t {
+            return total - none_rows;
+        }
+
+        auto min() const noexcept -> const option<T> & {
+            return least;
+        }
+
+        auto max() const noexcept -> const option<T> & {
+            return greatest;
+        }
+
+        // The estimated number of distinct present values.
+        auto distinct() const noexcept -> double {
+            return sketch.estimate();
+        }
+
+        auto distinct_values() const noexcept -> const distinct_sketch & {
+            return sketch;
+        }
+
+        auto histogram() const noexcept -> const stats::histogram & {
+            return bins;
+        }
+
+        // `count` rows of which `values` are the present ones, packed. Arithmetic
+        // payloads only: bounds and bins are computed a block at a time.
+        void add_block(std::size_t count, std::span<const T> values)
+            requires detail::histogrammable<T>
+        {
+            total += count;
+            none_rows += count - values.size();
+            if (values.empty()) {
+                return;
+            }
+            // Comparisons with a NaN are false, so starting floating-point bounds
+            // at the infinities leaves NaNs out without a test.
+            T lo = values[0];
+            T hi = values[0];
+            if constexpr (std::floating_point<T>) {
+                lo = std::numeric_limits<T>::infinity();
+                hi = -std::numeric_limits<T>::infinity();
+            }
+            for (const T v : values) {
+                lo = v < lo ? v : lo;
+                hi = hi < v ? v : hi;
+            }
+            if (!(hi < lo)) {
+                widen(lo, hi);
+            }
+            for (const T v : values) {
+                sketch.add_hash(detail::sketch_hash(v));
+            }
+            if (bins.enabled()) {
+                std::size_t slots[detail::profile_block_rows];
+                for (std::size_t i = 0; i < values.size(); ++i) {
+                    slots[i] = bins.slot_of(static_cast<double>(values[i]));
+                }
+                for (std::size_t i = 0; i < values.size(); ++i) {
+                    bins.add_slot(slots[i]);
+                }
+            }
+        }
+
+    private:
+        std::size_t total = 0;
+        std::size_t none_rows = 0;
+        option<T> least;
+        option<T> greatest;
+        distinct_sketch sketch;
+        stats::histogram bins;
+
+        void widen(const T &lo, const T &hi) {
+            if (least.is_none() || lo < *least) {
+                least = lo;
+            }
+            if (greatest.is_none() || *greatest < hi) {
+                greatest = hi;
+            }
+        }
+    };
+
+    namespace detail {
+        // Packs the present values of each block of rows, with a select per row.
+        template <typename T>
+        void profile_options_blocks(column_profile<T> &profile, std::span<const option<T>> rows) {
+            T packed[profile_block_rows];
+            for (std::size_t base = 0; base < rows.size(); base += profile_block_rows) {
+                const std::size_t count = std::min(profile_block_rows, rows.size() - base);
+                std::size_t k = 0;
+                for (std::size_t i = base; i < base + count; ++i) {
+                    packed[k] = rows[i].unwrap_or(T{});
+                    k += rows[i].is_some();
+                }
+                profile.add_block(count, std::span<const T>{ packed, k });
+            }
+        }
+
+        template <typename T>
+        void profile_rows(column_profile<T> &profile, std::span<const option<T>> rows) {
+            if constexpr (histogrammable<T>) {
+                profile_options_blocks(profile, rows);
+            } else {
+                for (const option<T> &row : rows) {
+                    profile.add(row);
+                }
+            }
+        }
+
+        // Chunks of `[0, n)` profiled by `profile_chunk(profile, begin, end)` on
+        // `threads` threads, then merged in order. Each unit holds
+        // `rows_per_unit` rows, which decides how many threads are worth it.
+        template <typename T, typename F>
+        auto profile_parallel(std::size_t n, std::size_t rows_per_unit, const profile_options &options,
+                              F profile_chunk) -> column_profile<T> {
+            std::size_t threads = options.threads != 0 ? options.threads : std::thread::hardware_concurrency();
+            threads = std::clamp<std::size_t>(threads, 1, n * rows_per_unit / profile_parallel_rows + 1);
+            std::vector<column_profile<T>> parts(threads, column_profile<T>{ options });
+            if (threads == 1) {
+                profile_chunk(parts[0], 0, n);
+            } else {
+                std::vector<std::jthread> workers;
+                for (std::size_t t = 0; t < threads; ++t) {
+                    workers.emplace_back([&, t] { profile_chunk(parts[t], n * t / threads, n * (t + 1) / threads); });
+                }
+            }
+            for (std::size_t t = 1; t < threads; ++t) {
+                parts[0].merge(parts[t]);
+            }
+            return std::move(parts[0]);
+        }
+    } // namespace detail
+
+    template <detail::profile_column R>
+    auto profile(const R &rows, const profile_options &options = {})
+        -> column_profile<typename std::ranges::range_value_t<R>::value_type> {
+        using T = typename std::ranges::range_value_t<R>::value_type;
+        if constexpr (detail::contiguous_profile_column<R>) {
+            const std::span<const option<T>> column{ rows };
+            return detail::profile_parallel<T>(column.size(), 1, options,
+                                               [&](column_profile<T> &part, std::size_t begin, std::size_t end) {
+                                                   detail::profile_rows(part, column.subspan(begin, end - begin));
+                                               });
+        } else {
+            column_profile<T> result{ options };
+            for (const option<T> &row : rows) {
+                result.add(row);
+            }
+            return result;
+        }
+    }
+
+    template <typename T>
+    auto profile(const masked_column<T> &column, const profile_options &options = {}) -> column_profile<T> {
+        constexpr std::size_t word_bits = masked_column<T>::word_bits;
+        const std::span<const T> values = column.values();
+        const std::span<const std::uint64_t> words = column.validity();
+        // Whole words per chunk, so that no two threads share one.
+        return detail::profile_parallel<T>(
+            words.size(), word_bits, options, [&](column_profile<T> &part, std::size_t first, std::size_t last) {
+                [[maybe_unused]] T packed[word_bits];
+                for (std::size_t w = first; w < last; ++w) {
+                    const std::size_t base = w * word_bits;
+                    const std::size_t count = std::min(word_bits, values.size() - base);
+                    if constexpr (detail::histogrammable<T>) {
+                        std::size_t k = 0;
+                        for (std::uint64_t bits = words[w]; bits != 0; bits &= bits - 1) {
+                            packed[k++] = values[base + static_cast<std::size_t>(std::countr_zero(bits))];
+                        }
+                        part.add_block(count, std::span<const T>{ packed, k });
+                    } else {
+                        for (std::size_t i = base; i < base + count; ++i) {
+                            part.add(column.is_some(i) ? option<T>{ values[i] } : option<T>{});
+                        }
+                    }
+                }
+            });
+    }
+} // namespace opt::stats
+
+#endif
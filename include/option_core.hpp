@@ -0,0 +1,450 @@
+#ifndef OPT_OPTION_CORE_HPP
+#define OPT_OPTION_CORE_HPP
+
+// A lightweight `option<T>` for trivially copyable payloads.
+//
+// `opt::core::option<T>` has the layout of `opt::option<T>` and the semantics of
+// the members it shares with it, but it only depends on `<compare>`, `<exception>`
+// and `<type_traits>`, and its members are plain member functions with few
+// constraints, so that instantiating it for yet another id, enum or double is
+// cheap. Callables are invoked directly (pointers to members are not supported),
+// and `option<T &>`, iterators and the `std::optional`/`std::expected`/tuple
+// interop are left to `option.hpp`. Neither header includes the other; when
+// both are included, the two option types convert implicitly into each other.
+
+#include <cassert>
+#include <compare>
+#include <exception>
+#include <type_traits>
+
+#include "option_panic.hpp"
+
+namespace opt {
+    struct none_t;
+
+    namespace core {
+        template <typename T>
+        class option;
+
+        // The empty state for code that only includes this header; `opt::none` works as well.
+        struct none_t {
+            constexpr explicit none_t() = default;
+        };
+
+        inline constexpr none_t none{};
+
+        namespace detail {
+#pragma push_macro("cpp20_no_unique_address")
+#undef cpp20_no_unique_address
+#if __has_cpp_attribute(msvc::no_unique_address)
+    #define cpp20_no_unique_address [[msvc::no_unique_address]]
+#else
+    #define cpp20_no_unique_address [[no_unique_address]]
+#endif
+
+            template <typename T>
+            inline constexpr bool is_option_v = false;
+
+            template <typename T>
+            inline constexpr bool is_option_v<option<T>> = true;
+
+            // The payloads `core::option` accepts; `opt::option<T>` converts to it for these.
+            template <typename T>
+            concept payload = std::is_trivially_copyable_v<T> && !std::is_array_v<T>
+                           && std::is_same_v<std::remove_cv_t<T>, T>;
+
+            template <typename N>
+            concept none_tag = std::is_same_v<N, none_t> || std::is_same_v<N, opt::none_t>;
+
+            // The layout of `opt::detail::option_storage<T>`.
+            template <typename T, bool = std::is_empty_v<T> && std::is_trivial_v<T>>
+            struct storage {
+                union {
+                    T value;
+                };
+                bool has_value = false;
+
+                constexpr storage() noexcept {}
+
+                constexpr explicit storage(const T &val) noexcept : value{ val }, has_value{ true } {}
+            };
+
+            template <typename T>
+            struct storage<T, true> {
+                cpp20_no_unique_address T value;
+                bool has_value = false;
+
+                constexpr storage() noexcept = default;
+
+                constexpr explicit storage(const T &val) noexcept : value{ val }, has_value{ true } {}
+            };
+
+#pragma pop_macro("cpp20_no_unique_address")
+        } // namespace detail
+
+        template <typename T>
+        class option {
+            static_assert(std::is_trivially_copyable_v<T> && !std::is_array_v<T>,
+                          "opt::core::option<T> requires a trivially copyable T, use opt::option<T> instead");
+            static_assert(std::is_same_v<std::remove_cv_t<T>, T>, "opt::core::option<T> requires a cv-unqualified T");
+
+        private:
+            detail::storage<T> storage;
+
+        public:
+            using value_type = T;
+
+            constexpr option() noexcept = default;
+
+            template <detail::none_tag N>
+            constexpr option(const N &) noexcept {}
+
+            constexpr option(const T &value) noexcept : storage{ value } {}
+
+            template <detail::none_tag N>
+            constexpr auto operator=(const N &) noexcept -> option & {
+                storage.has_value = false;
+                return *this;
+            }
+
+            // Returns `true` if the option contains a value.
+            constexpr auto is_some() const noexcept -> bool {
+                return storage.has_value;
+            }
+
+            // Returns `true` if the option is empty.
+            constexpr auto is_none() const noexcept -> bool {
+                return !storage.has_value;
+            }
+
+            constexpr auto has_value() const noexcept -> bool {
+                return storage.has_value;
+            }
+
+            constexpr explicit operator bool() const noexcept {
+                return storage.has_value;
+            }
+
+            // Returns `true` if the option contains a value that matches `predicate`.
+            template <typename F>
+            constexpr auto is_some_and(F &&predicate) const -> bool {
+                return is_some() && static_cast<bool>(static_cast<F &&>(predicate)(storage.value));
+            }
+
+            // Returns `true` if the option is empty or its value matches `predicate`.
+            template <typename F>
+            constexpr auto is_none_or(F &&predicate) const -> bool {
+                return is_none() || static_cast<bool>(static_cast<F &&>(predicate)(storage.value));
+            }
+
+            constexpr auto operator*() & noexcept -> T & {
+                assert(is_some());
+                return storage.value;
+            }
+
+            constexpr auto operator*() const & noexcept -> const T & {
+                assert(is_some());
+                return storage.value;
+            }
+
+            constexpr auto operator*() && noexcept -> T {
+                assert(is_some());
+                return storage.value;
+            }
+
+            constexpr auto operator->() noexcept -> T * {
+                assert(is_some());
+                return __builtin_addressof(storage.value);
+            }
+
+            constexpr auto operator->() const noexcept -> const T * {
+                assert(is_some());
+                return __builtin_addressof(storage.value);
+            }
+
+            // Returns the contained value.
+            //
+            // Throws an `option_panic` with `msg` if the option is empty.
+            constexpr auto expect(const char *msg) & -> T & {
+                if (is_none()) [[unlikely]] {
+                    throw option_panic(msg);
+                }
+                return storage.value;
+            }
+
+            constexpr auto expect(const char *msg) const & -> const T & {
+                if (is_none()) [[unlikely]] {
+                    throw option_panic(msg);
+                }
+                return storage.value;
+            }
+
+            constexpr auto expect(const char *msg) && -> T {
+                if (is_none()) [[unlikely]] {
+                    throw option_panic(msg);
+                }
+                return storage.value;
+            }
+
+            // Returns the contained value.
+            //
+            // Throws an `option_panic` if the option is empty.
+            constexpr auto unwrap() & -> T & {
+                return expect("Attempted to access value of empty option");
+            }
+
+            constexpr auto unwrap() const & -> const T & {
+                return expect("Attempted to access value of empty option");
+            }
+
+            constexpr auto unwrap() && -> T {
+                return static_cast<option &&>(*this).expect("Attempted to access value of empty option");
+            }
+
+            // Returns the contained value or `default_value`.
+            constexpr auto unwrap_or(const T &default_value) const noexcept -> T {
+                if (is_some()) [[likely]] {
+                    return storage.value;
+                }
+                return default_value;
+            }
+
+            constexpr auto value_or(const T &default_value) const noexcept -> T {
+                return unwrap_or(default_value);
+            }
+
+            // Returns the contained value or a value-initialized `T`.
+            constexpr auto unwrap_or_default() const noexcept -> T {
+                if (is_some()) [[likely]] {
+                    return storage.value;
+                }
+                return T{};
+            }
+
+            // Returns the contained value or computes one from `f`.
+            template <typename F>
+            constexpr auto unwrap_or_else(F &&f) const -> T {
+                if (is_some()) [[likely]] {
+                    return storage.value;
+                }
+                return static_cast<F &&>(f)();
+            }
+
+            // Returns the contained value without checking that there is one.
+            constexpr auto unwrap_unchecked() & noexcept -> T & {
+                return storage.value;
+            }
+
+            constexpr auto unwrap_unchecked() const & noexcept -> const T & {
+                return storage.value;
+            }
+
+            // Maps the contained value with `f`. The result must be trivially copyable
+            // as well.
+            template <typename F>
+            constexpr auto map(F &&f) const -> option<std::remove_cvref_t<std::invoke_result_t<F, const T &>>> {
+                using U = std::remove_cvref_t<std::invoke_result_t<F, const T &>>;
+                if (is_some()) [[likely]] {
+                    return option<U>{ static_cast<F &&>(f)(storage.value) };
+                }
+                return option<U>{};
+            }
+
+            // Returns `default_value` if the option is empty, otherwise `f` applied to
+            // the contained value.
+            template <typename U, typename F>
+            constexpr auto map_or(U default_value, F &&f) const -> U {
+                if (is_some()) {
+                    return static_cast<F &&>(f)(storage.value);
+                }
+                return default_value;
+            }
+
+            // Returns `d()` if the option is empty, otherwise `f` applied to the
+            // contained value.
+            template <typename D, typename F>
+            constexpr auto map_or_else(D &&d, F &&f) const -> std::invoke_result_t<F, const T &> {
+                if (is_some()) {
+                    return static_cast<F &&>(f)(storage.value);
+                }
+                return static_cast<D &&>(d)();
+            }
+
+            // Returns an empty option if the option is empty, otherwise calls `f` with
+            // the contained value and returns its result, another `core::option`.
+            template <typename F>
+            constexpr auto and_then(F &&f) const -> std::remove_cvref_t<std::invoke_result_t<F, const T &>> {
+                using U = std::remove_cvref_t<std::invoke_result_t<F, const T &>>;
+                static_assert(detail::is_option_v<U>, "the function passed to and_then must return a core::option");
+                if (is_some()) [[likely]] {
+                    return static_cast<F &&>(f)(storage.value);
+                }
+                return U{};
+            }
+
+            // Returns the option if it contains a value matching `predicate`, otherwise
+            // an empty option.
+            template <typename P>
+            constexpr auto filter(P &&predicate) const -> option {
+                if (is_some() && static_cast<bool>(static_cast<P &&>(predicate)(storage.value))) {
+                    return *this;
+                }
+                return option{};
+            }
+
+            // Returns the option if it contains a value, otherwise the result of `f`.
+            template <typename F>
+            constexpr auto or_else(F &&f) const -> option {
+                if (is_some()) [[likely]] {
+                    return *this;
+                }
+                return static_cast<F &&>(f)();
+            }
+
+            // Calls `f` with the contained value, if any, and returns the option.
+            template <typename F>
+            constexpr auto inspect(F &&f) const -> option {
+                if (is_some()) {
+                    static_cast<F &&>(f)(storage.value);
+                }
+                return *this;
+            }
+
+            // Returns `optb` if the option contains a value, otherwise an empty option.
+            constexpr auto and_(const option &optb) const noexcept -> option {
+                return is_some() ? optb : option{};
+            }
+
+            // Returns the option if it contains a value, otherwise `optb`.
+            constexpr auto or_(const option &optb) const noexcept -> option {
+                return is_some() ? *this : optb;
+            }
+
+            // Returns whichever of the option and `optb` contains a value if exactly
+            // one of them does, otherwise an empty option.
+            constexpr auto xor_(const option &optb) const noexcept -> option {
+                if (is_some() != optb.is_some()) {
+                    return is_some() ? *this : optb;
+                }
+                return option{};
+            }
+
+            // Takes the value out of the option, leaving it empty.
+            constexpr auto take() noexcept -> option {
+                const option result = *this;
+                storage.has_value   = false;
+                return result;
+            }
+
+            // Takes the value out of the option if it matches `predicate`.
+            template <typename P>
+            constexpr auto take_if(P &&predicate) -> option {
+                if (is_some() && static_cast<bool>(static_cast<P &&>(predicate)(storage.value))) {
+                    return take();
+                }
+                return option{};
+            }
+
+            // Stores `value` and returns the previous contents.
+            constexpr auto replace(const T &value) noexcept -> option {
+                const option result = *this;
+                storage             = detail::storage<T>{ value };
+                return result;
+            }
+
+            // Stores `value`, dropping any previous value, and returns a reference to it.
+            constexpr auto insert(const T &value) noexcept -> T & {
+                storage = detail::storage<T>{ value };
+                return storage.value;
+            }
+
+            // Stores a `T` constructed from `args`, dropping any previous value.
+            template <typename... Args>
+            constexpr auto emplace(Args &&...args) -> T & {
+                storage = detail::storage<T>{ T(static_cast<Args &&>(args)...) };
+                return storage.value;
+            }
+
+            // Stores `value` if the option is empty, then returns a reference to the
+            // contained value.
+            constexpr auto get_or_insert(const T &value) noexcept -> T & {
+                if (is_none()) [[unlikely]] {
+                    storage = detail::storage<T>{ value };
+                }
+                return storage.value;
+            }
+
+            // Stores the result of `f` if the option is empty, then returns a
+            // reference to the contained value.
+            template <typename F>
+            constexpr auto get_or_insert_with(F &&f) -> T & {
+                if (is_none()) [[unlikely]] {
+                    storage = detail::storage<T>{ static_cast<F &&>(f)() };
+                }
+                return storage.value;
+            }
+
+            constexpr void reset() noexcept {
+                storage.has_value = false;
+            }
+
+            constexpr void swap(option &other) noexcept {
+                const option tmp = *this;
+                *this            = other;
+                other            = tmp;
+            }
+
+            friend constexpr void swap(option &lhs, option &rhs) noexcept {
+                lhs.swap(rhs);
+            }
+
+            friend constexpr auto operator==(const option &lhs, const option &rhs) -> bool
+                requires requires(const T &v) { static_cast<bool>(v == v); }
+            {
+                if (lhs.is_some() && rhs.is_some()) {
+                    return static_cast<bool>(lhs.storage.value == rhs.storage.value);
+                }
+                return lhs.is_some() == rhs.is_some();
+            }
+
+            friend constexpr auto operator==(const option &lhs, const T &rhs) -> bool
+                requires requires(const T &v) { static_cast<bool>(v == v); }
+            {
+                return lhs.is_some() && static_cast<bool>(lhs.storage.value == rhs);
+            }
+
+            template <detail::none_tag N>
+            friend constexpr auto operator==(const option &lhs, const N &) noexcept -> bool {
+                return lhs.is_none();
+            }
+
+            // An empty option orders before any value.
+            friend constexpr auto operator<=>(const option &lhs, const option &rhs)
+                requires std::three_way_comparable<T>
+            {
+                using R = std::compare_three_way_result_t<T>;
+                if (lhs.is_some() && rhs.is_some()) {
+                    return R(lhs.storage.value <=> rhs.storage.value);
+                }
+                return R(lhs.is_some() <=> rhs.is_some());
+            }
+
+            friend constexpr auto operator<=>(const option &lhs, const T &rhs)
+                requires std::three_way_comparable<T>
+            {
+                using R = std::compare_three_way_result_t<T>;
+                if (lhs.is_some()) {
+                    return R(lhs.storage.value <=> rhs);
+                }
+                return R(std::strong_ordering::less);
+            }
+
+            template <detail::none_tag N>
+            friend constexpr auto operator<=>(const option &lhs, const N &) noexcept -> std::strong_ordering {
+                return lhs.is_some() <=> false;
+            }
+        };
+    } // namespace core
+} // namespace opt
+
+#endif
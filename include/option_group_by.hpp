@@ -0,0 +1,494 @@
+#ifndef OPT_OPTION_GROUP_BY_HPP
+#define OPT_OPTION_GROUP_BY_HPP
+
+// Null-aware group-by over columns of `option<K>` keys and `option<V>` values.
+//
+// `opt::group_by(keys, values, options)` returns one row per distinct key with
+// SQL-style aggregates that skip `none` values:
+//
+//     auto g = opt::group_by(region, revenue);  // columns of option<int>, option<double>
+//     g.keys[i];   // option<int>: the key, `none` for the group of `none` keys
+//     g.rows[i];   // COUNT(*)
+//     g.count[i];  // COUNT(revenue), the present values
+//     g.sum[i];    // option<double>: SUM(revenue), `none` if every value was
+//     g.min[i], g.max[i], g.first[i], g.last[i];
+//
+// Integer sums are `long long` or `unsigned long long`, and wrap around modulo
+// 2^64 when they overflow.
+//
+// Rows whose key is `none` form a group of their own, or are dropped with
+// `null_keys::drop`. Aggregates that are not needed can be switched off in
+// `group_by_options`; their columns stay empty.
+//
+// Keys go into an open-addressing table (linear probing, at most half full)
+// that stores a 32-bit tag of each hash next to the group index, so most
+// mismatches cost no key comparison. Rows are processed in blocks: the hashes
+// of a block are computed in one tight loop, and once the table outgrows the
+// caches the probe for row `i + 16` is prefetched while row `i` is aggregated.
+// With `threads > 1`, rows are first partitioned by hash across the threads,
+// and each partition, holding keys no other one has, is then grouped by one
+// thread without locks. Groups come out in order of first appearance
+// within each partition.
+//
+// `std::hash<K>` must be specialized for `K`.
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <exception>
+#include <functional>
+#include <limits>
+#include <ranges>
+#include <span>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+#include "option.hpp"
+#include "option_ranges.hpp"
+
+#pragma push_macro("cpp20_no_unique_address")
+#undef cpp20_no_unique_address
+#if __has_cpp_attribute(msvc::no_unique_address)
+    #define cpp20_no_unique_address [[msvc::no_unique_address]]
+#else
+    #define cpp20_no_unique_address [[no_unique_address]]
+#endif
+
+namespace opt {
+    enum class null_keys : std::uint8_t {
+        group,
+        drop,
+    };
+
+    struct group_by_options {
+        null_keys nulls = null_keys::group;
+        bool sum = true;
+        bool min = true;
+        bool max = true;
+        bool first = true;
+        bool last = true;
+        // Threads for large inputs; 0 means `std::thread::hardware_concurrency()`.
+        std::size_t threads = 1;
+    };
+
+    namespace detail {
+        // Payloads that `SUM` adds up.
+        template <typename V>
+        concept summable = std::is_arithmetic_v<V> && !std::same_as<V, bool>;
+
+        // The type `SUM` accumulates in: the widest integer of the same signedness,
+        // or `double` for `float`. Other payloads have no sum.
+        template <typename V>
+        using sum_type = std::conditional_t<
+            !summable<V>, V,
+            std::conditional_t<std::floating_point<V>, std::conditional_t<std::same_as<V, float>, double, V>,
+                               std::conditional_t<std::is_signed_v<V>, long long, unsigned long long>>>;
+
+        // The `SUM` accumulator of a group: nothing for payloads without a sum,
+        // which then need not be default-constructible. Signed integers add up in
+        // `unsigned long long`, so that an overflow wraps around instead of being
+        // undefined, and convert back to `long long` at the end.
+        struct no_sum {};
+
+        template <typename V>
+        using sum_slot = std::conditional_t<
+            !summable<V>, no_sum,
+            std::conditional_t<std::signed_integral<V>, unsigned long long, sum_type<V>>>;
+
+        template <typename K>
+        auto group_hash(const K &key) noexcept -> std::uint64_t {
+            std::uint64_t h;
+            if constexpr (std::integral<K> || std::is_enum_v<K>) {
+                h = static_cast<std::uint64_t>(key);
+            } else {
+                h = static_cast<std::uint64_t>(std::hash<K>{}(key));
+            }
+            // MurmurHash3's finalizer: identity hashes of small integers would
+            // otherwise cluster in the low bits the table indexes with.
+            h ^= h >> 33;
+            h *= 0xff51afd7ed558ccdULL;
+            h ^= h >> 33;
+            h *= 0xc4ceb9fe1a85ec53ULL;
+            h ^= h >> 33;
+            return h;
+        }
+
+        // Runs `work(t)` for every `t` below `threads`, each on its own thread, and
+        // once all have finished rethrows the first exception one of them threw.
+        // An exception that left a thread's function would call `std::terminate`.
+        template <typename F>
+        void run_workers(std::size_t threads, F work) {
+            std::vector<std::exception_ptr> errors(threads);
+            {
+                std::vector<std::jthread> workers;
+                workers.reserve(threads);
+                for (std::size_t t = 0; t < threads; ++t) {
+                    workers.emplace_back([&work, &errors, t] {
+                        try {
+                            work(t);
+                        } catch (...) {
+                            errors[t] = std::current_exception();
+                        }
+                    });
+                }
+            }
+            for (const std::exception_ptr &error : errors) {
+                if (error) {
+                    std::rethrow_exception(error);
+                }
+            }
+        }
+    } // namespace detail
+
+    template <typename K, typename V>
+    struct group_by_result {
+        std::vector<option<K>> keys;
+        std::vector<std::size_t> rows;
+        std::vector<std::size_t> count;
+        std::vector<option<detail::sum_type<V>>> sum;
+        std::vector<option<V>> min;
+        std::vector<option<V>> max;
+        std::vector<option<V>> first;
+        std::vector<option<V>> last;
+
+        auto size() const noexcept -> std::size_t {
+            return keys.size();
+        }
+    };
+
+    namespace detail {
+        // Tables up to this many slots stay in the caches and are not prefetched.
+        inline constexpr std::size_t group_cached_slots = 1 << 15;
+
+        // Builds the groups of one partition.
+        template <typename K, typename V>
+        class group_table {
+        public:
+            group_table(const group_by_options &options, std::size_t expected) : options(options) {
+                const std::size_t capacity = std::bit_ceil(std::max<std::size_t>(16, 2 * expected));
+                slots.assign(capacity, slot{});
+                mask = capacity - 1;
+            }
+
+            // Whether the slots have outgrown the caches, so that probes are worth
+            // prefetching.
+            auto is_large() const noexcept -> bool {
+                return slots.size() > group_cached_slots;
+            }
+
+            auto slot_address(std::uint64_t hash) const noexcept -> std::uintptr_t {
+                return reinterpret_cast<std::uintptr_t>(slots.data() + (hash & mask));
+            }
+
+            // The group in the home slot of `hash`, which is usually the one the
+            // key belongs to once the slot has been loaded.
+            auto group_address(std::uint64_t hash) const noexcept -> std::uintptr_t {
+                const std::uint32_t g = slots[hash & mask].group;
+                return g != no_group ? reinterpret_cast<std::uintptr_t>(groups.data() + g) : 0;
+            }
+
+            // Adds one row whose key is `key` (`nullptr` for `none`) with hash `hash`.
+            void add(const K *key, std::uint64_t hash, const option<V> &value) {
+                std::size_t group;
+                if (key == nullptr) {
+                    if (null_group == no_group) {
+                        null_group = new_group(option<K>{});
+                    }
+                    group = null_group;
+                } else {
+                    group = find_or_insert(*key, hash);
+                }
+                accumulate(group, value);
+            }
+
+            // Moves the groups out as columns.
+            auto take() && -> group_by_result<K, V> {
+                group_by_result<K, V> result;
+                const std::size_t n = groups.size();
+                result.keys.reserve(n);
+                result.rows.reserve(n);
+                result.count.reserve(n);
+                for (std::size_t i = 0; i < n; ++i) {
+                    group &g = groups[i];
+                    result.keys.push_back(std::move(g.key));
+                    result.rows.push_back(g.rows);
+                    result.count.push_back(g.count);
+                    if constexpr (summable<V>) {
+                        if (options.sum) {
+                            using S = sum_type<V>;
+                            result.sum.push_back(g.count != 0 ? option<S>{ static_cast<S>(g.sum) } : option<S>{});
+                        }
+                    }
+                    if (!keeps_values) {
+                        continue;
+                    }
+                    extremes &e = values[i];
+                    if constexpr (std::totally_ordered<V>) {
+                        if (options.min) {
+                            result.min.push_back(std::move(e.min));
+                        }
+                        if (options.max) {
+                            result.max.push_back(std::move(e.max));
+                        }
+                    }
+                    if (options.first) {
+                        result.first.push_back(std::move(e.first));
+                    }
+                    if (options.last) {
+                        result.last.push_back(std::move(e.last));
+                    }
+                }
+                return result;
+            }
+
+        private:
+            struct slot {
+                std::uint32_t group = no_group;
+                std::uint32_t tag = 0;
+            };
+
+            // The running aggregates of a group, kept together so that a row
+            // touches one slot and one group. The value copies live apart and
+            // are only kept when asked for, so that `COUNT` and `SUM` stay small.
+            struct group {
+                option<K> key;
+                std::size_t rows = 0;
+                std::size_t count = 0;
+                cpp20_no_unique_address sum_slot<V> sum{};
+            };
+
+            struct extremes {
+                option<V> min;
+                option<V> max;
+                option<V> first;
+                option<V> last;
+            };
+
+            static constexpr std::uint32_t no_group = std::numeric_limits<std::uint32_t>::max();
+
+            const group_by_options &options;
+            std::vector<slot> slots;
+            std::size_t mask;
+            std::uint32_t null_group = no_group;
+            std::vector<group> groups;
+            std::vector<extremes> values;
+            const bool keeps_values = options.min || options.max || options.first || options.last;
+
+            auto find_or_insert(const K &key, std::uint64_t hash) -> std::size_t {
+                const auto tag = static_cast<std::uint32_t>(hash >> 32);
+                for (std::size_t i = hash & mask;; i = (i + 1) & mask) {
+                    slot &s = slots[i];
+                    if (s.group == no_group) {
+                        s = slot{ new_group(option<K>{ key }), tag };
+                        if (2 * groups.size() > slots.size()) {
+                            grow();
+                        }
+                        return groups.size() - 1;
+                    }
+                    if (s.tag == tag && *groups[s.group].key == key) {
+                        return s.group;
+                    }
+                }
+            }
+
+            void grow() {
+                std::vector<slot> old(2 * slots.size(), slot{});
+                old.swap(slots);
+                mask = slots.size() - 1;
+                for (const slot &s : old) {
+                    if (s.group != no_group) {
+                        std::size_t i = group_hash(*groups[s.group].key) & mask;
+                        while (slots[i].group != no_group) {
+                            i = (i + 1) & mask;
+                        }
+                        slots[i] = s;
+                    }
+                }
+            }
+
+            auto new_group(option<K> key) -> std::uint32_t {
+                groups.push_back(group{ .key = std::move(key) });
+                if (keeps_values) {
+                    values.emplace_back();
+                }
+                return static_cast<std::uint32_t>(groups.size() - 1);
+            }
+
+            void accumulate(std::size_t index, const option<V> &value) {
+                group &g = groups[index];
+                ++g.rows;
+                if (value.is_none()) {
+                    return;
+                }
+                const V &v = *value;
+                ++g.count;
+                if constexpr (summable<V>) {
+                    g.sum += static_cast<sum_slot<V>>(v);
+                }
+                if (!keeps_values) {
+                    return;
+                }
+                extremes &e = values[index];
+                if constexpr (std::totally_ordered<V>) {
+                    if (options.min && e.min.is_none_or([&](const V &m) { return v < m; })) {
+                        e.min.insert(v);
+                    }
+                    if (options.max && e.max.is_none_or([&](const V &m) { return m < v; })) {
+                        e.max.insert(v);
+                    }
+                }
+                if (options.first && e.first.is_none()) {
+                    e.first.insert(v);
+                }
+                if (options.last) {
+                    e.last.insert(v);
+                }
+            }
+        };
+
+        inline constexpr std::size_t group_block = 256;
+        // Rows ahead whose slot, and then whose group, are prefetched.
+        inline constexpr std::size_t group_prefetch_slot = 16;
+        inline constexpr std::size_t group_prefetch_group = 8;
+
+        // Groups the rows `rows(i)` for `i` in `[0, n)` into `table`, in order.
+        template <typename K, typename V, typename Rows>
+        void group_rows(group_table<K, V> &table, std::span<const option<K>> keys, std::span<const option<V>> values,
+                        std::size_t n, Rows rows, null_keys nulls) {
+            std::array<std::uint64_t, group_block> hashes;
+            for (std::size_t start = 0; start < n; start += group_block) {
+                const std::size_t count = std::min(group_block, n - start);
+                for (std::size_t j = 0; j < count; ++j) {
+                    const auto &key = keys[rows(start + j)];
+                    hashes[j] = key.is_some() ? group_hash(*key) : 0;
+                }
+                const bool prefetching = table.is_large();
+                for (std::size_t j = 0; j < count; ++j) {
+                    if (prefetching && j + group_prefetch_slot < count) {
+                        prefetch(table.slot_address(hashes[j + group_prefetch_slot]));
+                    }
+                    if (prefetching && j + group_prefetch_group < count) {
+                        if (const std::uintptr_t address = table.group_address(hashes[j + group_prefetch_group])) {
+                            prefetch(address);
+                        }
+                    }
+                    const std::size_t row = rows(start + j);
+                    const auto &key = keys[row];
+                    if (key.is_none() && nulls == null_keys::drop) {
+                        continue;
+                    }
+                    table.add(key.is_some() ? &*key : nullptr, hashes[j], values[row]);
+                }
+            }
+        }
+
+        template <typename K, typename V>
+        void append_groups(group_by_result<K, V> &into, group_by_result<K, V> &&from) {
+            const auto append = [](auto &to, auto &source) {
+                to.insert(to.end(), std::make_move_iterator(source.begin()), std::make_move_iterator(source.end()));
+            };
+            append(into.keys, from.keys);
+            append(into.rows, from.rows);
+            append(into.count, from.count);
+            append(into.sum, from.sum);
+            append(into.min, from.min);
+            append(into.max, from.max);
+            append(into.first, from.first);
+            append(into.last, from.last);
+        }
+
+        // Below this many rows per thread, the partitioning pass costs more than it
+        // saves.
+        inline constexpr std::size_t group_parallel_rows = 1 << 14;
+
+        template <typename K, typename V>
+        auto group_by_parallel(std::span<const option<K>> keys, std::span<const option<V>> values,
+                               const group_by_options &options, std::size_t threads) -> group_by_result<K, V> {
+            const std::size_t n = keys.size();
+            const std::size_t partitions = std::bit_ceil(2 * threads);
+            const int shift = 64 - std::countr_zero(partitions);
+            const auto partition_of = [&](const option<K> &key) -> std::size_t {
+                // The table indexes with the low bits of the hash, so partition by
+                // the high ones.
+                return key.is_some() ? static_cast<std::size_t>(group_hash(*key) >> shift) : 0;
+            };
+
+            // Phase 1: each thread splits a contiguous chunk of rows by partition,
+            // keeping row order.
+            std::vector<std::vector<std::vector<std::size_t>>> split(threads,
+                                                                     std::vector<std::vector<std::size_t>>(partitions));
+            run_workers(threads, [&](std::size_t t) {
+                const std::size_t begin = n * t / threads;
+                const std::size_t end = n * (t + 1) / threads;
+                for (auto &rows : split[t]) {
+                    rows.reserve((end - begin) / partitions + 16);
+                }
+                for (std::size_t row = begin; row < end; ++row) {
+                    if (keys[row].is_some() || options.nulls == null_keys::group) {
+                        split[t][partition_of(keys[row])].push_back(row);
+                    }
+                }
+            });
+
+            // Phase 2: each partition is grouped by one thread. Chunks are visited
+            // in order, so `first` and `last` see the rows in table order.
+            std::vector<group_by_result<K, V>> parts(partitions);
+            run_workers(threads, [&](std::size_t t) {
+                for (std::size_t p = t; p < partitions; p += threads) {
+                    std::size_t rows = 0;
+                    for (const auto &chunk : split) {
+                        rows += chunk[p].size();
+                    }
+                    group_table<K, V> table{ options, rows / 4 };
+                    for (const auto &chunk : split) {
+                        const auto &list = chunk[p];
+                        group_rows(table, keys, values, list.size(), [&](std::size_t i) { return list[i]; },
+                                   options.nulls);
+                    }
+                    parts[p] = std::move(table).take();
+                }
+            });
+
+            group_by_result<K, V> result = std::move(parts.front());
+            for (std::size_t p = 1; p < partitions; ++p) {
+                append_groups(result, std::move(parts[p]));
+            }
+            return result;
+        }
+    } // namespace detail
+
+    // Groups `values` by `keys` (both contiguous ranges of `option`s of the same
+    // length) and returns the key and aggregate columns, one row per group.
+    template <typename KR, typename VR>
+        requires std::ranges::contiguous_range<KR> && std::ranges::sized_range<KR>
+              && detail::option_type<std::ranges::range_value_t<KR>> && std::ranges::contiguous_range<VR>
+              && std::ranges::sized_range<VR> && detail::option_type<std::ranges::range_value_t<VR>>
+    auto group_by(const KR &keys, const VR &values, const group_by_options &options = {})
+        -> group_by_result<typename std::ranges::range_value_t<KR>::value_type,
+                           typename std::ranges::range_value_t<VR>::value_type> {
+        using K = typename std::ranges::range_value_t<KR>::value_type;
+        using V = typename std::ranges::range_value_t<VR>::value_type;
+        const std::span<const option<K>> key_column{ keys };
+        const std::span<const option<V>> value_column{ values };
+        if (key_column.size() != value_column.size()) {
+            throw option_panic("opt::group_by: keys and values differ in length");
+        }
+
+        std::size_t threads = options.threads != 0 ? options.threads : std::thread::hardware_concurrency();
+        threads = std::clamp<std::size_t>(threads, 1, key_column.size() / detail::group_parallel_rows + 1);
+        if (threads > 1) {
+            return detail::group_by_parallel(key_column, value_column, options, threads);
+        }
+        detail::group_table<K, V> table{ options, 64 };
+        detail::group_rows(table, key_column, value_column, key_column.size(), std::identity{}, options.nulls);
+        return std::move(table).take();
+    }
+} // namespace opt
+
+#pragma pop_macro("cpp20_no_unique_address")
+
+#endif
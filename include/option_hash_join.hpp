@@ -0,0 +1,376 @@
+#ifndef OPT_OPTION_HASH_JOIN_HPP
+#define OPT_OPTION_HASH_JOIN_HPP
+
+// Hash joins between columns of `option<K>` keys, with SQL's null semantics.
+//
+// `opt::hash_join(left, right, options)` returns the pairs of row indices whose
+// keys are equal. A `none` key equals nothing, not even another `none`:
+//
+//     std::vector<opt::option<int>> orders{ 7, opt::none, 9, 7 };
+//     std::vector<opt::option<int>> users{ 9, 7, opt::none };
+//     auto inner = opt::hash_join(orders, users);                                 // (0, 1) (2, 0) (3, 1)
+//     auto outer = opt::hash_join(orders, users, { .kind = opt::join_kind::left }); // ... (1, none) ...
+//     auto anti = opt::hash_join(orders, users, { .kind = opt::join_kind::anti });  // 1
+//
+// The result lists the left rows in order, each with its matches in right row
+// order. `join_kind::left` keeps the left rows without a match, with a `none`
+// right row; `join_kind::anti` keeps only those, and leaves `right` empty.
+//
+// The build and probe sides are separate: `opt::join_table` indexes the right
+// keys once and can then be probed by several left columns. Its open-addressing
+// table maps each distinct key, through a 32-bit tag of its hash, to the right
+// rows holding it, stored contiguously. Probes hash a block of rows first, then
+// prefetch the slot of row `i + 16` and the key of row `i + 8` while row `i` is
+// matched, once the table outgrows the caches. With `threads > 1`, the build
+// side is partitioned by hash and the partitions are built in parallel, and the
+// probe side is split into chunks whose results are concatenated in order.
+//
+// `std::hash<K>` must be specialized for `K`.
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <ranges>
+#include <span>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+#include "option.hpp"
+#include "option_group_by.hpp"
+#include "option_ranges.hpp"
+
+namespace opt {
+    enum class join_kind : std::uint8_t {
+        inner,
+        left,
+        anti,
+    };
+
+    struct hash_join_options {
+        join_kind kind = join_kind::inner;
+        // Threads for large inputs; 0 means `std::thread::hardware_concurrency()`.
+        std::size_t threads = 1;
+    };
+
+    // Matched rows as two columns: `left[i]` joins `right[i]`.
+    struct join_result {
+        std::vector<std::size_t> left;
+        std::vector<option<std::size_t>> right;
+
+        auto size() const noexcept -> std::size_t {
+            return left.size();
+        }
+    };
+
+    namespace detail {
+        template <typename R>
+        concept join_column = std::ranges::contiguous_range<R> && std::ranges::sized_range<R>
+                           && option_type<std::ranges::range_value_t<R>>;
+
+        template <typename R>
+        using join_key = typename std::ranges::range_value_t<R>::value_type;
+
+        inline constexpr std::size_t join_block = 256;
+        // Rows ahead whose slot, and then whose key, are prefetched.
+        inline constexpr std::size_t join_prefetch_slot = 16;
+        inline constexpr std::size_t join_prefetch_key = 8;
+        // Below this many rows per thread, starting threads costs more than it
+        // saves.
+        inline constexpr std::size_t join_parallel_rows = 1 << 14;
+
+        // Calls `f(row, key, hash)` for the rows `rows(i)`, `i` in `[0, n)`, in
+        // order. The hashes of a block come first, then the addresses that
+        // `slot_of(hash)` and `key_of(hash)` return for the rows ahead, unless
+        // they are 0, are prefetched.
+        template <typename K, typename Rows, typename SlotOf, typename KeyOf, typename F>
+        void for_each_hashed(std::span<const option<K>> keys, std::size_t n, Rows rows, SlotOf slot_of, KeyOf key_of,
+                             F f) {
+            std::array<std::uint64_t, join_block> hashes;
+            for (std::size_t start = 0; start < n; start += join_block) {
+                const std::size_t count = std::min(join_block, n - start);
+                for (std::size_t j = 0; j < count; ++j) {
+                    const auto &key = keys[rows(start + j)];
+                    hashes[j] = key.is_some() ? group_hash(*key) : 0;
+                }
+                for (std::size_t j = 0; j < count; ++j) {
+                    if (j + join_prefetch_slot < count) {
+                        if (const std::uintptr_t address = slot_of(hashes[j + join_prefetch_slot])) {
+                            prefetch(address);
+                        }
+                    }
+                    if (j + join_prefetch_key < count) {
+                        if (const std::uintptr_t address = key_of(hashes[j + join_prefetch_key])) {
+                            prefetch(address);
+                        }
+                    }
+                    const std::size_t row = rows(start + j);
+                    f(row, keys[row], hashes[j]);
+                }
+            }
+        }
+
+        // The build side of one hash partition: each distinct key and the rows
+        // that hold it, in row order.
+        template <typename K>
+        class join_partition {
+        public:
+            // Indexes the rows `rows(i)`, `i` in `[0, n)`, of `keys`, skipping `none`s.
+            template <typename Rows>
+            void build(std::span<const option<K>> keys, std::size_t n, Rows rows) {
+                const std::size_t capacity = std::bit_ceil(std::max<std::size_t>(16, 2 * n));
+                slots.assign(capacity, slot{});
+                mask = capacity - 1;
+
+                std::vector<std::uint32_t> ids(n, no_key);
+                std::vector<std::size_t> counts;
+                const auto none = [](std::uint64_t) -> std::uintptr_t { return 0; };
+                for_each_hashed(
+                    keys, n, rows, [&](std::uint64_t hash) { return prefetches() ? slot_address(hash) : 0; }, none,
+                    [&, i = std::size_t{ 0 }](std::size_t, const option<K> &key, std::uint64_t hash) mutable {
+                        if (key.is_some()) {
+                            ids[i] = find_or_insert(*key, hash);
+                            if (ids[i] == counts.size()) {
+                                counts.push_back(0);
+                            }
+                            ++counts[ids[i]];
+                        }
+                        ++i;
+                    });
+
+                offsets.assign(counts.size() + 1, 0);
+                for (std::size_t g = 0; g < counts.size(); ++g) {
+                    offsets[g + 1] = offsets[g] + counts[g];
+                }
+                row_of.resize(offsets.back());
+                std::ranges::copy(std::span{ offsets }.first(counts.size()), counts.begin());
+                for (std::size_t i = 0; i < n; ++i) {
+                    if (ids[i] != no_key) {
+                        row_of[counts[ids[i]]++] = rows(i);
+                    }
+                }
+            }
+
+            // Whether the slots have outgrown the caches, so that probes are worth
+            // prefetching.
+            auto prefetches() const noexcept -> bool {
+                return slots.size() > group_cached_slots;
+            }
+
+            auto slot_address(std::uint64_t hash) const noexcept -> std::uintptr_t {
+                return reinterpret_cast<std::uintptr_t>(slots.data() + (hash & mask));
+            }
+
+            // The key in the home slot of `hash`, which is usually the one probed
+            // for once the slot has been loaded.
+            auto key_address(std::uint64_t hash) const noexcept -> std::uintptr_t {
+                const std::uint32_t id = slots[hash & mask].key;
+                return id != no_key ? reinterpret_cast<std::uintptr_t>(distinct.data() + id) : 0;
+            }
+
+            // The rows whose key is `key`, with hash `hash`.
+            auto find(const K &key, std::uint64_t hash) const noexcept -> std::span<const std::size_t> {
+                const auto tag = static_cast<std::uint32_t>(hash >> 32);
+                for (std::size_t i = hash & mask;; i = (i + 1) & mask) {
+                    const slot &s = slots[i];
+                    if (s.key == no_key) {
+                        return {};
+                    }
+                    if (s.tag == tag && distinct[s.key] == key) {
+                        return std::span{ row_of }.subspan(offsets[s.key], offsets[s.key + 1] - offsets[s.key]);
+                    }
+                }
+            }
+
+            auto rows() const noexcept -> std::size_t {
+                return row_of.size();
+            }
+
+        private:
+            static constexpr std::uint32_t no_key = std::numeric_limits<std::uint32_t>::max();
+
+            struct slot {
+                std::uint32_t key = no_key;
+                std::uint32_t tag = 0;
+            };
+
+            std::vector<slot> slots;
+            std::size_t mask = 0;
+            std::vector<K> distinct;
+            // The rows of key `g` are `row_of[offsets[g]]` to `row_of[offsets[g + 1]]`.
+            std::vector<std::size_t> offsets;
+            std::vector<std::size_t> row_of;
+
+            auto find_or_insert(const K &key, std::uint64_t hash) -> std::uint32_t {
+                const auto tag = static_cast<std::uint32_t>(hash >> 32);
+                for (std::size_t i = hash & mask;; i = (i + 1) & mask) {
+                    slot &s = slots[i];
+                    if (s.key == no_key) {
+                        distinct.push_back(key);
+                        s = slot{ static_cast<std::uint32_t>(distinct.size() - 1), tag };
+                        return s.key;
+                    }
+                    if (s.tag == tag && distinct[s.key] == key) {
+                        return s.key;
+                    }
+                }
+            }
+        };
+
+        inline auto join_threads(std::size_t requested, std::size_t rows) -> std::size_t {
+            const std::size_t threads = requested != 0 ? requested : std::thread::hardware_concurrency();
+            return std::clamp<std::size_t>(threads, 1, rows / join_parallel_rows + 1);
+        }
+    } // namespace detail
+
+    // The build side of a hash join: the rows of a column of `option<K>` keys,
+    // indexed by key. `none` keys are left out, since they match nothing.
+    template <typename K>
+        requires std::equality_comparable<K>
+    class join_table {
+    public:
+        template <typename R>
+            requires detail::join_column<R> && std::same_as<detail::join_key<R>, K>
+        explicit join_table(const R &keys, std::size_t threads = 1) {
+            const std::span<const option<K>> column{ keys };
+            threads = detail::join_threads(threads, column.size());
+            if (threads == 1) {
+                partitions.resize(1);
+                partitions.front().build(column, column.size(), std::identity{});
+                return;
+            }
+
+            // Phase 1: each thread splits a contiguous chunk of rows by partition,
+            // keeping row order.
+            partitions.resize(std::bit_ceil(2 * threads));
+            std::vector<std::vector<std::vector<std::size_t>>> split(
+                threads, std::vector<std::vector<std::size_t>>(partitions.size()));
+            detail::run_workers(threads, [&](std::size_t t) {
+                const std::size_t begin = column.size() * t / threads;
+                const std::size_t end = column.size() * (t + 1) / threads;
+                for (std::size_t row = begin; row < end; ++row) {
+                    if (column[row].is_some()) {
+                        split[t][partition_of(detail::group_hash(*column[row]))].push_back(row);
+                    }
+                }
+            });
+
+            // Phase 2: each partition is built by one thread, from the chunks in
+            // order, so that its rows stay sorted.
+            detail::run_workers(threads, [&](std::size_t t) {
+                for (std::size_t p = t; p < partitions.size(); p += threads) {
+                    std::vector<std::size_t> rows;
+                    for (const auto &chunk : split) {
+                        rows.insert(rows.end(), chunk[p].begin(), chunk[p].end());
+                    }
+                    partitions[p].build(column, rows.size(), [&](std::size_t i) { return rows[i]; });
+                }
+            });
+        }
+
+        // The build rows whose key equals `key`, in row order.
+        auto find(const K &key) const noexcept -> std::span<const std::size_t> {
+            const std::uint64_t hash = detail::group_hash(key);
+            return partitions[partition_of(hash)].find(key, hash);
+        }
+
+        // Joins the rows of `keys`, the probe side, to the build rows.
+        template <typename R>
+            requires detail::join_column<R> && std::same_as<detail::join_key<R>, K>
+        auto probe(const R &keys, join_kind kind = join_kind::inner, std::size_t threads = 1) const -> join_result {
+            const std::span<const option<K>> column{ keys };
+            threads = detail::join_threads(threads, column.size());
+            if (threads == 1) {
+                return probe_rows(column, 0, column.size(), kind);
+            }
+            std::vector<join_result> parts(threads);
+            detail::run_workers(threads, [&](std::size_t t) {
+                parts[t] = probe_rows(column, column.size() * t / threads, column.size() * (t + 1) / threads, kind);
+            });
+            join_result result = std::move(parts.front());
+            for (std::size_t t = 1; t < threads; ++t) {
+                result.left.insert(result.left.end(), parts[t].left.begin(), parts[t].left.end());
+                result.right.insert(result.right.end(), parts[t].right.begin(), parts[t].right.end());
+            }
+            return result;
+        }
+
+        // The number of indexed rows, i.e. those with a key.
+        auto size() const noexcept -> std::size_t {
+            std::size_t n = 0;
+            for (const auto &partition : partitions) {
+                n += partition.rows();
+            }
+            return n;
+        }
+
+    private:
+        std::vector<detail::join_partition<K>> partitions;
+
+        // Maps the high bits of the hash, since the partitions index their slots
+        // with the low ones.
+        auto partition_of(std::uint64_t hash) const noexcept -> std::size_t {
+            return static_cast<std::size_t>(((hash >> 32) * partitions.size()) >> 32);
+        }
+
+        auto probe_rows(std::span<const option<K>> keys, std::size_t begin, std::size_t end, join_kind kind) const
+            -> join_result {
+            join_result result;
+            result.left.reserve(end - begin);
+            if (kind != join_kind::anti) {
+                result.right.reserve(end - begin);
+            }
+            const bool prefetching = std::ranges::any_of(partitions, &detail::join_partition<K>::prefetches);
+            const auto slot_of = [&](std::uint64_t hash) -> std::uintptr_t {
+                return prefetching ? partitions[partition_of(hash)].slot_address(hash) : 0;
+            };
+            const auto key_of = [&](std::uint64_t hash) -> std::uintptr_t {
+                return prefetching ? partitions[partition_of(hash)].key_address(hash) : 0;
+            };
+            detail::for_each_hashed(
+                keys, end - begin, [begin](std::size_t i) { return begin + i; }, slot_of, key_of,
+                [&](std::size_t row, const option<K> &key, std::uint64_t hash) {
+                    std::span<const std::size_t> matches;
+                    if (key.is_some()) {
+                        matches = partitions[partition_of(hash)].find(*key, hash);
+                    }
+                    if (matches.empty()) {
+                        if (kind != join_kind::inner) {
+                            result.left.push_back(row);
+                        }
+                        if (kind == join_kind::left) {
+                            result.right.emplace_back();
+                        }
+                        return;
+                    }
+                    if (kind == join_kind::anti) {
+                        return;
+                    }
+                    for (const std::size_t match : matches) {
+                        result.left.push_back(row);
+                        result.right.emplace_back(match);
+                    }
+                });
+            return result;
+        }
+    };
+
+    template <typename R>
+    join_table(const R &, std::size_t = 1) -> join_table<detail::join_key<R>>;
+
+    // Joins `left` to `right` on their keys, building on `right` and probing with
+    // `left`.
+    template <typename LR, typename RR>
+        requires detail::join_column<LR> && detail::join_column<RR>
+              && std::same_as<detail::join_key<LR>, detail::join_key<RR>>
+    auto hash_join(const LR &left, const RR &right, const hash_join_options &options = {}) -> join_result {
+        const join_table<detail::join_key<RR>> table{ right, options.threads };
+        return table.probe(left, options.kind, options.threads);
+    }
+} // namespace opt
+
+#endif
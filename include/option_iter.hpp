@@ -0,0 +1,567 @@
+#ifndef OPT_OPTION_ITER_HPP
+#define OPT_OPTION_ITER_HPP
+
+// Rust's iterator protocol: a source hands out one element at a time from
+// `next()`, as an `option`, and `none` once it is exhausted.
+//
+// `opt::iter::from` turns a range, or any type with such a `next()`, into a
+// source with the adaptors of `Iterator`. They are applied lazily, and the
+// pipeline is run by a terminal operation or a range-for:
+//
+//     std::vector<int> ids{ 4, 8, -1, 15, 16, 23 };
+//     auto sum = opt::iter::from(ids)
+//                    .take_while([](int id) { return id >= 0; })
+//                    .map([](int id) { return id * 2; })
+//                    .fold(0, std::plus{});                          // 24
+//     auto first = opt::iter::from(lines).filter_map(parse_header).next();  // option<header>
+//     for (auto [a, b] : opt::iter::from(xs).zip(opt::iter::from(ys))) { ... }
+//
+// Each adaptor's `next()` calls the one below it and tests its `option` once,
+// so once inlined a pipeline is one loop with one branch per element on
+// whether there is one, where stacked `std::views` test the end in `begin`,
+// `++` and `==` of every layer. `try_fold` stops at the first `none` its
+// callback returns.
+//
+// Sources are ranges too: `begin()` pulls the first element, so any pipeline
+// can be handed to `std::ranges` algorithms and views as an input range.
+// `from` takes a range by reference, which has to outlive the source (or a
+// borrowed range, such as `std::views::iota` or `std::span`). Adaptors take
+// their source by value, like Rust's.
+
+#include <algorithm>
+#include <concepts>
+#include <cstddef>
+#include <functional>
+#include <iterator>
+#include <limits>
+#include <memory>
+#include <ranges>
+#include <type_traits>
+#include <utility>
+
+#include "option.hpp"
+
+#pragma push_macro("cpp20_no_unique_address")
+#undef cpp20_no_unique_address
+#if __has_cpp_attribute(msvc::no_unique_address)
+    #define cpp20_no_unique_address [[msvc::no_unique_address]]
+#else
+    #define cpp20_no_unique_address [[no_unique_address]]
+#endif
+
+namespace opt::iter {
+    // A type whose `next()` returns the next element as an `option`.
+    template <typename S>
+    concept source = std::movable<S> && requires(S &s) {
+        { s.next() } -> opt::detail::option_type;
+    };
+
+    // The `option` a source's `next()` returns, and the element in it: `T &` for
+    // `option<T &>`.
+    template <source S>
+    using next_t = decltype(std::declval<S &>().next());
+
+    namespace detail {
+        template <typename O>
+        struct option_item;
+
+        template <typename T>
+        struct option_item<option<T>> {
+            using type = T;
+        };
+    } // namespace detail
+
+    template <source S>
+    using item_t = typename detail::option_item<next_t<S>>::type;
+
+    // How many elements a source has left: at least `lower`, and at most
+    // `upper` where it is known.
+    struct size_bounds {
+        std::size_t lower = 0;
+        option<std::size_t> upper;
+
+        friend constexpr auto operator==(const size_bounds &, const size_bounds &) -> bool = default;
+    };
+
+    // `s.size_hint()`, for sources that have one, and `{ 0, none }` otherwise.
+    template <source S>
+    constexpr auto size_hint(const S &s) -> size_bounds {
+        if constexpr (requires { { s.size_hint() } -> std::convertible_to<size_bounds>; }) {
+            return s.size_hint();
+        } else {
+            return {};
+        }
+    }
+
+    template <source S, typename F>
+    class map_iter;
+    template <source S, typename P>
+    class filter_iter;
+    template <source S, typename F>
+    class filter_map_iter;
+    template <source S, typename P>
+    class take_while_iter;
+    template <source A, source B>
+    class chain_iter;
+    template <source A, source B>
+    class zip_iter;
+    template <source S>
+    class step_by_iter;
+    template <source S>
+    class pull_iterator;
+
+    // The adaptors and terminal operations, for the sources that derive from it.
+    struct pull {
+        // Each element passed through `f`.
+        template <typename Self, typename F>
+        constexpr auto map(this Self &&self, F f) -> map_iter<std::remove_cvref_t<Self>, F> {
+            return { std::forward<Self>(self), std::move(f) };
+        }
+
+        // The elements for which `pred(const element &)` is `true`.
+        template <typename Self, typename P>
+        constexpr auto filter(this Self &&self, P pred) -> filter_iter<std::remove_cvref_t<Self>, P> {
+            return { std::forward<Self>(self), std::move(pred) };
+        }
+
+        // The values in the `option`s `f` returns, skipping the `none`s.
+        template <typename Self, typename F>
+        constexpr auto filter_map(this Self &&self, F f) -> filter_map_iter<std::remove_cvref_t<Self>, F> {
+            return { std::forward<Self>(self), std::move(f) };
+        }
+
+        // The elements up to the first one for which `pred` is `false`, which is
+        // consumed but not returned.
+        template <typename Self, typename P>
+        constexpr auto take_while(this Self &&self, P pred) -> take_while_iter<std::remove_cvref_t<Self>, P> {
+            return { std::forward<Self>(self), std::move(pred) };
+        }
+
+        // The elements of this source, then those of `other`.
+        template <typename Self, source B>
+        constexpr auto chain(this Self &&self, B other) -> chain_iter<std::remove_cvref_t<Self>, B> {
+            return { std::forward<Self>(self), std::move(other) };
+        }
+
+        // Pairs of an element of each source, until either runs out.
+        template <typename Self, source B>
+        constexpr auto zip(this Self &&self, B other) -> zip_iter<std::remove_cvref_t<Self>, B> {
+            return { std::forward<Self>(self), std::move(other) };
+        }
+
+        // The first element, then every `step`-th. Panics if `step` is 0.
+        template <typename Self>
+        constexpr auto step_by(this Self &&self, std::size_t step) -> step_by_iter<std::remove_cvref_t<Self>> {
+            return { std::forward<Self>(self), step };
+        }
+
+        // `f(f(f(init, a), b), c)` over the remaining elements.
+        template <typename Self, typename Acc, typename F>
+        constexpr auto fold(this Self &&self, Acc init, F f) -> Acc {
+            while (auto x = self.next()) {
+                init = std::invoke(f, std::move(init), *std::move(x));
+            }
+            return init;
+        }
+
+        // Like `fold`, with an `f` that returns `option<Acc>`: the first `none`
+        // stops the iteration and is returned, and the rest of the elements are
+        // left in the source.
+        template <typename Self, typename Acc, typename F>
+        constexpr auto try_fold(this Self &&self, Acc init, F f) -> option<Acc> {
+            while (auto x = self.next()) {
+                option<Acc> step = std::invoke(f, std::move(init), *std::move(x));
+                if (step.is_none()) {
+                    return step;
+                }
+                init = *std::move(step);
+            }
+            return option<Acc>{ std::move(init) };
+        }
+
+        template <typename Self, typename F>
+        constexpr void for_each(this Self &&self, F f) {
+            while (auto x = self.next()) {
+                std::invoke(f, *std::move(x));
+            }
+        }
+
+        template <typename Self>
+        constexpr auto count(this Self &&self) -> std::size_t {
+            std::size_t n = 0;
+            while (self.next().is_some()) {
+                ++n;
+            }
+            return n;
+        }
+
+        // The remaining elements, inserted at the end of a `C`.
+        template <typename C, typename Self>
+        constexpr auto collect(this Self &&self) -> C {
+            C out;
+            if constexpr (requires { out.reserve(std::size_t{}); }) {
+                out.reserve(iter::size_hint(self).lower);
+            }
+            while (auto x = self.next()) {
+                out.insert(out.end(), *std::move(x));
+            }
+            return out;
+        }
+
+        // An input iterator, holding the first element, and its end.
+        template <typename Self>
+        constexpr auto begin(this Self &self) -> pull_iterator<Self> {
+            return pull_iterator<Self>{ self };
+        }
+
+        constexpr auto end() const noexcept -> std::default_sentinel_t {
+            return std::default_sentinel;
+        }
+    };
+
+    template <source S>
+    class pull_iterator {
+    public:
+        using iterator_concept = std::input_iterator_tag;
+        using reference = decltype(*std::declval<next_t<S> &>());
+        using value_type = std::remove_cvref_t<reference>;
+        using difference_type = std::ptrdiff_t;
+
+        pull_iterator() = default;
+
+        constexpr explicit pull_iterator(S &s) : src(std::addressof(s)), current(s.next()) {}
+
+        constexpr auto operator*() const -> reference {
+            return *current;
+        }
+
+        constexpr auto operator++() -> pull_iterator & {
+            if constexpr (std::is_assignable_v<next_t<S> &, next_t<S>>) {
+                current = src->next();
+            } else {
+                // Elements such as `std::pair<T &, const U &>` can be built but
+                // not assigned.
+                next_t<S> x = src->next();
+                std::destroy_at(std::addressof(current));
+                std::construct_at(std::addressof(current), std::move(x));
+            }
+            return *this;
+        }
+
+        constexpr void operator++(int) {
+            ++*this;
+        }
+
+        friend constexpr auto operator==(const pull_iterator &it, std::default_sentinel_t) -> bool {
+            return it.current.is_none();
+        }
+
+    private:
+        S *src = nullptr;
+        mutable next_t<S> current;
+    };
+
+    // The elements of a range, `option<T &>` for ranges of lvalues.
+    template <std::input_iterator I, std::sentinel_for<I> Sent>
+    class range_iter : public pull {
+    public:
+        constexpr range_iter(I first, Sent last) : first(std::move(first)), last(std::move(last)) {}
+
+        constexpr auto next() -> option<std::iter_reference_t<I>> {
+            if (first == last) {
+                return {};
+            }
+            option<std::iter_reference_t<I>> x{ *first };
+            ++first;
+            return x;
+        }
+
+        constexpr auto size_hint() const -> size_bounds
+            requires std::sized_sentinel_for<Sent, I>
+        {
+            const auto n = static_cast<std::size_t>(last - first);
+            return { n, option<std::size_t>{ n } };
+        }
+
+    private:
+        I first;
+        cpp20_no_unique_address Sent last;
+    };
+
+    // A source whose `next()` is `f()`.
+    template <typename F>
+        requires opt::detail::option_type<std::invoke_result_t<F &>>
+    class fn_iter : public pull {
+    public:
+        constexpr explicit fn_iter(F f) : f(std::move(f)) {}
+
+        constexpr auto next() -> std::invoke_result_t<F &> {
+            return std::invoke(f);
+        }
+
+    private:
+        cpp20_no_unique_address F f;
+    };
+
+    // A source that does not derive from `pull`, with its adaptors.
+    template <source S>
+    class source_iter : public pull {
+    public:
+        constexpr explicit source_iter(S src) : src(std::move(src)) {}
+
+        constexpr auto next() -> next_t<S> {
+            return src.next();
+        }
+
+        constexpr auto size_hint() const -> size_bounds {
+            return iter::size_hint(src);
+        }
+
+    private:
+        S src;
+    };
+
+    template <source S, typename F>
+    class map_iter : public pull {
+    public:
+        using output = std::invoke_result_t<F &, item_t<S>>;
+
+        constexpr map_iter(S src, F f) : src(std::move(src)), f(std::move(f)) {}
+
+        constexpr auto next() -> option<output> {
+            auto x = src.next();
+            if (x.is_none()) {
+                return {};
+            }
+            return option<output>{ std::invoke(f, *std::move(x)) };
+        }
+
+        constexpr auto size_hint() const -> size_bounds {
+            return iter::size_hint(src);
+        }
+
+    private:
+        S src;
+        cpp20_no_unique_address F f;
+    };
+
+    template <source S, typename P>
+    class filter_iter : public pull {
+    public:
+        constexpr filter_iter(S src, P pred) : src(std::move(src)), pred(std::move(pred)) {}
+
+        constexpr auto next() -> next_t<S> {
+            while (true) {
+                auto x = src.next();
+                if (x.is_none() || std::invoke(pred, std::as_const(*x))) {
+                    return x;
+                }
+            }
+        }
+
+        constexpr auto size_hint() const -> size_bounds {
+            return { 0, iter::size_hint(src).upper };
+        }
+
+    private:
+        S src;
+        cpp20_no_unique_address P pred;
+    };
+
+    template <source S, typename F>
+    class filter_map_iter : public pull {
+    public:
+        using output = std::remove_cvref_t<std::invoke_result_t<F &, item_t<S>>>;
+        static_assert(opt::detail::option_type<output>, "opt::iter::filter_map: the callback must return an option");
+
+        constexpr filter_map_iter(S src, F f) : src(std::move(src)), f(std::move(f)) {}
+
+        constexpr auto next() -> output {
+            while (true) {
+                auto x = src.next();
+                if (x.is_none()) {
+                    return {};
+                }
+                output y = std::invoke(f, *std::move(x));
+                if (y.is_some()) {
+                    return y;
+                }
+            }
+        }
+
+        constexpr auto size_hint() const -> size_bounds {
+            return { 0, iter::size_hint(src).upper };
+        }
+
+    private:
+        S src;
+        cpp20_no_unique_address F f;
+    };
+
+    template <source S, typename P>
+    class take_while_iter : public pull {
+    public:
+        constexpr take_while_iter(S src, P pred) : src(std::move(src)), pred(std::move(pred)) {}
+
+        // `none` for good once `pred` has failed, whatever is left below.
+        constexpr auto next() -> next_t<S> {
+            if (done) {
+                return {};
+            }
+            auto x = src.next();
+            if (x.is_some() && std::invoke(pred, std::as_const(*x))) {
+                return x;
+            }
+            done = true;
+            return {};
+        }
+
+        constexpr auto size_hint() const -> size_bounds {
+            return done ? size_bounds{ 0, option<std::size_t>{ 0 } } : size_bounds{ 0, iter::size_hint(src).upper };
+        }
+
+    private:
+        S src;
+        cpp20_no_unique_address P pred;
+        bool done = false;
+    };
+
+    template <source A, source B>
+    class chain_iter : public pull {
+    public:
+        static_assert(std::same_as<next_t<A>, next_t<B>>, "opt::iter::chain: the sources must have the same elements");
+
+        constexpr chain_iter(A a, B b) : a(std::move(a)), b(std::move(b)) {}
+
+        constexpr auto next() -> next_t<A> {
+            if (!a_done) {
+                auto x = a.next();
+                if (x.is_some()) {
+                    return x;
+                }
+                a_done = true;
+            }
+            return b.next();
+        }
+
+        constexpr auto size_hint() const -> size_bounds {
+            const size_bounds rest = iter::size_hint(b);
+            if (a_done) {
+                return rest;
+            }
+            const size_bounds first = iter::size_hint(a);
+            constexpr std::size_t max = std::numeric_limits<std::size_t>::max();
+            // The lower bound saturates, and an upper bound that overflows is unknown.
+            const std::size_t lower = first.lower > max - rest.lower ? max : first.lower + rest.lower;
+            option<std::size_t> upper;
+            if (first.upper.is_some() && rest.upper.is_some() && *first.upper <= max - *rest.upper) {
+                upper = option<std::size_t>{ *first.upper + *rest.upper };
+            }
+            return { lower, upper };
+        }
+
+    private:
+        A a;
+        B b;
+        bool a_done = false;
+    };
+
+    template <source A, source B>
+    class zip_iter : public pull {
+    public:
+        using output = std::pair<item_t<A>, item_t<B>>;
+
+        constexpr zip_iter(A a, B b) : a(std::move(a)), b(std::move(b)) {}
+
+        constexpr auto next() -> option<output> {
+            auto x = a.next();
+            if (x.is_none()) {
+                return {};
+            }
+            auto y = b.next();
+            if (y.is_none()) {
+                return {};
+            }
+            return option<output>{ output{ *std::move(x), *std::move(y) } };
+        }
+
+        constexpr auto size_hint() const -> size_bounds {
+            const size_bounds x = iter::size_hint(a);
+            const size_bounds y = iter::size_hint(b);
+            option<std::size_t> upper = x.upper.is_some() ? x.upper : y.upper;
+            if (x.upper.is_some() && y.upper.is_some()) {
+                upper = option<std::size_t>{ std::min(*x.upper, *y.upper) };
+            }
+            return { std::min(x.lower, y.lower), upper };
+        }
+
+    private:
+        A a;
+        B b;
+    };
+
+    template <source S>
+    class step_by_iter : public pull {
+    public:
+        constexpr step_by_iter(S src, std::size_t step) : src(std::move(src)), skip(step - 1) {
+            if (step == 0) {
+                throw option_panic("opt::iter::step_by: step is 0");
+            }
+        }
+
+        constexpr auto next() -> next_t<S> {
+            if (!first) {
+                for (std::size_t i = 0; i < skip; ++i) {
+                    if (src.next().is_none()) {
+                        return {};
+                    }
+                }
+            }
+            first = false;
+            return src.next();
+        }
+
+        constexpr auto size_hint() const -> size_bounds {
+            const size_bounds bounds = iter::size_hint(src);
+            const auto left = [&](std::size_t n) {
+                return first ? (n == 0 ? 0 : 1 + (n - 1) / (skip + 1)) : n / (skip + 1);
+            };
+            return { left(bounds.lower),
+                     bounds.upper.is_some() ? option<std::size_t>{ left(*bounds.upper) } : option<std::size_t>{} };
+        }
+
+    private:
+        S src;
+        std::size_t skip;
+        bool first = true;
+    };
+
+    // A source over a range, kept by reference unless it is borrowed.
+    template <std::ranges::input_range R>
+        requires std::ranges::borrowed_range<R> && (!source<std::remove_cvref_t<R>>)
+    constexpr auto from(R &&range) -> range_iter<std::ranges::iterator_t<R>, std::ranges::sentinel_t<R>> {
+        return { std::ranges::begin(range), std::ranges::end(range) };
+    }
+
+    // A source itself, with the adaptors if it does not derive from `pull`.
+    template <typename S>
+        requires source<std::remove_cvref_t<S>>
+    constexpr auto from(S &&src) {
+        if constexpr (std::derived_from<std::remove_cvref_t<S>, pull>) {
+            return std::remove_cvref_t<S>(std::forward<S>(src));
+        } else {
+            return source_iter<std::remove_cvref_t<S>>{ std::forward<S>(src) };
+        }
+    }
+
+    // A source that calls `f()` for each element, until it returns `none`.
+    template <typename F>
+        requires opt::detail::option_type<std::invoke_result_t<F &>>
+    constexpr auto from_fn(F f) -> fn_iter<F> {
+        return fn_iter<F>{ std::move(f) };
+    }
+} // namespace opt::iter
+
+#pragma pop_macro("cpp20_no_unique_address")
+
+#endif
@@ -0,0 +1,238 @@
+#ifndef OPT_OPTION_KLEENE_HPP
+#define OPT_OPTION_KLEENE_HPP
+
+// Three-valued (Kleene) logic on `option<bool>`, as SQL evaluates predicates
+// over `NULL`s: `none` is "unknown".
+//
+// `option::and_`/`or_` keep Rust's meaning (presence, not truth), so the SQL
+// connectives live in `opt::kleene`. A `none` decides nothing, but a known
+// `false` decides an AND and a known `true` decides an OR:
+//
+//     opt::kleene::and_(opt::some(false), opt::none);  // some(false)
+//     opt::kleene::or_(opt::some(true), opt::none);    // some(true)
+//     opt::kleene::and_(opt::some(true), opt::none);   // none
+//     opt::kleene::not_(opt::none);                    // none
+//
+// `opt::kleene::column` holds a column of such values as two bitmaps, the
+// validity and the value of each row, and combines them 64 rows per word
+// operation (more where the compiler vectorizes the loops):
+//
+//     opt::kleene::column price_ok{ prices_above_limit };  // from option<bool>s
+//     auto keep = price_ok & !is_halted | is_auction;      // row by row
+//     keep.is_true(i);                                     // what WHERE keeps
+//
+// A value bit is only ever set where its validity bit is, so `values()` is
+// also the set of rows that are `true`.
+
+#include <bit>
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <ranges>
+#include <span>
+#include <vector>
+
+#include "option.hpp"
+
+namespace opt::kleene {
+    constexpr auto and_(option<bool> a, option<bool> b) noexcept -> option<bool> {
+        if (a == option<bool>{ false } || b == option<bool>{ false }) {
+            return option<bool>{ false };
+        }
+        return a.is_some() && b.is_some() ? option<bool>{ true } : option<bool>{};
+    }
+
+    constexpr auto or_(option<bool> a, option<bool> b) noexcept -> option<bool> {
+        if (a == option<bool>{ true } || b == option<bool>{ true }) {
+            return option<bool>{ true };
+        }
+        return a.is_some() && b.is_some() ? option<bool>{ false } : option<bool>{};
+    }
+
+    constexpr auto xor_(option<bool> a, option<bool> b) noexcept -> option<bool> {
+        return a.is_some() && b.is_some() ? option<bool>{ *a != *b } : option<bool>{};
+    }
+
+    constexpr auto not_(option<bool> a) noexcept -> option<bool> {
+        return a.is_some() ? option<bool>{ !*a } : option<bool>{};
+    }
+
+    class column {
+    public:
+        static constexpr std::size_t word_bits = 64;
+
+        constexpr column() = default;
+
+        // `n` rows, all `none`.
+        constexpr explicit column(std::size_t n) : rows(n), valid(words_for(n)), value(words_for(n)) {}
+
+        template <typename R>
+            requires std::ranges::input_range<R> && std::same_as<std::ranges::range_value_t<R>, option<bool>>
+        constexpr explicit column(const R &options) {
+            for (const option<bool> &o : options) {
+                if (rows % word_bits == 0) {
+                    valid.push_back(0);
+                    value.push_back(0);
+                }
+                const std::size_t bit = rows % word_bits;
+                valid.back() |= static_cast<std::uint64_t>(o.is_some()) << bit;
+                value.back() |= static_cast<std::uint64_t>(o == option<bool>{ true }) << bit;
+                ++rows;
+            }
+        }
+
+        constexpr auto size() const noexcept -> std::size_t {
+            return rows;
+        }
+
+        constexpr auto get(std::size_t i) const noexcept -> option<bool> {
+            return is_known(i) ? option<bool>{ is_true(i) } : option<bool>{};
+        }
+
+        constexpr void set(std::size_t i, option<bool> o) noexcept {
+            const std::uint64_t bit = std::uint64_t{ 1 } << (i % word_bits);
+            valid[i / word_bits] = o.is_some() ? valid[i / word_bits] | bit : valid[i / word_bits] & ~bit;
+            value[i / word_bits] = o == option<bool>{ true } ? value[i / word_bits] | bit : value[i / word_bits] & ~bit;
+        }
+
+        constexpr auto is_known(std::size_t i) const noexcept -> bool {
+            return ((valid[i / word_bits] >> (i % word_bits)) & 1) != 0;
+        }
+
+        // Whether row `i` is `some(true)`, the rows a SQL `WHERE` keeps.
+        constexpr auto is_true(std::size_t i) const noexcept -> bool {
+            return ((value[i / word_bits] >> (i % word_bits)) & 1) != 0;
+        }
+
+        // The number of rows that are `some(true)`.
+        constexpr auto count_true() const noexcept -> std::size_t {
+            std::size_t n = 0;
+            for (const std::uint64_t word : value) {
+                n += static_cast<std::size_t>(std::popcount(word));
+            }
+            return n;
+        }
+
+        constexpr auto validity() const noexcept -> std::span<const std::uint64_t> {
+            return valid;
+        }
+
+        constexpr auto values() const noexcept -> std::span<const std::uint64_t> {
+            return value;
+        }
+
+        constexpr auto to_options() const -> std::vector<option<bool>> {
+            std::vector<option<bool>> options;
+            options.reserve(rows);
+            for (std::size_t i = 0; i < rows; ++i) {
+                options.push_back(get(i));
+            }
+            return options;
+        }
+
+        // In terms of the rows known to be true (`t`) and known to be false
+        // (`f`): AND is true where both are and false where either is, OR the
+        // other way around.
+        constexpr auto operator&=(const column &other) -> column & {
+            return combine(other, [](std::uint64_t ta, std::uint64_t fa, std::uint64_t tb, std::uint64_t fb) {
+                return known{ ta & tb, fa | fb };
+            });
+        }
+
+        constexpr auto operator|=(const column &other) -> column & {
+            return combine(other, [](std::uint64_t ta, std::uint64_t fa, std::uint64_t tb, std::uint64_t fb) {
+                return known{ ta | tb, fa & fb };
+            });
+        }
+
+        constexpr auto operator^=(const column &other) -> column & {
+            return combine(other, [](std::uint64_t ta, std::uint64_t fa, std::uint64_t tb, std::uint64_t fb) {
+                return known{ (ta & fb) | (fa & tb), (ta & tb) | (fa & fb) };
+            });
+        }
+
+        // Flips the known rows; `none`s stay.
+        constexpr auto flip() noexcept -> column & {
+            for (std::size_t w = 0; w < valid.size(); ++w) {
+                value[w] = valid[w] & ~value[w];
+            }
+            return *this;
+        }
+
+        friend constexpr auto operator&(column a, const column &b) -> column {
+            a &= b;
+            return a;
+        }
+
+        friend constexpr auto operator|(column a, const column &b) -> column {
+            a |= b;
+            return a;
+        }
+
+        friend constexpr auto operator^(column a, const column &b) -> column {
+            a ^= b;
+            return a;
+        }
+
+        friend constexpr auto operator!(column a) -> column {
+            a.flip();
+            return a;
+        }
+
+        friend constexpr auto operator==(const column &, const column &) noexcept -> bool = default;
+
+        static constexpr auto words_for(std::size_t n) noexcept -> std::size_t {
+            return (n + word_bits - 1) / word_bits;
+        }
+
+    private:
+        struct known {
+            std::uint64_t t;
+            std::uint64_t f;
+        };
+
+        std::size_t rows = 0;
+        // Bits past `rows` are 0 in both, and `value` is a subset of `valid`.
+        std::vector<std::uint64_t> valid;
+        std::vector<std::uint64_t> value;
+
+        template <typename Op>
+        constexpr auto combine(const column &other, Op op) -> column & {
+            if (rows != other.rows) {
+                throw option_panic("opt::kleene: columns differ in length");
+            }
+            std::uint64_t *const v = valid.data();
+            std::uint64_t *const x = value.data();
+            const std::uint64_t *const ov = other.valid.data();
+            const std::uint64_t *const ox = other.value.data();
+            for (std::size_t w = 0; w < valid.size(); ++w) {
+                const known k = op(x[w], v[w] & ~x[w], ox[w], ov[w] & ~ox[w]);
+                v[w] = k.t | k.f;
+                x[w] = k.t;
+            }
+            return *this;
+        }
+    };
+
+    inline auto and_(column a, const column &b) -> column {
+        a &= b;
+        return a;
+    }
+
+    inline auto or_(column a, const column &b) -> column {
+        a |= b;
+        return a;
+    }
+
+    inline auto xor_(column a, const column &b) -> column {
+        a ^= b;
+        return a;
+    }
+
+    inline auto not_(column a) -> column {
+        a.flip();
+        return a;
+    }
+} // namespace opt::kleene
+
+#endif
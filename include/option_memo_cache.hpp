@@ -0,0 +1,217 @@
+#ifndef OPT_OPTION_MEMO_CACHE_HPP
+#define OPT_OPTION_MEMO_CACHE_HPP
+
+// A fixed-capacity memoization cache that never allocates.
+//
+// `opt::memo_cache<K, V, N, Ways>` holds `N` slots of `option<std::pair<K, V>>`,
+// grouped into `N / Ways` sets of `Ways` slots. A key hashes to one set and may
+// live in any slot of it: `Ways == 1` is a direct-mapped cache, `Ways == N` a
+// fully associative one. When the set is full, the slot to drop is picked by
+// `memo_eviction::lru` (the least recently used one) or `memo_eviction::clock`
+// (the first one not used since the hand last passed it). Every operation
+// touches a single set, so its cost is bounded by `Ways`:
+//
+//     opt::memo_cache<std::uint32_t, double, 1024, 4> prices;
+//     const double &p = prices.get_or_compute(sku, [](std::uint32_t id) { return price_of(id); });
+//
+// `get_or_compute` follows `option::get_or_insert_with`: it returns the cached
+// value, or computes one with `f(key)` and stores it. `f` runs before a slot is
+// picked, so it may use the cache itself (a memoized recursive function). The
+// returned reference, like the one `find` returns, is valid until the next call
+// that inserts into the cache.
+//
+// A cache is not synchronized. `opt::thread_local_memo<Cache>()` returns one
+// instance per thread.
+
+#include <array>
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <type_traits>
+#include <utility>
+
+#include "option.hpp"
+
+namespace opt {
+    enum class memo_eviction : std::uint8_t {
+        lru,
+        clock,
+    };
+
+    template <typename K, typename V, std::size_t N, std::size_t Ways = 1, memo_eviction Eviction = memo_eviction::lru,
+              typename Hash = std::hash<K>, typename KeyEqual = std::equal_to<K>>
+    class memo_cache {
+    public:
+        using key_type = K;
+        using mapped_type = V;
+        using value_type = std::pair<K, V>;
+        using slot_type = option<value_type>;
+
+        static constexpr std::size_t set_count = N / Ways;
+
+        static_assert(N > 0 && Ways > 0 && N % Ways == 0, "opt::memo_cache: `N` must be a multiple of `Ways`");
+        static_assert(Ways <= 255, "opt::memo_cache: at most 255 ways per set");
+
+        constexpr memo_cache() = default;
+
+        // Returns the cached value for `key`, or `none`, and marks it as used.
+        constexpr auto find(const K &key) -> option<const V &> {
+            const std::size_t set = set_of(key);
+            if (const auto way = way_of(set, key); way != Ways) {
+                touch(set, way);
+                return option<const V &>{ slots[set * Ways + way]->second };
+            }
+            return option<const V &>{};
+        }
+
+        constexpr auto contains(const K &key) const -> bool {
+            return way_of(set_of(key), key) != Ways;
+        }
+
+        // Returns the cached value for `key`, or inserts `f(key)` (evicting a slot
+        // of the set if it is full) and returns that.
+        template <typename F>
+            requires std::invocable<F &, const K &> && std::constructible_from<V, std::invoke_result_t<F &, const K &>>
+        constexpr auto get_or_compute(const K &key, F &&f) -> const V & {
+            const std::size_t set = set_of(key);
+            if (const auto way = way_of(set, key); way != Ways) [[likely]] {
+                touch(set, way);
+                return slots[set * Ways + way]->second;
+            }
+            V value(std::invoke(f, key));
+            // `f` may have filled the set, or even stored `key`, in the meantime.
+            auto way = way_of(set, key);
+            if (way == Ways) {
+                way = victim(set);
+            }
+            touch(set, way);
+            return slots[set * Ways + way].insert(value_type{ key, std::move(value) }).second;
+        }
+
+        // Removes `key` from the cache and returns its value, or `none`.
+        constexpr auto erase(const K &key) -> option<V> {
+            const std::size_t set = set_of(key);
+            if (const auto way = way_of(set, key); way != Ways) {
+                return slots[set * Ways + way].take().map([](value_type &&entry) { return std::move(entry.second); });
+            }
+            return option<V>{};
+        }
+
+        constexpr void clear() noexcept {
+            for (auto &slot : slots) {
+                slot.reset();
+            }
+        }
+
+        // The number of cached entries, counted by a pass over all slots.
+        constexpr auto size() const noexcept -> std::size_t {
+            std::size_t n = 0;
+            for (const auto &slot : slots) {
+                n += slot.is_some();
+            }
+            return n;
+        }
+
+        static constexpr auto capacity() noexcept -> std::size_t {
+            return N;
+        }
+
+    private:
+        static constexpr bool tracks_use = Ways > 1;
+
+        std::array<slot_type, N> slots{};
+        // LRU: the rank of each slot in its set, 0 for the most recently used.
+        // CLOCK: whether each slot was used since the hand last passed it.
+        std::array<std::uint8_t, tracks_use ? N : 0> use{ initial_use() };
+        // CLOCK: the slot of each set the hand points at.
+        std::array<std::uint8_t, tracks_use && Eviction == memo_eviction::clock ? set_count : 0> hands{};
+
+        static constexpr auto initial_use() noexcept -> std::array<std::uint8_t, tracks_use ? N : 0> {
+            std::array<std::uint8_t, tracks_use ? N : 0> ranks{};
+            if constexpr (tracks_use && Eviction == memo_eviction::lru) {
+                for (std::size_t i = 0; i < N; ++i) {
+                    ranks[i] = static_cast<std::uint8_t>(i % Ways);
+                }
+            }
+            return ranks;
+        }
+
+        // Maps the hash with a multiply instead of a division, after spreading it,
+        // since `std::hash` of an integer is usually the integer itself.
+        static constexpr auto set_of(const K &key) noexcept(noexcept(Hash{}(key))) -> std::size_t {
+            if constexpr (set_count == 1) {
+                return 0;
+            } else {
+                const std::uint64_t hash = static_cast<std::uint64_t>(Hash{}(key)) * 0x9e3779b97f4a7c15ULL;
+                return static_cast<std::size_t>(((hash >> 32) * set_count) >> 32);
+            }
+        }
+
+        // The way of `set` that holds `key`, or `Ways`.
+        constexpr auto way_of(std::size_t set, const K &key) const -> std::size_t {
+            for (std::size_t way = 0; way < Ways; ++way) {
+                if (slots[set * Ways + way].is_some_and([&](const value_type &entry) {
+                        return KeyEqual{}(entry.first, key);
+                    })) {
+                    return way;
+                }
+            }
+            return Ways;
+        }
+
+        constexpr void touch(std::size_t set, std::size_t way) noexcept {
+            if constexpr (!tracks_use) {
+                return;
+            } else if constexpr (Eviction == memo_eviction::lru) {
+                std::uint8_t *ranks = use.data() + set * Ways;
+                const std::uint8_t rank = ranks[way];
+                for (std::size_t i = 0; i < Ways; ++i) {
+                    ranks[i] += ranks[i] < rank;
+                }
+                ranks[way] = 0;
+            } else {
+                use[set * Ways + way] = 1;
+            }
+        }
+
+        // An empty slot of `set` if there is one, else the slot to evict.
+        constexpr auto victim(std::size_t set) noexcept -> std::size_t {
+            for (std::size_t way = 0; way < Ways; ++way) {
+                if (slots[set * Ways + way].is_none()) {
+                    return way;
+                }
+            }
+            if constexpr (!tracks_use) {
+                return 0;
+            } else if constexpr (Eviction == memo_eviction::lru) {
+                const std::uint8_t *ranks = use.data() + set * Ways;
+                std::size_t oldest = 0;
+                for (std::size_t way = 1; way < Ways; ++way) {
+                    oldest = ranks[way] > ranks[oldest] ? way : oldest;
+                }
+                return oldest;
+            } else {
+                // Clears the bits it passes, so this ends within two turns.
+                std::uint8_t &hand = hands[set];
+                while (use[set * Ways + hand] != 0) {
+                    use[set * Ways + hand] = 0;
+                    hand = static_cast<std::uint8_t>((hand + 1) % Ways);
+                }
+                const std::size_t way = hand;
+                hand = static_cast<std::uint8_t>((hand + 1) % Ways);
+                return way;
+            }
+        }
+    };
+
+    // The calling thread's instance of `Cache`. Give a distinct `Tag` to keep
+    // several caches of the same type apart.
+    template <typename Cache, typename Tag = Cache>
+    auto thread_local_memo() -> Cache & {
+        thread_local Cache cache;
+        return cache;
+    }
+} // namespace opt
+
+#endif
@@ -0,0 +1,23 @@
+#ifndef OPT_OPTION_PANIC_HPP
+#define OPT_OPTION_PANIC_HPP
+
+// The exception thrown by `unwrap`, `expect` and the checked operations, shared
+// by `option.hpp` and `option_core.hpp` so that neither has to include the other.
+
+#include <exception>
+
+namespace opt {
+    class option_panic : public std::exception {
+    public:
+        explicit option_panic(const char *message) : message(message) {}
+
+        const char *what() const noexcept override {
+            return message;
+        }
+
+    private:
+        const char *message;
+    };
+} // namespace opt
+
+#endif
@@ -0,0 +1,709 @@
+#ifndef OPT_OPTION_RESULT_HPP
+#define OPT_OPTION_RESULT_HPP
+
+// `opt::result<T, E>`: a value or an error, with Rust's `Result` interface.
+//
+// `option::ok_or` converts into `std::expected`, whose layout each standard
+// library picks. `result` holds either a `T` (or a `T &`) or an `E` in storage
+// of the same kind as `option`'s, and takes its niches where `option` has them:
+// with an empty `E`, such as a tag type, it is laid out as `option<T>`, so that
+// `result<T &, E>` is a single pointer (null for the error) and `result<int, E>`
+// is an `int` and a flag.
+//
+//     opt::result<int, parse_error> parse(std::string_view s);
+//
+//     auto n = parse("42").map([](int v) { return v * 2; }).unwrap_or(0);  // 84
+//     auto r = opt::ok_or(lookup(key), parse_error::missing);               // option -> result
+//     opt::option<int> v = parse("x").ok();                                 // none
+//     return opt::err(parse_error::bad_digit);  // converts to any result<T, parse_error>
+//
+// It converts from and to `std::expected<T, E>` (`to_expected()`), so it can
+// replace `std::expected` at API boundaries. The members follow `option`'s:
+// `is_ok`/`is_err` (and `_and`), `ok`/`err`, `map`/`map_err`/`map_or`/
+// `map_or_else`, `and_then`/`or_else`, `and_`/`or_`, `inspect`/`inspect_err`,
+// `unwrap`/`expect` (and `_err`), `unwrap_or`/`unwrap_or_else`/
+// `unwrap_or_default`, `flatten`, `transpose` and `copied`/`cloned`. Accessing
+// the side that is not there panics with `opt::option_panic`.
+//
+// `T` is an object type or an lvalue reference, and `E` an object type.
+
+#include <concepts>
+#include <expected>
+#include <functional>
+#include <memory>
+#include <type_traits>
+#include <utility>
+
+#include "option.hpp"
+
+#pragma push_macro("cpp20_no_unique_address")
+#undef cpp20_no_unique_address
+#if __has_cpp_attribute(msvc::no_unique_address)
+    #define cpp20_no_unique_address [[msvc::no_unique_address]]
+#else
+    #define cpp20_no_unique_address [[no_unique_address]]
+#endif
+
+namespace opt {
+    template <typename T, typename E>
+    class result;
+
+    // An error on its way into a `result`, as `std::unexpected` is for `std::expected`.
+    template <typename E>
+    struct err_t {
+        E error;
+    };
+
+    template <typename E>
+    constexpr auto err(E &&error) -> err_t<std::remove_cvref_t<E>> {
+        return err_t<std::remove_cvref_t<E>>{ std::forward<E>(error) };
+    }
+
+    namespace detail {
+        template <typename T>
+        concept result_type = specialization_of<std::remove_cvref_t<T>, result>;
+
+        template <typename T>
+        concept err_type = specialization_of<std::remove_cvref_t<T>, err_t>;
+
+        // What a `result<T, E>` keeps for its value: a pointer for references.
+        template <typename T>
+        using result_slot = std::conditional_t<std::is_lvalue_reference_v<T>, std::remove_reference_t<T> *, T>;
+
+        template <typename V, typename E>
+        inline constexpr bool result_trivial_copy = std::is_trivially_copy_constructible_v<V>
+                                                 && std::is_trivially_copy_constructible_v<E>;
+
+        template <typename V, typename E>
+        inline constexpr bool result_trivial_move = std::is_trivially_move_constructible_v<V>
+                                                 && std::is_trivially_move_constructible_v<E>;
+
+        template <typename V, typename E>
+        inline constexpr bool result_trivial_copy_assign = result_trivial_copy<V, E>
+                                                        && std::is_trivially_copy_assignable_v<V>
+                                                        && std::is_trivially_copy_assignable_v<E>;
+
+        template <typename V, typename E>
+        inline constexpr bool result_trivial_move_assign = result_trivial_move<V, E>
+                                                        && std::is_trivially_move_assignable_v<V>
+                                                        && std::is_trivially_move_assignable_v<E>;
+
+        template <typename V, typename E>
+        inline constexpr bool result_trivial_destroy = std::is_trivially_destructible_v<V>
+                                                    && std::is_trivially_destructible_v<E>;
+
+        // The value and the error share a union, told apart by a flag, as in
+        // `option_storage`. The special members are trivial when both sides'
+        // are, so that a `result<int, errc>` is passed in registers.
+        template <typename T, typename E>
+        struct result_storage {
+            using value_type = result_slot<T>;
+
+            union {
+                value_type value;
+                E error;
+            };
+            bool ok_;
+
+            template <typename... Ts>
+            constexpr explicit result_storage(std::in_place_t, Ts &&...args) noexcept(
+                std::is_nothrow_constructible_v<value_type, Ts...>) : value(std::forward<Ts>(args)...), ok_{ true } {}
+
+            template <typename... Ts>
+            constexpr explicit result_storage(std::unexpect_t, Ts &&...args) noexcept(
+                std::is_nothrow_constructible_v<E, Ts...>) : error(std::forward<Ts>(args)...), ok_{ false } {}
+
+            constexpr result_storage(const result_storage &)
+                requires result_trivial_copy<value_type, E>
+            = default;
+
+            constexpr result_storage(const result_storage &other) noexcept(
+                std::is_nothrow_copy_constructible_v<value_type> && std::is_nothrow_copy_constructible_v<E>)
+                requires (!result_trivial_copy<value_type, E>)
+                : ok_{ other.ok_ } {
+                if (ok_) {
+                    std::construct_at(std::addressof(value), other.value);
+                } else {
+                    std::construct_at(std::addressof(error), other.error);
+                }
+            }
+
+            constexpr result_storage(result_storage &&)
+                requires result_trivial_move<value_type, E>
+            = default;
+
+            constexpr result_storage(result_storage &&other) noexcept(
+                std::is_nothrow_move_constructible_v<value_type> && std::is_nothrow_move_constructible_v<E>)
+                requires (!result_trivial_move<value_type, E>)
+                : ok_{ other.ok_ } {
+                if (ok_) {
+                    std::construct_at(std::addressof(value), std::move(other.value));
+                } else {
+                    std::construct_at(std::addressof(error), std::move(other.error));
+                }
+            }
+
+            constexpr result_storage &operator=(const result_storage &)
+                requires result_trivial_copy_assign<value_type, E>
+            = default;
+
+            constexpr result_storage &operator=(const result_storage &other)
+                requires (!result_trivial_copy_assign<value_type, E>)
+            {
+                if (this == &other) {
+                    return *this;
+                }
+                if (ok_ && other.ok_) {
+                    value = other.value;
+                } else if (!ok_ && !other.ok_) {
+                    error = other.error;
+                } else if (other.ok_) {
+                    value_type copy(other.value);
+                    std::destroy_at(std::addressof(error));
+                    std::construct_at(std::addressof(value), std::move(copy));
+                    ok_ = true;
+                } else {
+                    E copy(other.error);
+                    std::destroy_at(std::addressof(value));
+                    std::construct_at(std::addressof(error), std::move(copy));
+                    ok_ = false;
+                }
+                return *this;
+            }
+
+            constexpr result_storage &operator=(result_storage &&)
+                requires result_trivial_move_assign<value_type, E>
+            = default;
+
+            constexpr result_storage &operator=(result_storage &&other) noexcept(
+                std::is_nothrow_move_assignable_v<value_type> && std::is_nothrow_move_constructible_v<value_type>
+                && std::is_nothrow_move_assignable_v<E> && std::is_nothrow_move_constructible_v<E>)
+                requires (!result_trivial_move_assign<value_type, E>)
+            {
+                if (this == &other) {
+                    return *this;
+                }
+                if (ok_ && other.ok_) {
+                    value = std::move(other.value);
+                } else if (!ok_ && !other.ok_) {
+                    error = std::move(other.error);
+                } else if (other.ok_) {
+                    value_type moved(std::move(other.value));
+                    std::destroy_at(std::addressof(error));
+                    std::construct_at(std::addressof(value), std::move(moved));
+                    ok_ = true;
+                } else {
+                    E moved(std::move(other.error));
+                    std::destroy_at(std::addressof(value));
+                    std::construct_at(std::addressof(error), std::move(moved));
+                    ok_ = false;
+                }
+                return *this;
+            }
+
+            constexpr ~result_storage()
+                requires result_trivial_destroy<value_type, E>
+            = default;
+
+            constexpr ~result_storage()
+                requires (!result_trivial_destroy<value_type, E>)
+            {
+                if (ok_) {
+                    std::destroy_at(std::addressof(value));
+                } else {
+                    std::destroy_at(std::addressof(error));
+                }
+            }
+
+            constexpr auto is_ok() const noexcept -> bool {
+                return ok_;
+            }
+
+            template <typename Self>
+            constexpr auto &&get(this Self &&self) noexcept {
+                if constexpr (std::is_lvalue_reference_v<T>) {
+                    return *self.value;
+                } else {
+                    return std::forward_like<Self>(self.value);
+                }
+            }
+
+            template <typename Self>
+            constexpr auto &&get_error(this Self &&self) noexcept {
+                return std::forward_like<Self>(self.error);
+            }
+        };
+
+        // Empty errors carry no information besides being there, so the result
+        // is an `option_storage<T>`, niche included (a null `T &` is the error).
+        template <typename T, typename E>
+            requires std::is_empty_v<E> && std::is_trivially_copyable_v<E>
+                  && std::is_trivially_default_constructible_v<E>
+        struct result_storage<T, E> {
+            using value_type = result_slot<T>;
+
+            option_storage<T> slot;
+            cpp20_no_unique_address E error{};
+
+            // A reference arrives as a pointer, as for the union above.
+            template <typename... Ts>
+            constexpr explicit result_storage(std::in_place_t, Ts &&...args) noexcept(
+                std::is_nothrow_constructible_v<value_type, Ts...>) : slot(make_slot(std::forward<Ts>(args)...)) {}
+
+            template <typename... Ts>
+            constexpr explicit result_storage(std::unexpect_t, Ts &&...args) noexcept(
+                std::is_nothrow_constructible_v<E, Ts...>) : slot(), error(std::forward<Ts>(args)...) {}
+
+            constexpr auto is_ok() const noexcept -> bool {
+                return slot.has_value();
+            }
+
+            template <typename Self>
+            constexpr auto &&get(this Self &&self) noexcept {
+                return std::forward<Self>(self).slot.get();
+            }
+
+            template <typename Self>
+            constexpr auto &&get_error(this Self &&self) noexcept {
+                return std::forward_like<Self>(self.error);
+            }
+
+            template <typename... Ts>
+            static constexpr auto make_slot(Ts &&...args) -> option_storage<T> {
+                if constexpr (std::is_lvalue_reference_v<T>) {
+                    return option_storage<T>(*args...);
+                } else {
+                    return option_storage<T>(std::in_place, std::forward<Ts>(args)...);
+                }
+            }
+        };
+
+        template <typename O>
+        struct option_payload;
+
+        template <typename T>
+        struct option_payload<option<T>> {
+            using type = T;
+        };
+    } // namespace detail
+
+    template <typename T, typename E>
+    class result {
+        static_assert(std::is_object_v<T> || std::is_lvalue_reference_v<T>,
+                      "opt::result: `T` must be an object type or an lvalue reference");
+        static_assert(std::is_object_v<E> && !std::is_array_v<E>, "opt::result: `E` must be an object type");
+
+        using storage_type = detail::result_storage<T, E>;
+
+        template <typename U, typename G>
+        friend class result;
+
+    public:
+        using value_type = T;
+        using error_type = E;
+
+        template <typename U>
+        using rebind = result<U, E>;
+
+    private:
+        // The error as `Self` passes it on: moved out of rvalues.
+        template <typename Self>
+        using error_of = decltype(std::forward_like<Self>(std::declval<E &>()));
+
+    public:
+
+        constexpr result()
+            requires std::default_initializable<T>
+            : storage(std::in_place) {}
+
+        template <typename U = std::remove_cv_t<T>>
+            requires std::constructible_from<T, U> && (!std::is_reference_v<T> || std::is_lvalue_reference_v<U>)
+                  && (!std::same_as<std::remove_cvref_t<U>, std::in_place_t>)
+                  && (!std::same_as<std::remove_cvref_t<U>, std::unexpect_t>)
+                  && (!std::same_as<std::remove_cvref_t<U>, result>) && (!detail::err_type<U>)
+                  && (!detail::expected_type<std::remove_cvref_t<U>>)
+        constexpr explicit(!std::convertible_to<U, T>) result(U &&value) noexcept(
+            std::is_nothrow_constructible_v<T, U>) : storage(std::in_place, slot_arg(std::forward<U>(value))) {}
+
+        template <typename G>
+            requires std::constructible_from<E, const G &>
+        constexpr explicit(!std::convertible_to<const G &, E>) result(const err_t<G> &error) :
+            storage(std::unexpect, error.error) {}
+
+        template <typename G>
+            requires std::constructible_from<E, G>
+        constexpr explicit(!std::convertible_to<G, E>) result(err_t<G> &&error) :
+            storage(std::unexpect, std::move(error.error)) {}
+
+        template <typename... Ts>
+            requires (!std::is_reference_v<T>) && std::constructible_from<T, Ts...>
+        constexpr explicit result(std::in_place_t, Ts &&...args) : storage(std::in_place, std::forward<Ts>(args)...) {}
+
+        template <typename... Ts>
+            requires std::constructible_from<E, Ts...>
+        constexpr explicit result(std::unexpect_t, Ts &&...args) : storage(std::unexpect, std::forward<Ts>(args)...) {}
+
+        template <typename X>
+            requires detail::expected_type<std::remove_cvref_t<X>> && (!std::is_reference_v<T>)
+                  && std::constructible_from<T, decltype(*std::declval<X>())>
+                  && std::constructible_from<E, decltype(std::declval<X>().error())>
+        constexpr result(X &&expected) : storage(from_expected(std::forward<X>(expected))) {}
+
+        // The result as a `std::expected<T, E>`.
+        template <typename Self>
+        constexpr auto to_expected(this Self &&self) -> std::expected<T, E>
+            requires (!std::is_reference_v<T>)
+        {
+            if (self.is_ok()) {
+                return std::expected<T, E>{ std::in_place, std::forward<Self>(self).storage.get() };
+            }
+            return std::expected<T, E>{ std::unexpect, std::forward<Self>(self).storage.get_error() };
+        }
+
+        constexpr auto is_ok() const noexcept -> bool {
+            return storage.is_ok();
+        }
+
+        constexpr auto is_err() const noexcept -> bool {
+            return !storage.is_ok();
+        }
+
+        constexpr explicit operator bool() const noexcept {
+            return storage.is_ok();
+        }
+
+        template <typename Self, typename F>
+        constexpr auto is_ok_and(this Self &&self, F &&f) -> bool {
+            return self.is_ok() && std::invoke(std::forward<F>(f), std::forward<Self>(self).storage.get());
+        }
+
+        template <typename Self, typename F>
+        constexpr auto is_err_and(this Self &&self, F &&f) -> bool {
+            return self.is_err() && std::invoke(std::forward<F>(f), std::forward<Self>(self).storage.get_error());
+        }
+
+        // The value, or `none` for an error.
+        template <typename Self>
+        constexpr auto ok(this Self &&self) -> option<T> {
+            if (self.is_ok()) {
+                return option<T>{ std::forward<Self>(self).storage.get() };
+            }
+            return option<T>{};
+        }
+
+        // The error, or `none` for a value.
+        template <typename Self>
+        constexpr auto err(this Self &&self) -> option<E> {
+            if (self.is_err()) {
+                return option<E>{ std::forward<Self>(self).storage.get_error() };
+            }
+            return option<E>{};
+        }
+
+        // The value, unchecked.
+        template <typename Self>
+        constexpr auto operator*(this Self &&self) noexcept -> auto && {
+            return std::forward<Self>(self).storage.get();
+        }
+
+        template <typename Self>
+        constexpr auto operator->(this Self &&self) noexcept {
+            return std::addressof(self.storage.get());
+        }
+
+        template <typename Self>
+        constexpr auto unwrap(this Self &&self) -> auto && {
+            if (self.is_err()) {
+                throw option_panic("called `result::unwrap()` on an `err` value");
+            }
+            return std::forward<Self>(self).storage.get();
+        }
+
+        template <typename Self>
+        constexpr auto expect(this Self &&self, const char *msg) -> auto && {
+            if (self.is_err()) {
+                throw option_panic(msg);
+            }
+            return std::forward<Self>(self).storage.get();
+        }
+
+        template <typename Self>
+        constexpr auto unwrap_err(this Self &&self) -> auto && {
+            if (self.is_ok()) {
+                throw option_panic("called `result::unwrap_err()` on an `ok` value");
+            }
+            return std::forward<Self>(self).storage.get_error();
+        }
+
+        template <typename Self>
+        constexpr auto expect_err(this Self &&self, const char *msg) -> auto && {
+            if (self.is_ok()) {
+                throw option_panic(msg);
+            }
+            return std::forward<Self>(self).storage.get_error();
+        }
+
+        // Arguments passed to `unwrap_or` are eagerly evaluated; use
+        // `unwrap_or_else` for a default that is costly to make.
+        template <typename Self, typename U>
+            requires (!std::is_reference_v<T>) && std::convertible_to<U, T>
+        constexpr auto unwrap_or(this Self &&self, U &&fallback) -> std::remove_cv_t<T> {
+            if (self.is_ok()) {
+                return std::forward<Self>(self).storage.get();
+            }
+            return static_cast<std::remove_cv_t<T>>(std::forward<U>(fallback));
+        }
+
+        constexpr auto unwrap_or(T fallback) const noexcept -> T
+            requires std::is_lvalue_reference_v<T>
+        {
+            return is_ok() ? storage.get() : fallback;
+        }
+
+        // The value, or `f(error)`.
+        template <typename Self, typename F>
+        constexpr auto unwrap_or_else(this Self &&self, F &&f) -> std::remove_cvref_t<T> {
+            if (self.is_ok()) {
+                return std::forward<Self>(self).storage.get();
+            }
+            return std::invoke(std::forward<F>(f), std::forward<Self>(self).storage.get_error());
+        }
+
+        template <typename Self>
+        constexpr auto unwrap_or_default(this Self &&self) -> std::remove_cv_t<T>
+            requires (!std::is_reference_v<T>) && std::default_initializable<std::remove_cv_t<T>>
+        {
+            if (self.is_ok()) {
+                return std::forward<Self>(self).storage.get();
+            }
+            return std::remove_cv_t<T>{};
+        }
+
+        // `f(value)` as a result, errors passed through.
+        template <typename Self, typename F>
+        constexpr auto map(this Self &&self, F &&f)
+            -> result<std::remove_cv_t<std::invoke_result_t<F, decltype(*std::declval<Self>())>>, E> {
+            using U = std::remove_cv_t<std::invoke_result_t<F, decltype(*std::declval<Self>())>>;
+            if (self.is_ok()) {
+                return result<U, E>::from_value(
+                    std::invoke(std::forward<F>(f), std::forward<Self>(self).storage.get()));
+            }
+            return result<U, E>(std::unexpect, std::forward<Self>(self).storage.get_error());
+        }
+
+        // `f(error)` as the error, values passed through.
+        template <typename Self, typename F>
+        constexpr auto map_err(this Self &&self, F &&f)
+            -> result<T, std::remove_cvref_t<std::invoke_result_t<F, error_of<Self>>>> {
+            using G = std::remove_cvref_t<std::invoke_result_t<F, error_of<Self>>>;
+            if (self.is_ok()) {
+                return result<T, G>::from_value(std::forward<Self>(self).storage.get());
+            }
+            return result<T, G>(std::unexpect,
+                                std::invoke(std::forward<F>(f), std::forward<Self>(self).storage.get_error()));
+        }
+
+        template <typename Self, typename U, typename F>
+        constexpr auto map_or(this Self &&self, U &&fallback, F &&f) -> std::remove_cvref_t<U> {
+            if (self.is_ok()) {
+                return std::invoke(std::forward<F>(f), std::forward<Self>(self).storage.get());
+            }
+            return std::forward<U>(fallback);
+        }
+
+        // `f(value)`, or `fallback(error)`.
+        template <typename Self, typename D, typename F>
+        constexpr auto map_or_else(this Self &&self, D &&fallback, F &&f)
+            -> std::remove_cvref_t<std::invoke_result_t<F, decltype(*std::declval<Self>())>> {
+            if (self.is_ok()) {
+                return std::invoke(std::forward<F>(f), std::forward<Self>(self).storage.get());
+            }
+            return std::invoke(std::forward<D>(fallback), std::forward<Self>(self).storage.get_error());
+        }
+
+        // `f(value)`, itself a `result<U, E>`, or the error.
+        template <typename Self, typename F>
+        constexpr auto and_then(this Self &&self, F &&f)
+            -> std::remove_cvref_t<std::invoke_result_t<F, decltype(*std::declval<Self>())>> {
+            using R = std::remove_cvref_t<std::invoke_result_t<F, decltype(*std::declval<Self>())>>;
+            static_assert(detail::result_type<R> && std::same_as<typename R::error_type, E>,
+                          "opt::result::and_then: `f` must return a result with the same error type");
+            if (self.is_ok()) {
+                return std::invoke(std::forward<F>(f), std::forward<Self>(self).storage.get());
+            }
+            return R(std::unexpect, std::forward<Self>(self).storage.get_error());
+        }
+
+        // The value, or `f(error)`, itself a `result<T, G>`.
+        template <typename Self, typename F>
+        constexpr auto or_else(this Self &&self, F &&f)
+            -> std::remove_cvref_t<std::invoke_result_t<F, error_of<Self>>> {
+            using R = std::remove_cvref_t<std::invoke_result_t<F, error_of<Self>>>;
+            static_assert(detail::result_type<R> && std::same_as<typename R::value_type, T>,
+                          "opt::result::or_else: `f` must return a result with the same value type");
+            if (self.is_ok()) {
+                return R::from_value(std::forward<Self>(self).storage.get());
+            }
+            return std::invoke(std::forward<F>(f), std::forward<Self>(self).storage.get_error());
+        }
+
+        // `other` if this is a value, else this error.
+        template <typename Self, typename U>
+        constexpr auto and_(this Self &&self, result<U, E> other) -> result<U, E> {
+            if (self.is_ok()) {
+                return other;
+            }
+            return result<U, E>(std::unexpect, std::forward<Self>(self).storage.get_error());
+        }
+
+        // This value, else `other`.
+        template <typename Self, typename G>
+        constexpr auto or_(this Self &&self, result<T, G> other) -> result<T, G> {
+            if (self.is_ok()) {
+                return result<T, G>::from_value(std::forward<Self>(self).storage.get());
+            }
+            return other;
+        }
+
+        template <typename Self, typename F>
+        constexpr auto inspect(this Self &&self, F &&f) -> Self && {
+            if (self.is_ok()) {
+                std::invoke(std::forward<F>(f), self.storage.get());
+            }
+            return std::forward<Self>(self);
+        }
+
+        template <typename Self, typename F>
+        constexpr auto inspect_err(this Self &&self, F &&f) -> Self && {
+            if (self.is_err()) {
+                std::invoke(std::forward<F>(f), self.storage.get_error());
+            }
+            return std::forward<Self>(self);
+        }
+
+        // `result<result<U, E>, E>` to `result<U, E>`.
+        template <typename Self>
+            requires detail::result_type<T> && std::same_as<typename std::remove_cvref_t<T>::error_type, E>
+        constexpr auto flatten(this Self &&self) -> std::remove_cvref_t<T> {
+            if (self.is_ok()) {
+                return std::forward<Self>(self).storage.get();
+            }
+            return std::remove_cvref_t<T>(std::unexpect, std::forward<Self>(self).storage.get_error());
+        }
+
+        // `result<option<U>, E>` to `option<result<U, E>>`: `none` for `ok(none)`.
+        template <typename Self>
+            requires detail::option_type<T>
+        constexpr auto transpose(this Self &&self)
+            -> option<result<typename std::remove_cvref_t<decltype(*std::declval<Self>())>::value_type, E>> {
+            using R = result<typename std::remove_cvref_t<decltype(*std::declval<Self>())>::value_type, E>;
+            if (self.is_err()) {
+                return option<R>{ R(std::unexpect, std::forward<Self>(self).storage.get_error()) };
+            }
+            if (self.storage.get().is_none()) {
+                return option<R>{};
+            }
+            return option<R>{ R::from_value(*std::forward<Self>(self).storage.get()) };
+        }
+
+        // A `result<T &, E>` with the value copied out.
+        template <typename Self>
+            requires std::is_lvalue_reference_v<T> && std::copy_constructible<std::remove_cvref_t<T>>
+        constexpr auto copied(this Self &&self) -> result<std::remove_cvref_t<T>, E> {
+            using R = result<std::remove_cvref_t<T>, E>;
+            if (self.is_ok()) {
+                return R::from_value(self.storage.get());
+            }
+            return R(std::unexpect, std::forward<Self>(self).storage.get_error());
+        }
+
+        template <typename Self>
+            requires std::is_lvalue_reference_v<T> && std::copy_constructible<std::remove_cvref_t<T>>
+        constexpr auto cloned(this Self &&self) -> result<std::remove_cvref_t<T>, E> {
+            return std::forward<Self>(self).copied();
+        }
+
+        template <typename U, typename G>
+        friend constexpr auto operator==(const result &a, const result<U, G> &b) -> bool {
+            if (a.is_ok() != b.is_ok()) {
+                return false;
+            }
+            // `b` may be another specialization, whose storage is private to it.
+            return a.is_ok() ? a.storage.get() == *b : a.storage.get_error() == b.unwrap_err();
+        }
+
+        template <typename U>
+            requires (!detail::result_type<U>) && (!detail::err_type<U>)
+        friend constexpr auto operator==(const result &a, const U &value) -> bool {
+            return a.is_ok() && a.storage.get() == value;
+        }
+
+        template <typename G>
+        friend constexpr auto operator==(const result &a, const err_t<G> &error) -> bool {
+            return a.is_err() && a.storage.get_error() == error.error;
+        }
+
+    private:
+        storage_type storage;
+
+        constexpr explicit result(storage_type &&from) : storage(std::move(from)) {}
+
+        // A value of `T`, including when `T` is a reference.
+        template <typename U>
+        static constexpr auto from_value(U &&value) -> result {
+            return result(storage_type(std::in_place, slot_arg(std::forward<U>(value))));
+        }
+
+        // What the storage is built from: the address of a referenced value.
+        template <typename U>
+        static constexpr auto slot_arg(U &&value) noexcept -> decltype(auto) {
+            if constexpr (std::is_lvalue_reference_v<T>) {
+                return std::addressof(value);
+            } else {
+                return std::forward<U>(value);
+            }
+        }
+
+        template <typename X>
+        static constexpr auto from_expected(X &&expected) -> storage_type {
+            if (expected.has_value()) {
+                return storage_type(std::in_place, *std::forward<X>(expected));
+            }
+            return storage_type(std::unexpect, std::forward<X>(expected).error());
+        }
+    };
+
+    template <typename T, typename E>
+    result(std::expected<T, E>) -> result<T, E>;
+
+    // `option<T>` to `result<T, E>`: `some(v)` is `v`, and `none` is `error`.
+    //
+    // Arguments passed to `ok_or` are eagerly evaluated; use `ok_or_else` for an
+    // error that is costly to make. (The `ok_or` members return `std::expected`.)
+    template <typename O, typename E>
+        requires detail::option_type<O>
+    constexpr auto ok_or(O &&o, E &&error)
+        -> result<typename detail::option_payload<std::remove_cvref_t<O>>::type, std::remove_cvref_t<E>> {
+        using R = result<typename detail::option_payload<std::remove_cvref_t<O>>::type, std::remove_cvref_t<E>>;
+        if (o.is_some()) {
+            return R(*std::forward<O>(o));
+        }
+        return R(std::unexpect, std::forward<E>(error));
+    }
+
+    template <typename O, typename F>
+        requires detail::option_type<O>
+    constexpr auto ok_or_else(O &&o, F &&f) -> result<typename detail::option_payload<std::remove_cvref_t<O>>::type,
+                                                       std::remove_cvref_t<std::invoke_result_t<F>>> {
+        using R = result<typename detail::option_payload<std::remove_cvref_t<O>>::type,
+                         std::remove_cvref_t<std::invoke_result_t<F>>>;
+        if (o.is_some()) {
+            return R(*std::forward<O>(o));
+        }
+        return R(std::unexpect, std::invoke(std::forward<F>(f)));
+    }
+} // namespace opt
+
+#pragma pop_macro("cpp20_no_unique_address")
+
+#endif
@@ -0,0 +1,193 @@
+#ifndef OPT_OPTION_SLOT_POOL_HPP
+#define OPT_OPTION_SLOT_POOL_HPP
+
+// A pool of values addressed by generation-checked handles (a "slot map").
+//
+// `opt::slot_pool<T>` stores its values in one dense, contiguous array and hands
+// out `handle{ index, generation }`s that stay valid while other values come and
+// go. Erasing a value bumps the generation of its slot, so every handle to it
+// resolves to `none` afterwards, even once the slot is reused:
+//
+//     opt::slot_pool<entity> entities;
+//     auto h = entities.emplace(42);
+//     entities.get(h).map(&entity::id); // some(42)
+//     entities.erase(h);                // some(entity{ 42 })
+//     entities.get(h);                  // none
+//
+// `insert`, `emplace`, `erase` and `get` are O(1). Slots are recycled through a
+// free list and erasing moves the last value into the hole, so the values stay
+// packed and `begin`/`end` iterate only live ones. Nothing allocates once
+// `reserve` has made room. `get` returns `option<T &>`, which is a single
+// pointer; like any reference into the pool, it is invalidated by the next
+// `insert`, `emplace` or `erase`.
+
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <utility>
+#include <vector>
+
+#include "option.hpp"
+
+namespace opt {
+    template <typename T>
+    class slot_pool {
+    public:
+        using value_type = T;
+        using iterator = typename std::vector<T>::iterator;
+        using const_iterator = typename std::vector<T>::const_iterator;
+
+        // Names a slot of a pool. A default-constructed handle names nothing.
+        struct handle {
+            std::uint32_t index = std::numeric_limits<std::uint32_t>::max();
+            std::uint32_t generation = 0;
+
+            friend constexpr auto operator==(handle, handle) noexcept -> bool = default;
+        };
+
+        constexpr slot_pool() = default;
+
+        // Constructs a value in place and returns its handle.
+        // The value is constructed last: if an allocation or its constructor
+        // throws, the pool is left as it was, give or take a new free slot.
+        template <typename... Args>
+            requires std::constructible_from<T, Args...>
+        constexpr auto emplace(Args &&...args) -> handle {
+            if (free_head == no_slot) {
+                slots.push_back(slot{ 0, no_slot });
+                free_head = static_cast<std::uint32_t>(slots.size() - 1);
+            }
+            if (owners.size() == owners.capacity()) {
+                owners.reserve(owners.empty() ? 8 : owners.size() * 2);
+            }
+            values.emplace_back(std::forward<Args>(args)...);
+            const std::uint32_t owner = free_head;
+            slot &s = slots[owner];
+            owners.push_back(owner);
+            free_head = s.index;
+            s.index = static_cast<std::uint32_t>(values.size() - 1);
+            ++s.generation;
+            return handle{ owner, s.generation };
+        }
+
+        constexpr auto insert(const T &value) -> handle {
+            return emplace(value);
+        }
+
+        constexpr auto insert(T &&value) -> handle {
+            return emplace(std::move(value));
+        }
+
+        // Returns the value `h` names, or `none` if it was erased.
+        constexpr auto get(handle h) noexcept -> option<T &> {
+            if (contains(h)) [[likely]] {
+                return option<T &>{ values[slots[h.index].index] };
+            }
+            return option<T &>{};
+        }
+
+        constexpr auto get(handle h) const noexcept -> option<const T &> {
+            if (contains(h)) [[likely]] {
+                return option<const T &>{ values[slots[h.index].index] };
+            }
+            return option<const T &>{};
+        }
+
+        // Only live slots have an odd generation, so a handle that matches a free
+        // slot (forged, or stale after the generation wrapped around) is rejected.
+        constexpr auto contains(handle h) const noexcept -> bool {
+            return h.index < slots.size() && (h.generation & 1) != 0 && slots[h.index].generation == h.generation;
+        }
+
+        // Removes the value `h` names and returns it, or `none` if it was erased.
+        constexpr auto erase(handle h) -> option<T> {
+            if (!contains(h)) {
+                return option<T>{};
+            }
+            slot &s = slots[h.index];
+            const std::uint32_t position = s.index;
+            option<T> erased{ std::move(values[position]) };
+            if (position + 1 != values.size()) {
+                values[position] = std::move(values.back());
+                owners[position] = owners.back();
+                slots[owners[position]].index = position;
+            }
+            values.pop_back();
+            owners.pop_back();
+            ++s.generation;
+            s.index = free_head;
+            free_head = h.index;
+            return erased;
+        }
+
+        // Erases every value. All handles handed out so far resolve to `none`.
+        constexpr void clear() noexcept {
+            for (const std::uint32_t owner : owners) {
+                slot &s = slots[owner];
+                ++s.generation;
+                s.index = free_head;
+                free_head = owner;
+            }
+            values.clear();
+            owners.clear();
+        }
+
+        // Makes room for `n` values, so that inserting up to `n` does not allocate.
+        constexpr void reserve(std::size_t n) {
+            values.reserve(n);
+            owners.reserve(n);
+            slots.reserve(n);
+        }
+
+        constexpr auto size() const noexcept -> std::size_t {
+            return values.size();
+        }
+
+        constexpr auto empty() const noexcept -> bool {
+            return values.empty();
+        }
+
+        // The handle of the value at `it`, for code that iterates the values.
+        constexpr auto handle_of(const_iterator it) const noexcept -> handle {
+            const std::uint32_t owner = owners[static_cast<std::size_t>(it - values.begin())];
+            return handle{ owner, slots[owner].generation };
+        }
+
+        // The live values, packed, in no particular order.
+        constexpr auto begin() noexcept -> iterator {
+            return values.begin();
+        }
+
+        constexpr auto begin() const noexcept -> const_iterator {
+            return values.begin();
+        }
+
+        constexpr auto end() noexcept -> iterator {
+            return values.end();
+        }
+
+        constexpr auto end() const noexcept -> const_iterator {
+            return values.end();
+        }
+
+    private:
+        static constexpr std::uint32_t no_slot = std::numeric_limits<std::uint32_t>::max();
+
+        // `index` is the position of the value while the slot is live, and the
+        // next free slot while it is not. The generation is odd while it is live
+        // and even while it is free; it goes up by one on every change.
+        struct slot {
+            std::uint32_t generation;
+            std::uint32_t index;
+        };
+
+        std::vector<T> values;
+        // The slot of each value, parallel to `values`.
+        std::vector<std::uint32_t> owners;
+        std::vector<slot> slots;
+        std::uint32_t free_head = no_slot;
+    };
+} // namespace opt
+
+#endif
@@ -0,0 +1,257 @@
+#ifndef OPT_OPTION_STATS_HPP
+#define OPT_OPTION_STATS_HPP
+
+// Opt-in runtime statistics for `option<T>`.
+//
+// Compile with `OPT_OPTION_STATS=1` and every `option<T>` counts, per `T`, how
+// often its payload is copied, moved, cloned, emplaced and reset, how many times
+// `unwrap`/`expect` panicked, and how many presence checks (`is_some`) it answered
+// and how many of those found no value. `opt::stats::dump()` prints a report.
+//
+// Events are first counted in plain thread-local counters and folded into the
+// per-type relaxed atomics every `flush_interval` events, when the thread exits,
+// and when that thread calls `snapshot()`/`dump()`. Counts of other threads that
+// are still running may therefore lag behind by less than `flush_interval` each.
+//
+// With the switch off (the default) `option.hpp` does not include this header and
+// the hooks expand to nothing.
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <format>
+#include <source_location>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <vector>
+
+namespace opt::stats {
+    enum class event : std::uint8_t {
+        copy,
+        move,
+        clone,
+        emplace,
+        reset,
+        panic,
+        check,
+        check_none,
+    };
+
+    inline constexpr std::size_t event_count = 8;
+
+    inline constexpr std::uint32_t flush_interval = 256;
+
+    struct type_stats {
+        std::string_view type_name;
+        std::array<std::uint64_t, event_count> counts{};
+
+        constexpr auto operator[](event e) const noexcept -> std::uint64_t {
+            return counts[static_cast<std::size_t>(e)];
+        }
+
+        // Fraction of presence checks that found no value.
+        constexpr auto none_ratio() const noexcept -> double {
+            const auto checks = (*this)[event::check];
+            return checks == 0 ? 0.0 : static_cast<double>((*this)[event::check_none]) / static_cast<double>(checks);
+        }
+    };
+
+    namespace detail {
+        // Extracts `T` from the signature of this function as spelled by the
+        // compiler, e.g. `... type_name() [with T = int; ...]` (GCC),
+        // `... type_name() [T = int]` (Clang) or `... type_name<int>(void)` (MSVC).
+        template <typename T>
+        constexpr auto type_name() noexcept -> std::string_view {
+            const std::string_view fn = std::source_location::current().function_name();
+
+            if (const auto pos = fn.find("T = "); pos != std::string_view::npos) {
+                const auto start = pos + 4;
+                auto end         = fn.find("; ", start);
+                if (end == std::string_view::npos) {
+                    end = fn.rfind(']');
+                }
+                return fn.substr(start, end - start);
+            }
+
+            if (const auto pos = fn.find("type_name<"); pos != std::string_view::npos) {
+                const auto start = pos + 10;
+                const auto end   = fn.rfind(">(");
+                return fn.substr(start, end - start);
+            }
+
+            return fn;
+        }
+
+        struct type_record {
+            std::string_view name;
+            std::array<std::atomic<std::uint64_t>, event_count> counts{};
+            type_record *next = nullptr;
+
+            explicit type_record(std::string_view name) noexcept;
+        };
+
+        inline std::atomic<type_record *> registry_head{ nullptr };
+
+        inline type_record::type_record(std::string_view name) noexcept : name{ name } {
+            next = registry_head.load(std::memory_order_relaxed);
+            while (!registry_head.compare_exchange_weak(next, this, std::memory_order_release,
+                                                        std::memory_order_relaxed)) {
+            }
+        }
+
+        template <typename T>
+        auto record_for() noexcept -> type_record & {
+            static type_record record{ type_name<T>() };
+            return record;
+        }
+
+        struct local_counts;
+
+        inline thread_local local_counts *local_head = nullptr;
+
+        // Per-thread, per-type counters. Every instance of the calling thread is
+        // linked into `local_head` so that `flush_this_thread` can reach them.
+        struct local_counts {
+            type_record *record;
+            std::array<std::uint64_t, event_count> counts{};
+            std::uint32_t pending = 0;
+            local_counts *next;
+
+            explicit local_counts(type_record &record) noexcept;
+
+            local_counts(const local_counts &)            = delete;
+            local_counts &operator=(const local_counts &) = delete;
+
+            ~local_counts() {
+                flush();
+                if (local_head == this) {
+                    local_head = next;
+                }
+            }
+
+            void flush() noexcept {
+                for (std::size_t i = 0; i < event_count; ++i) {
+                    if (counts[i] != 0) {
+                        record->counts[i].fetch_add(counts[i], std::memory_order_relaxed);
+                        counts[i] = 0;
+                    }
+                }
+                pending = 0;
+            }
+        };
+
+        inline local_counts::local_counts(type_record &record) noexcept : record{ &record }, next{ local_head } {
+            local_head = this;
+        }
+
+        inline void flush_this_thread() noexcept {
+            for (auto *local = local_head; local != nullptr; local = local->next) {
+                local->flush();
+            }
+        }
+
+        template <typename T>
+        void record_runtime(event e) noexcept {
+            thread_local local_counts local{ record_for<std::remove_cv_t<T>>() };
+            ++local.counts[static_cast<std::size_t>(e)];
+            if (++local.pending == flush_interval) {
+                local.flush();
+            }
+        }
+
+        template <typename T>
+        constexpr void record(event e) noexcept {
+            if !consteval {
+                record_runtime<T>(e);
+            }
+        }
+
+        template <typename T>
+        constexpr auto record_check(bool some) noexcept -> bool {
+            record<T>(event::check);
+            if (!some) {
+                record<T>(event::check_none);
+            }
+            return some;
+        }
+
+        // Constructing an `option<T>` from a `T` copies or moves the payload.
+        template <typename T, typename U>
+        constexpr void record_value() noexcept {
+            if constexpr (std::is_same_v<std::remove_cvref_t<U>, std::remove_cv_t<T>>) {
+                if constexpr (std::is_lvalue_reference_v<U>) {
+                    record<T>(event::copy);
+                } else {
+                    record<T>(event::move);
+                }
+            }
+        }
+    } // namespace detail
+
+    // Returns the counts of every `T` that recorded at least one event, sorted by
+    // the number of copies (most first). Flushes the calling thread's counters.
+    inline auto snapshot() -> std::vector<type_stats> {
+        detail::flush_this_thread();
+
+        std::vector<type_stats> result;
+        for (auto *record = detail::registry_head.load(std::memory_order_acquire); record != nullptr;
+             record       = record->next) {
+            type_stats stats{ record->name };
+            for (std::size_t i = 0; i < event_count; ++i) {
+                stats.counts[i] = record->counts[i].load(std::memory_order_relaxed);
+            }
+            result.push_back(stats);
+        }
+
+        std::ranges::stable_sort(result, std::ranges::greater{}, [](const type_stats &s) { return s[event::copy]; });
+        return result;
+    }
+
+    // Returns the counts recorded for `T` so far. Flushes the calling thread's
+    // counters.
+    template <typename T>
+    auto snapshot_of() -> type_stats {
+        detail::flush_this_thread();
+
+        auto &record = detail::record_for<std::remove_cv_t<T>>();
+        type_stats stats{ record.name };
+        for (std::size_t i = 0; i < event_count; ++i) {
+            stats.counts[i] = record.counts[i].load(std::memory_order_relaxed);
+        }
+        return stats;
+    }
+
+    // Zeroes all counters. Counters still buffered by other running threads are
+    // not affected.
+    inline void reset() noexcept {
+        detail::flush_this_thread();
+
+        for (auto *record = detail::registry_head.load(std::memory_order_acquire); record != nullptr;
+             record       = record->next) {
+            for (auto &count : record->counts) {
+                count.store(0, std::memory_order_relaxed);
+            }
+        }
+    }
+
+    // Prints one line per type, most copied first.
+    inline void dump(std::FILE *out = stderr) {
+        const auto all = snapshot();
+
+        std::string report = std::format("{:<40} {:>10} {:>10} {:>10} {:>10} {:>10} {:>8} {:>12} {:>7}\n", "type",
+                                         "copies", "moves", "clones", "emplaces", "resets", "panics", "checks",
+                                         "none%");
+        for (const auto &s : all) {
+            report += std::format("{:<40} {:>10} {:>10} {:>10} {:>10} {:>10} {:>8} {:>12} {:>6.1f}%\n", s.type_name,
+                                  s[event::copy], s[event::move], s[event::clone], s[event::emplace], s[event::reset],
+                                  s[event::panic], s[event::check], s.none_ratio() * 100.0);
+        }
+        std::fputs(report.c_str(), out);
+    }
+} // namespace opt::stats
+
+#endif
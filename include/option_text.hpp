@@ -0,0 +1,274 @@
+#ifndef OPT_OPTION_TEXT_HPP
+#define OPT_OPTION_TEXT_HPP
+
+// Searches and splits on `std::string_view` that return `option` instead of
+// `npos`.
+//
+// Positions are `option<std::size_t>`, and the slices are views into the
+// input, never copies:
+//
+//     opt::text::find("key=value", '=');               // some(3)
+//     opt::text::split_once("key=value", '=');         // some({ "key", "value" })
+//     opt::text::strip_prefix("v1.2.3", "v");          // some("1.2.3")
+//     opt::text::find_any("a,b;c", ",;");              // some(1)
+//     auto [key, value] = opt::text::split_once(line, ':').unzip();
+//
+// `next_token` takes the next run of characters that are not delimiters off
+// the front of a view, as `strtok` does, and `opt::text::tokenizer` does so
+// as an `opt::iter` source, with its adaptors:
+//
+//     for (std::string_view word : opt::text::tokenizer{ line, " \t" }) { ... }
+//     opt::text::tokenizer{ csv_row, "," }.filter_map(parse_int).fold(0, std::plus{});
+//
+// Searching for one character, or for one of up to `simd_any_max` of them,
+// compares a whole vector register per step (SSE2 or AVX2 on x86), like
+// `opt::ranges::find`; longer sets use a 256-bit table. Everything is
+// `constexpr`, with the scalar loops at compile time, and nothing allocates.
+
+#include <array>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+#include <utility>
+
+#include "option.hpp"
+#include "option_iter.hpp"
+#include "option_ranges.hpp"
+
+namespace opt::text {
+    namespace detail {
+        // Up to this many delimiters, `find_any` compares a register against each.
+        inline constexpr std::size_t simd_any_max = 8;
+
+        // A set of bytes, as a bit per value.
+        class byte_set {
+        public:
+            constexpr explicit byte_set(std::string_view chars) noexcept {
+                for (const char c : chars) {
+                    const auto u = static_cast<unsigned char>(c);
+                    bits[u / 64] |= std::uint64_t{ 1 } << (u % 64);
+                }
+            }
+
+            constexpr auto contains(char c) const noexcept -> bool {
+                const auto u = static_cast<unsigned char>(c);
+                return ((bits[u / 64] >> (u % 64)) & 1) != 0;
+            }
+
+        private:
+            std::array<std::uint64_t, 4> bits{};
+        };
+
+        // The index of the first `c` in `s`, or `s.size()`.
+        constexpr auto index_of(std::string_view s, char c) noexcept -> std::size_t {
+#if OPT_OPTION_SIMD_X86
+            if !consteval {
+                return opt::detail::simd_find(s.data(), s.size(), c);
+            }
+#endif
+            for (std::size_t i = 0; i < s.size(); ++i) {
+                if (s[i] == c) {
+                    return i;
+                }
+            }
+            return s.size();
+        }
+
+#if OPT_OPTION_SIMD_X86
+        // The index of the first byte of `[p, p + n)` in `chars`, of which there
+        // are at most `simd_any_max`, or `n`.
+        inline auto simd_index_of_any(const char *p, std::size_t n, std::string_view chars,
+                                      const byte_set &set) noexcept -> std::size_t {
+            constexpr std::size_t lanes = opt::detail::simd_bytes;
+            // Not a `std::array`, which would drop the vector type's alignment attribute.
+            opt::detail::simd_vector needles[simd_any_max];
+            for (std::size_t k = 0; k < chars.size(); ++k) {
+                needles[k] = opt::detail::simd_splat(chars[k]);
+            }
+            std::size_t i = 0;
+            for (; i + lanes <= n; i += lanes) {
+                std::uint32_t mask = 0;
+                for (std::size_t k = 0; k < chars.size(); ++k) {
+                    mask |= opt::detail::simd_equal_bytes(p + i, needles[k]);
+                }
+                if (mask != 0) {
+                    return i + static_cast<std::size_t>(std::countr_zero(mask));
+                }
+            }
+            for (; i < n; ++i) {
+                if (set.contains(p[i])) {
+                    return i;
+                }
+            }
+            return n;
+        }
+#endif
+
+        // The index of the first byte of `s` in `chars`, or `s.size()`.
+        constexpr auto index_of_any(std::string_view s, std::string_view chars, const byte_set &set) noexcept
+            -> std::size_t {
+            if (chars.size() == 1) {
+                return index_of(s, chars[0]);
+            }
+#if OPT_OPTION_SIMD_X86
+            if !consteval {
+                if (chars.size() <= simd_any_max) {
+                    return simd_index_of_any(s.data(), s.size(), chars, set);
+                }
+            }
+#endif
+            for (std::size_t i = 0; i < s.size(); ++i) {
+                if (set.contains(s[i])) {
+                    return i;
+                }
+            }
+            return s.size();
+        }
+
+        constexpr auto position(std::size_t i, std::size_t n) noexcept -> option<std::size_t> {
+            return i == n ? option<std::size_t>{} : option<std::size_t>{ i };
+        }
+
+        constexpr auto split_at(std::string_view s, std::size_t i, std::size_t gap) noexcept
+            -> option<std::pair<std::string_view, std::string_view>> {
+            return option<std::pair<std::string_view, std::string_view>>{
+                std::pair{ s.substr(0, i), s.substr(i + gap) }
+            };
+        }
+
+        constexpr auto next_token(std::string_view &rest, std::string_view delimiters, const byte_set &set) noexcept
+            -> option<std::string_view> {
+            std::size_t start = 0;
+            while (start < rest.size() && set.contains(rest[start])) {
+                ++start;
+            }
+            if (start == rest.size()) {
+                rest = rest.substr(rest.size());
+                return option<std::string_view>{};
+            }
+            rest.remove_prefix(start);
+            const std::size_t end = index_of_any(rest, delimiters, set);
+            const std::string_view token = rest.substr(0, end);
+            rest.remove_prefix(end);
+            return option<std::string_view>{ token };
+        }
+    } // namespace detail
+
+    // The index of the first `c` in `s`.
+    constexpr auto find(std::string_view s, char c) noexcept -> option<std::size_t> {
+        return detail::position(detail::index_of(s, c), s.size());
+    }
+
+    // The index of the first occurrence of `needle` in `s`; `some(0)` for an
+    // empty `needle`. Candidates are found by searching for its first character.
+    constexpr auto find(std::string_view s, std::string_view needle) noexcept -> option<std::size_t> {
+        if (needle.empty()) {
+            return option<std::size_t>{ 0 };
+        }
+        for (std::size_t from = 0; from + needle.size() <= s.size();) {
+            const std::size_t last_start = s.size() - needle.size();
+            const std::size_t i = from + detail::index_of(s.substr(from, last_start - from + 1), needle[0]);
+            if (i > last_start) {
+                break;
+            }
+            if (s.substr(i + 1, needle.size() - 1) == needle.substr(1)) {
+                return option<std::size_t>{ i };
+            }
+            from = i + 1;
+        }
+        return option<std::size_t>{};
+    }
+
+    // The index of the last `c` in `s`.
+    constexpr auto rfind(std::string_view s, char c) noexcept -> option<std::size_t> {
+        for (std::size_t i = s.size(); i > 0; --i) {
+            if (s[i - 1] == c) {
+                return option<std::size_t>{ i - 1 };
+            }
+        }
+        return option<std::size_t>{};
+    }
+
+    // The index of the first character of `s` that is one of `chars`.
+    constexpr auto find_any(std::string_view s, std::string_view chars) noexcept -> option<std::size_t> {
+        return detail::position(detail::index_of_any(s, chars, detail::byte_set{ chars }), s.size());
+    }
+
+    // The parts of `s` before and after the first `c`, which is in neither.
+    constexpr auto split_once(std::string_view s, char c) noexcept
+        -> option<std::pair<std::string_view, std::string_view>> {
+        const std::size_t i = detail::index_of(s, c);
+        return i == s.size() ? option<std::pair<std::string_view, std::string_view>>{} : detail::split_at(s, i, 1);
+    }
+
+    constexpr auto split_once(std::string_view s, std::string_view separator) noexcept
+        -> option<std::pair<std::string_view, std::string_view>> {
+        const option<std::size_t> i = find(s, separator);
+        return i.is_some() ? detail::split_at(s, *i, separator.size())
+                           : option<std::pair<std::string_view, std::string_view>>{};
+    }
+
+    // The parts of `s` before and after the last `c`.
+    constexpr auto rsplit_once(std::string_view s, char c) noexcept
+        -> option<std::pair<std::string_view, std::string_view>> {
+        const option<std::size_t> i = rfind(s, c);
+        return i.is_some() ? detail::split_at(s, *i, 1) : option<std::pair<std::string_view, std::string_view>>{};
+    }
+
+    // `s` without `prefix`, if it starts with it.
+    constexpr auto strip_prefix(std::string_view s, std::string_view prefix) noexcept -> option<std::string_view> {
+        return s.starts_with(prefix) ? option<std::string_view>{ s.substr(prefix.size()) } : option<std::string_view>{};
+    }
+
+    constexpr auto strip_prefix(std::string_view s, char prefix) noexcept -> option<std::string_view> {
+        return s.starts_with(prefix) ? option<std::string_view>{ s.substr(1) } : option<std::string_view>{};
+    }
+
+    // `s` without `suffix`, if it ends with it.
+    constexpr auto strip_suffix(std::string_view s, std::string_view suffix) noexcept -> option<std::string_view> {
+        return s.ends_with(suffix) ? option<std::string_view>{ s.substr(0, s.size() - suffix.size()) }
+                                   : option<std::string_view>{};
+    }
+
+    constexpr auto strip_suffix(std::string_view s, char suffix) noexcept -> option<std::string_view> {
+        return s.ends_with(suffix) ? option<std::string_view>{ s.substr(0, s.size() - 1) } : option<std::string_view>{};
+    }
+
+    // Skips the `delimiters` at the front of `rest`, then takes the characters
+    // up to the next one (or the end) off it. `none`, with `rest` left empty,
+    // once only delimiters are left.
+    constexpr auto next_token(std::string_view &rest, std::string_view delimiters) noexcept
+        -> option<std::string_view> {
+        return detail::next_token(rest, delimiters, detail::byte_set{ delimiters });
+    }
+
+    // The tokens of a view, split on any of a set of delimiters, as a source:
+    // `next()` is `next_token`. Empty tokens are skipped.
+    class tokenizer : public iter::pull {
+    public:
+        constexpr tokenizer(std::string_view text, std::string_view delimiters) noexcept
+            : rest(text), delimiters(delimiters), set(delimiters) {}
+
+        constexpr auto next() noexcept -> option<std::string_view> {
+            return detail::next_token(rest, delimiters, set);
+        }
+
+        // Tokens are at least one character and are separated by one.
+        constexpr auto size_hint() const noexcept -> iter::size_bounds {
+            return { 0, option<std::size_t>{ (rest.size() + 1) / 2 } };
+        }
+
+        // The text after the last token returned.
+        constexpr auto remaining() const noexcept -> std::string_view {
+            return rest;
+        }
+
+    private:
+        std::string_view rest;
+        std::string_view delimiters;
+        detail::byte_set set;
+    };
+} // namespace opt::text
+
+#endif
@@ -0,0 +1,633 @@
+#ifndef OPT_OPTION_TS_HPP
+#define OPT_OPTION_TS_HPP
+
+// Time-series kernels for columns with gaps.
+//
+// The fills in `opt::ts` replace runs of `none`s, the gaps:
+//
+//     std::vector<opt::option<double>> bid{ opt::none, 1.0, opt::none, opt::none, 4.0, opt::none };
+//     opt::ts::ffilled(bid);        // none, 1, 1, 1, 4, 4
+//     opt::ts::bfilled(bid);        // 1, 1, 4, 4, 4, none
+//     opt::ts::interpolated(bid);   // none, 1, 2, 3, 4, none
+//     opt::ts::ffilled(bid, 1);     // none, 1, 1, none, 4, 4
+//     opt::ts::fill_with(bid, 0.0); // in place: 0, 1, 0, 0, 4, 0
+//
+// `ffill` carries the last value forward and `bfill` the next one backward.
+// `interpolate` draws a line between the values around a gap, so gaps at
+// either end stay. With a `limit`, at most that many rows of each gap are
+// filled, nearest to the value they are filled from. `ffill`, `bfill`,
+// `fill_with` and `interpolate` work in place; `ffilled`, `bfilled`,
+// `filled_with` and `interpolated` return a filled copy.
+//
+// Each kernel works on contiguous ranges of `option<T>` and on
+// `opt::masked_column<T>`. Both are scanned 64 rows at a time: a word with a
+// bit per present row, read from the validity bitmap or gathered from the
+// presence flags, is skipped when it is full, and otherwise its gaps are found
+// with bit scans. The fills then write whole runs.
+//
+// `rolling_sum`, `rolling_mean`, `rolling_min`, `rolling_max` and
+// `rolling_count` aggregate the last `window` rows at each row, in amortized
+// O(1) per row: sums are kept running, and minima and maxima come from a
+// monotonic queue. `rolling_window<T>` does the same for rows pushed one at a
+// time.
+
+#include <algorithm>
+#include <bit>
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <ranges>
+#include <span>
+#include <type_traits>
+#include <vector>
+
+#include "option.hpp"
+#include "option_masked_column.hpp"
+
+namespace opt::ts {
+    namespace detail {
+        template <typename R>
+        concept option_column = std::ranges::contiguous_range<R> && std::ranges::sized_range<R>
+                             && opt::detail::option_type<std::ranges::range_value_t<R>>;
+
+        template <typename R>
+        concept mutable_option_column
+            = option_column<R> && !std::is_const_v<std::remove_reference_t<std::ranges::range_reference_t<R>>>;
+
+        template <typename R>
+        using column_payload = typename std::ranges::range_value_t<R>::value_type;
+
+        inline constexpr std::size_t word_bits = 64;
+
+        // Calls `f(begin, end)` for each maximal run of rows `[begin, end)` that
+        // are `none`, in order. `word_of(w)` is the presence mask of rows
+        // `[64 * w, 64 * w + 64)`; its bits past `n` are ignored.
+        template <typename WordOf, typename F>
+        void for_each_gap(std::size_t n, WordOf word_of, F f) {
+            const std::size_t words = (n + word_bits - 1) / word_bits;
+            bool in_gap = false;
+            std::size_t gap = 0;
+            for (std::size_t w = 0; w < words; ++w) {
+                std::uint64_t present = word_of(w);
+                if (w + 1 == words && n % word_bits != 0) {
+                    present |= ~std::uint64_t{ 0 } << (n % word_bits);
+                }
+                if (!in_gap && present == ~std::uint64_t{ 0 }) [[likely]] {
+                    continue;
+                }
+                for (std::size_t bit = 0; bit < word_bits;) {
+                    // While in a gap, look for the next present row, else for the
+                    // next missing one.
+                    const std::uint64_t rest = (in_gap ? present : ~present) >> bit;
+                    if (rest == 0) {
+                        break;
+                    }
+                    bit += static_cast<std::size_t>(std::countr_zero(rest));
+                    if (in_gap) {
+                        f(gap, w * word_bits + bit);
+                    } else {
+                        gap = w * word_bits + bit;
+                    }
+                    in_gap = !in_gap;
+                }
+            }
+            if (in_gap) {
+                f(gap, n);
+            }
+        }
+
+        // Access to a column of `option<T>`s for the fills.
+        template <typename T>
+        struct option_cells {
+            std::span<option<T>> cells;
+
+            auto size() const noexcept -> std::size_t {
+                return cells.size();
+            }
+
+            // Gathers the presence flags, without branches.
+            auto word(std::size_t w) const noexcept -> std::uint64_t {
+                const std::size_t begin = w * word_bits;
+                const std::size_t count = std::min(word_bits, cells.size() - begin);
+                std::uint64_t present = 0;
+                for (std::size_t j = 0; j < count; ++j) {
+                    present |= static_cast<std::uint64_t>(cells[begin + j].is_some()) << j;
+                }
+                return present;
+            }
+
+            auto value(std::size_t i) const noexcept -> const T & {
+                return *cells[i];
+            }
+
+            // Sets rows `[begin, end)` to `make(i)`.
+            template <typename Make>
+            void fill(std::size_t begin, std::size_t end, Make make) {
+                for (std::size_t i = begin; i < end; ++i) {
+                    cells[i] = option<T>{ make(i) };
+                }
+            }
+        };
+
+        template <typename T>
+        struct masked_cells {
+            masked_column<T> &column;
+
+            auto size() const noexcept -> std::size_t {
+                return column.size();
+            }
+
+            auto word(std::size_t w) const noexcept -> std::uint64_t {
+                return column.validity()[w];
+            }
+
+            auto value(std::size_t i) const noexcept -> const T & {
+                return column.values()[i];
+            }
+
+            template <typename Make>
+            void fill(std::size_t begin, std::size_t end, Make make) {
+                const std::span<T> values = column.values();
+                for (std::size_t i = begin; i < end; ++i) {
+                    values[i] = make(i);
+                }
+                const std::span<std::uint64_t> validity = column.validity();
+                for (std::size_t w = begin / word_bits; w * word_bits < end; ++w) {
+                    const std::size_t lo = std::max(begin, w * word_bits) - w * word_bits;
+                    const std::size_t hi = std::min(end, (w + 1) * word_bits) - w * word_bits;
+                    const std::uint64_t ones = hi - lo == word_bits ? ~std::uint64_t{ 0 }
+                                                                    : ((std::uint64_t{ 1 } << (hi - lo)) - 1) << lo;
+                    validity[w] |= ones;
+                }
+            }
+        };
+
+        template <typename R>
+        auto cells_of(R &column) {
+            if constexpr (opt::detail::specialization_of<std::remove_const_t<R>, masked_column>) {
+                return masked_cells<typename R::value_type>{ column };
+            } else {
+                return option_cells<column_payload<R>>{ std::span<option<column_payload<R>>>{ column } };
+            }
+        }
+
+        template <typename Cells>
+        void ffill(Cells cells, std::size_t limit) {
+            for_each_gap(cells.size(), [&](std::size_t w) { return cells.word(w); },
+                         [&](std::size_t begin, std::size_t end) {
+                             if (begin != 0) {
+                                 const auto last = cells.value(begin - 1);
+                                 cells.fill(begin, begin + std::min(end - begin, limit),
+                                            [&](std::size_t) { return last; });
+                             }
+                         });
+        }
+
+        template <typename Cells>
+        void bfill(Cells cells, std::size_t limit) {
+            for_each_gap(cells.size(), [&](std::size_t w) { return cells.word(w); },
+                         [&](std::size_t begin, std::size_t end) {
+                             if (end != cells.size()) {
+                                 const auto next = cells.value(end);
+                                 cells.fill(end - std::min(end - begin, limit), end, [&](std::size_t) { return next; });
+                             }
+                         });
+        }
+
+        template <typename Cells, typename T>
+        void fill_with(Cells cells, const T &value) {
+            for_each_gap(cells.size(), [&](std::size_t w) { return cells.word(w); },
+                         [&](std::size_t begin, std::size_t end) {
+                             cells.fill(begin, end, [&](std::size_t) { return value; });
+                         });
+        }
+
+        template <typename Cells>
+        void interpolate(Cells cells, std::size_t limit) {
+            using T = std::remove_cvref_t<decltype(cells.value(0))>;
+            for_each_gap(cells.size(), [&](std::size_t w) { return cells.word(w); },
+                         [&](std::size_t begin, std::size_t end) {
+                             if (begin == 0 || end == cells.size()) {
+                                 return;
+                             }
+                             const T from = cells.value(begin - 1);
+                             const T step = (cells.value(end) - from) / static_cast<T>(end - begin + 1);
+                             cells.fill(begin, begin + std::min(end - begin, limit), [&](std::size_t i) {
+                                 return from + step * static_cast<T>(i - begin + 1);
+                             });
+                         });
+        }
+
+        constexpr auto limit_of(option<std::size_t> limit) noexcept -> std::size_t {
+            return limit.unwrap_or(std::numeric_limits<std::size_t>::max());
+        }
+    } // namespace detail
+
+    // Fills each gap with the value before it.
+    template <typename R>
+        requires detail::mutable_option_column<R>
+    void ffill(R &&column, option<std::size_t> limit = {}) {
+        detail::ffill(detail::cells_of(column), detail::limit_of(limit));
+    }
+
+    template <typename T>
+    void ffill(masked_column<T> &column, option<std::size_t> limit = {}) {
+        detail::ffill(detail::cells_of(column), detail::limit_of(limit));
+    }
+
+    // Fills each gap with the value after it.
+    template <typename R>
+        requires detail::mutable_option_column<R>
+    void bfill(R &&column, option<std::size_t> limit = {}) {
+        detail::bfill(detail::cells_of(column), detail::limit_of(limit));
+    }
+
+    template <typename T>
+    void bfill(masked_column<T> &column, option<std::size_t> limit = {}) {
+        detail::bfill(detail::cells_of(column), detail::limit_of(limit));
+    }
+
+    // Fills every gap with `value`.
+    template <typename R>
+        requires detail::mutable_option_column<R>
+    void fill_with(R &&column, const detail::column_payload<R> &value) {
+        detail::fill_with(detail::cells_of(column), value);
+    }
+
+    template <typename T>
+    void fill_with(masked_column<T> &column, const std::type_identity_t<T> &value) {
+        detail::fill_with(detail::cells_of(column), value);
+    }
+
+    // Fills each gap between two values on the line through them, by row
+    // position. Gaps at the start or end are left as they are.
+    template <typename R>
+        requires detail::mutable_option_column<R> && std::floating_point<detail::column_payload<R>>
+    void interpolate(R &&column, option<std::size_t> limit = {}) {
+        detail::interpolate(detail::cells_of(column), detail::limit_of(limit));
+    }
+
+    template <std::floating_point T>
+    void interpolate(masked_column<T> &column, option<std::size_t> limit = {}) {
+        detail::interpolate(detail::cells_of(column), detail::limit_of(limit));
+    }
+
+    // The copying versions, which return a `std::vector<option<T>>` for ranges
+    // and a `masked_column<T>` for masked columns.
+    namespace detail {
+        template <typename R>
+        auto copy_of(const R &column) {
+            if constexpr (opt::detail::specialization_of<R, masked_column>) {
+                return column;
+            } else {
+                return std::vector<option<column_payload<R>>>(std::ranges::begin(column), std::ranges::end(column));
+            }
+        }
+
+        template <typename R>
+        concept fillable = option_column<R> || opt::detail::specialization_of<R, masked_column>;
+    } // namespace detail
+
+    template <typename R>
+        requires detail::fillable<R>
+    auto ffilled(const R &column, option<std::size_t> limit = {}) {
+        auto copy = detail::copy_of(column);
+        ts::ffill(copy, limit);
+        return copy;
+    }
+
+    template <typename R>
+        requires detail::fillable<R>
+    auto bfilled(const R &column, option<std::size_t> limit = {}) {
+        auto copy = detail::copy_of(column);
+        ts::bfill(copy, limit);
+        return copy;
+    }
+
+    template <typename R, typename T>
+        requires detail::fillable<R>
+    auto filled_with(const R &column, const T &value) {
+        auto copy = detail::copy_of(column);
+        ts::fill_with(copy, value);
+        return copy;
+    }
+
+    template <typename R>
+        requires detail::fillable<R>
+    auto interpolated(const R &column, option<std::size_t> limit = {}) {
+        auto copy = detail::copy_of(column);
+        ts::interpolate(copy, limit);
+        return copy;
+    }
+
+    // Rolling windows: the aggregates of the last `window` rows at each row.
+    // `none`s take up a place in the window but are left out of the aggregate,
+    // and a window with fewer than `min_periods` values has a `none` aggregate.
+    namespace detail {
+        // `SUM` of `T`: the widest integer of the same signedness, or `double`.
+        template <typename T>
+        using window_sum_t = std::conditional_t<std::floating_point<T>, double,
+                                                std::conditional_t<std::is_signed_v<T>, long long, unsigned long long>>;
+
+        template <typename T>
+        concept windowable = std::is_arithmetic_v<T> && !std::same_as<T, bool>;
+
+        // A sum that values are added to and removed from. Floating-point sums
+        // carry a Neumaier compensation, so the error does not grow with the
+        // number of rows that passed through the window.
+        template <typename T>
+        class running_sum {
+        public:
+            using value_type = window_sum_t<T>;
+
+            constexpr void add(T value) noexcept {
+                if constexpr (std::floating_point<T>) {
+                    compensated(static_cast<double>(value));
+                } else {
+                    total += static_cast<value_type>(value);
+                }
+            }
+
+            constexpr void remove(T value) noexcept {
+                if constexpr (std::floating_point<T>) {
+                    compensated(-static_cast<double>(value));
+                } else {
+                    total -= static_cast<value_type>(value);
+                }
+            }
+
+            constexpr void clear() noexcept {
+                total = 0;
+                compensation = 0;
+            }
+
+            constexpr auto value() const noexcept -> value_type {
+                return total + compensation;
+            }
+
+        private:
+            value_type total = 0;
+            value_type compensation = 0;
+
+            constexpr void compensated(double value) noexcept {
+                const double sum = total + value;
+                const bool larger = (total < 0 ? -total : total) >= (value < 0 ? -value : value);
+                compensation += larger ? (total - sum) + value : (value - sum) + total;
+                total = sum;
+            }
+        };
+
+        // The values of the window in the order they came, dropping each one
+        // that a later value beats: the front is the window's min (or max).
+        // Amortized O(1) per row, in a ring of at least `window` entries.
+        template <typename T, typename Compare>
+        class monotonic_queue {
+        public:
+            explicit monotonic_queue(std::size_t window) : entries(std::bit_ceil(window)), mask(entries.size() - 1) {}
+
+            void push(std::size_t position, const T &value) {
+                while (count != 0 && !Compare{}(back().value, value)) {
+                    --count;
+                }
+                entries[(head + count) & mask] = entry{ position, value };
+                ++count;
+            }
+
+            // Drops the values at positions before `oldest`.
+            void expire(std::size_t oldest) noexcept {
+                while (count != 0 && entries[head].position < oldest) {
+                    head = (head + 1) & mask;
+                    --count;
+                }
+            }
+
+            auto front() const -> option<T> {
+                return count != 0 ? option<T>{ entries[head].value } : option<T>{};
+            }
+
+            void clear() noexcept {
+                head = 0;
+                count = 0;
+            }
+
+        private:
+            struct entry {
+                std::size_t position = 0;
+                T value{};
+            };
+
+            std::vector<entry> entries;
+            std::size_t mask;
+            std::size_t head = 0;
+            std::size_t count = 0;
+
+            auto back() const noexcept -> const entry & {
+                return entries[(head + count - 1) & mask];
+            }
+        };
+
+        inline auto checked_window(std::size_t window) -> std::size_t {
+            if (window == 0) {
+                throw option_panic("opt::ts: the window must hold at least one row");
+            }
+            return window;
+        }
+
+        template <typename R>
+        concept window_column = std::ranges::random_access_range<R> && std::ranges::sized_range<R>
+                             && opt::detail::option_type<std::ranges::range_value_t<R>>
+                             && windowable<column_payload<R>>;
+
+        // Calls `f(i, count, sum)` for each row `i`, with the number and sum of
+        // the values in the window that ends at it.
+        template <typename R, typename F>
+        void for_each_window_sum(const R &column, std::size_t window, F f) {
+            checked_window(window);
+            using T = column_payload<R>;
+            running_sum<T> sum;
+            std::size_t count = 0;
+            const std::size_t n = std::ranges::size(column);
+            const auto first = std::ranges::begin(column);
+            for (std::size_t i = 0; i < n; ++i) {
+                if (const auto &in = first[static_cast<std::ranges::range_difference_t<R>>(i)]; in.is_some()) {
+                    sum.add(*in);
+                    ++count;
+                }
+                if (i >= window) {
+                    if (const auto &out = first[static_cast<std::ranges::range_difference_t<R>>(i - window)];
+                        out.is_some()) {
+                        sum.remove(*out);
+                        if (--count == 0) {
+                            sum.clear();
+                        }
+                    }
+                }
+                f(i, count, sum.value());
+            }
+        }
+
+        template <typename Compare, typename R>
+        auto rolling_extreme(const R &column, std::size_t window, std::size_t min_periods)
+            -> std::vector<option<column_payload<R>>> {
+            checked_window(window);
+            const std::size_t n = std::ranges::size(column);
+            std::vector<option<column_payload<R>>> result(n);
+            monotonic_queue<column_payload<R>, Compare> queue{ window };
+            std::size_t count = 0;
+            const auto first = std::ranges::begin(column);
+            for (std::size_t i = 0; i < n; ++i) {
+                // Expiring first keeps at most `window` values in the queue.
+                if (i >= window) {
+                    count -= first[static_cast<std::ranges::range_difference_t<R>>(i - window)].is_some();
+                    queue.expire(i - window + 1);
+                }
+                if (const auto &in = first[static_cast<std::ranges::range_difference_t<R>>(i)]; in.is_some()) {
+                    queue.push(i, *in);
+                    ++count;
+                }
+                if (count >= min_periods && count != 0) {
+                    result[i] = queue.front();
+                }
+            }
+            return result;
+        }
+    } // namespace detail
+
+    // The number of values in each window.
+    template <typename R>
+        requires detail::window_column<R>
+    auto rolling_count(const R &column, std::size_t window) -> std::vector<std::size_t> {
+        std::vector<std::size_t> result(std::ranges::size(column));
+        detail::for_each_window_sum(column, window, [&](std::size_t i, std::size_t count, auto) { result[i] = count; });
+        return result;
+    }
+
+    template <typename R>
+        requires detail::window_column<R>
+    auto rolling_sum(const R &column, std::size_t window, std::size_t min_periods = 1)
+        -> std::vector<option<detail::window_sum_t<detail::column_payload<R>>>> {
+        std::vector<option<detail::window_sum_t<detail::column_payload<R>>>> result(std::ranges::size(column));
+        detail::for_each_window_sum(column, window, [&](std::size_t i, std::size_t count, auto sum) {
+            if (count >= min_periods && count != 0) {
+                result[i].insert(sum);
+            }
+        });
+        return result;
+    }
+
+    template <typename R>
+        requires detail::window_column<R>
+    auto rolling_mean(const R &column, std::size_t window, std::size_t min_periods = 1)
+        -> std::vector<option<double>> {
+        std::vector<option<double>> result(std::ranges::size(column));
+        detail::for_each_window_sum(column, window, [&](std::size_t i, std::size_t count, auto sum) {
+            if (count >= min_periods && count != 0) {
+                result[i].insert(static_cast<double>(sum) / static_cast<double>(count));
+            }
+        });
+        return result;
+    }
+
+    template <typename R>
+        requires detail::window_column<R>
+    auto rolling_min(const R &column, std::size_t window, std::size_t min_periods = 1)
+        -> std::vector<option<detail::column_payload<R>>> {
+        return detail::rolling_extreme<std::ranges::less>(column, window, min_periods);
+    }
+
+    template <typename R>
+        requires detail::window_column<R>
+    auto rolling_max(const R &column, std::size_t window, std::size_t min_periods = 1)
+        -> std::vector<option<detail::column_payload<R>>> {
+        return detail::rolling_extreme<std::ranges::greater>(column, window, min_periods);
+    }
+
+    // The same aggregates over a live stream: `push` each row as it arrives,
+    // then read the aggregates of the last `window` rows.
+    //
+    //     opt::ts::rolling_window<double> latency{ 100, 10 };
+    //     latency.push(sample);       // option<double>
+    //     latency.mean();             // none until 10 of the last 100 rows had a value
+    template <typename T>
+        requires detail::windowable<T>
+    class rolling_window {
+    public:
+        explicit rolling_window(std::size_t window, std::size_t min_periods = 1) :
+            recent(detail::checked_window(window)), least(window), greatest(window),
+            min_periods(std::max<std::size_t>(min_periods, 1)) {}
+
+        void push(const option<T> &value) {
+            option<T> &slot = recent[position % recent.size()];
+            if (slot.is_some()) {
+                total.remove(*slot);
+                if (--present == 0) {
+                    total.clear();
+                }
+            }
+            if (position >= recent.size()) {
+                least.expire(position - recent.size() + 1);
+                greatest.expire(position - recent.size() + 1);
+            }
+            slot = value;
+            if (value.is_some()) {
+                total.add(*value);
+                ++present;
+                least.push(position, *value);
+                greatest.push(position, *value);
+            }
+            ++position;
+        }
+
+        // Forgets every row pushed so far.
+        void clear() {
+            std::ranges::fill(recent, option<T>{});
+            total.clear();
+            least.clear();
+            greatest.clear();
+            present = 0;
+            position = 0;
+        }
+
+        // The number of values among the last `window` rows.
+        auto count() const noexcept -> std::size_t {
+            return present;
+        }
+
+        auto sum() const -> option<detail::window_sum_t<T>> {
+            return ready() ? option<detail::window_sum_t<T>>{ total.value() } : option<detail::window_sum_t<T>>{};
+        }
+
+        auto mean() const -> option<double> {
+            return ready() ? option<double>{ static_cast<double>(total.value()) / static_cast<double>(present) }
+                           : option<double>{};
+        }
+
+        auto min() const -> option<T> {
+            return ready() ? least.front() : option<T>{};
+        }
+
+        auto max() const -> option<T> {
+            return ready() ? greatest.front() : option<T>{};
+        }
+
+        auto window() const noexcept -> std::size_t {
+            return recent.size();
+        }
+
+    private:
+        std::vector<option<T>> recent;
+        detail::running_sum<T> total;
+        detail::monotonic_queue<T, std::ranges::less> least;
+        detail::monotonic_queue<T, std::ranges::greater> greatest;
+        std::size_t min_periods;
+        std::size_t present = 0;
+        std::size_t position = 0;
+
+        auto ready() const noexcept -> bool {
+            return present >= min_periods;
+        }
+    };
+} // namespace opt::ts
+
+#endif
@@ -2,7 +2,25 @@ export module option;
 
 export import :fwd;
 export import :panic;
+export import :core;
+export import :stats;
+export import :profiler;
 export import :storage;
 export import :none;
 export import :classes;
-export import :ops;
\ No newline at end of file
+export import :ops;
+export import :static_map;
+export import :memo_cache;
+export import :slot_pool;
+export import :ranges;
+export import :sort;
+export import :group_by;
+export import :hash_join;
+export import :masked_column;
+export import :ts;
+export import :kleene;
+export import :batch;
+export import :column_stats;
+export import :result;
+export import :iter;
+export import :text;
\ No newline at end of file
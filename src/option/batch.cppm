@@ -0,0 +1,673 @@
+module;
+
+// Gather with AVX2/AVX-512 masked gather instructions where available (see
+// option_batch.hpp).
+#ifndef OPT_OPTION_BATCH_GATHER
+    #define OPT_OPTION_BATCH_GATHER 0
+#endif
+
+#if OPT_OPTION_BATCH_GATHER && defined(__AVX2__)
+    #include <immintrin.h>
+#endif
+
+export module option:batch;
+
+import std;
+import :fwd;
+import :panic;
+import :classes;
+import :masked_column;
+
+export namespace opt::batch {
+    namespace detail {
+        template <typename T>
+        concept number = std::is_arithmetic_v<T> && !std::same_as<std::remove_cv_t<T>, bool>;
+
+        template <typename R>
+        concept option_column = std::ranges::contiguous_range<const R> && std::ranges::sized_range<const R>
+                             && opt::detail::option_type<std::ranges::range_value_t<R>>
+                             && number<typename std::ranges::range_value_t<R>::value_type>;
+
+        template <typename R>
+        using column_payload = typename std::ranges::range_value_t<R>::value_type;
+
+        // Integer arithmetic in an unsigned type at least as wide as `unsigned`,
+        // where it wraps (promotion would turn `uint16_t * uint16_t` into `int`).
+        template <typename T>
+        using wrapping = std::common_type_t<std::make_unsigned_t<T>, unsigned>;
+
+        // Each operation is total in `apply`, which any pair of values may be
+        // passed to, and `partial` ones say in `defined` when the result means
+        // something.
+        struct add_op {
+            static constexpr bool partial = false;
+
+            template <typename T>
+            static constexpr auto apply(T x, T y) noexcept -> T {
+                if constexpr (std::integral<T>) {
+                    return static_cast<T>(static_cast<wrapping<T>>(x) + static_cast<wrapping<T>>(y));
+                } else {
+                    return x + y;
+                }
+            }
+        };
+
+        struct sub_op {
+            static constexpr bool partial = false;
+
+            template <typename T>
+            static constexpr auto apply(T x, T y) noexcept -> T {
+                if constexpr (std::integral<T>) {
+                    return static_cast<T>(static_cast<wrapping<T>>(x) - static_cast<wrapping<T>>(y));
+                } else {
+                    return x - y;
+                }
+            }
+        };
+
+        struct mul_op {
+            static constexpr bool partial = false;
+
+            template <typename T>
+            static constexpr auto apply(T x, T y) noexcept -> T {
+                if constexpr (std::integral<T>) {
+                    return static_cast<T>(static_cast<wrapping<T>>(x) * static_cast<wrapping<T>>(y));
+                } else {
+                    return x * y;
+                }
+            }
+        };
+
+        struct div_op {
+            static constexpr bool partial = true;
+
+            template <typename T>
+            static constexpr auto defined(T x, T y) noexcept -> bool {
+                if constexpr (std::signed_integral<T>) {
+                    return (y != T{}) & ((x != std::numeric_limits<T>::min()) | (y != T(-1)));
+                } else {
+                    return y != T{};
+                }
+            }
+
+            template <typename T>
+            static constexpr auto apply(T x, T y) noexcept -> T {
+                return static_cast<T>(x / (defined(x, y) ? y : T{ 1 }));
+            }
+        };
+
+        struct min_op {
+            static constexpr bool partial = false;
+
+            template <typename T>
+            static constexpr auto apply(T x, T y) noexcept -> T {
+                return y < x ? y : x;
+            }
+        };
+
+        struct max_op {
+            static constexpr bool partial = false;
+
+            template <typename T>
+            static constexpr auto apply(T x, T y) noexcept -> T {
+                return x < y ? y : x;
+            }
+        };
+
+        struct abs_op {
+            static constexpr bool partial = true;
+
+            template <typename T>
+            static constexpr auto defined(T x) noexcept -> bool {
+                if constexpr (std::signed_integral<T>) {
+                    return x != std::numeric_limits<T>::min();
+                } else {
+                    return true;
+                }
+            }
+
+            template <typename T>
+            static constexpr auto apply(T x) noexcept -> T {
+                if constexpr (std::signed_integral<T>) {
+                    const auto u = static_cast<wrapping<T>>(x);
+                    return static_cast<T>(x < T{} ? wrapping<T>{} - u : u);
+                } else if constexpr (std::unsigned_integral<T>) {
+                    return x;
+                } else {
+                    return x < T{} ? -x : x;
+                }
+            }
+        };
+
+        // The operands of the kernels below: a column of `option<T>`, a masked
+        // column, or a scalar, which is present in every row.
+        template <typename T>
+        struct options_operand {
+            const option<T> *rows;
+
+            constexpr auto valid(std::size_t i) const noexcept -> bool {
+                return rows[i].is_some();
+            }
+
+            constexpr auto value(std::size_t i) const noexcept -> T {
+                return rows[i].unwrap_or(T{});
+            }
+        };
+
+        template <typename T>
+        struct masked_operand {
+            const T *values;
+            const std::uint64_t *words;
+
+            constexpr auto value(std::size_t i) const noexcept -> T {
+                return values[i];
+            }
+
+            constexpr auto word(std::size_t w) const noexcept -> std::uint64_t {
+                return words[w];
+            }
+        };
+
+        template <typename T>
+        struct scalar_operand {
+            T scalar;
+
+            constexpr auto valid(std::size_t) const noexcept -> bool {
+                return true;
+            }
+
+            constexpr auto value(std::size_t) const noexcept -> T {
+                return scalar;
+            }
+
+            constexpr auto word(std::size_t) const noexcept -> std::uint64_t {
+                return ~std::uint64_t{ 0 };
+            }
+        };
+
+        template <typename R>
+        constexpr auto options_of(const R &column) noexcept -> options_operand<column_payload<R>> {
+            return { std::ranges::data(column) };
+        }
+
+        template <typename T>
+        constexpr auto masked_of(const masked_column<T> &column) noexcept -> masked_operand<T> {
+            return { column.values().data(), column.validity().data() };
+        }
+
+        constexpr void check_lengths(std::size_t a, std::size_t b) {
+            if (a != b) {
+                throw option_panic("opt::batch: columns differ in length");
+            }
+        }
+
+        // `Op` over rows of `option<T>`, with a select instead of a branch per row.
+        template <typename Op, typename T, typename... Operands>
+        constexpr auto options_kernel(std::size_t n, const Operands &...operands) -> std::vector<option<T>> {
+            std::vector<option<T>> out(n);
+            for (std::size_t i = 0; i < n; ++i) {
+                bool valid = (operands.valid(i) & ...);
+                if constexpr (Op::partial) {
+                    valid &= Op::defined(operands.value(i)...);
+                }
+                out[i] = valid ? option<T>{ Op::apply(operands.value(i)...) } : option<T>{};
+            }
+            return out;
+        }
+
+        // `Op` over a masked column, a block of 64 rows at a time: the values of
+        // every row of the block, then its validity word, and last the values of
+        // the rows that ended up `none` are reset.
+        template <typename Op, typename T, typename... Operands>
+        constexpr auto masked_kernel(std::size_t n, const Operands &...operands) -> masked_column<T> {
+            constexpr std::size_t word_bits = masked_column<T>::word_bits;
+            masked_column<T> out(n);
+            T *const values = out.values().data();
+            std::uint64_t *const words = out.validity().data();
+            for (std::size_t w = 0, base = 0; base < n; ++w, base += word_bits) {
+                const std::size_t rows = std::min(word_bits, n - base);
+                const std::uint64_t live = rows < word_bits ? (std::uint64_t{ 1 } << rows) - 1 : ~std::uint64_t{ 0 };
+                for (std::size_t j = 0; j < rows; ++j) {
+                    values[base + j] = Op::apply(operands.value(base + j)...);
+                }
+                std::uint64_t word = (operands.word(w) & ...) & live;
+                if constexpr (Op::partial) {
+                    std::uint64_t defined = 0;
+                    for (std::size_t j = 0; j < rows; ++j) {
+                        defined |= static_cast<std::uint64_t>(Op::defined(operands.value(base + j)...)) << j;
+                    }
+                    word &= defined;
+                }
+                words[w] = word;
+                for (std::uint64_t gaps = ~word & live; gaps != 0; gaps &= gaps - 1) {
+                    values[base + static_cast<std::size_t>(std::countr_zero(gaps))] = T{};
+                }
+            }
+            return out;
+        }
+
+        template <typename Op>
+        struct binary_fn {
+            template <option_column A, option_column B>
+                requires std::same_as<column_payload<A>, column_payload<B>>
+            constexpr auto operator()(const A &a, const B &b) const -> std::vector<option<column_payload<A>>> {
+                check_lengths(std::ranges::size(a), std::ranges::size(b));
+                return options_kernel<Op, column_payload<A>>(std::ranges::size(a), options_of(a), options_of(b));
+            }
+
+            template <option_column A>
+            constexpr auto operator()(const A &a, std::type_identity_t<column_payload<A>> b) const
+                -> std::vector<option<column_payload<A>>> {
+                return options_kernel<Op, column_payload<A>>(std::ranges::size(a), options_of(a),
+                                                             scalar_operand<column_payload<A>>{ b });
+            }
+
+            template <option_column B>
+            constexpr auto operator()(std::type_identity_t<column_payload<B>> a, const B &b) const
+                -> std::vector<option<column_payload<B>>> {
+                return options_kernel<Op, column_payload<B>>(std::ranges::size(b),
+                                                             scalar_operand<column_payload<B>>{ a }, options_of(b));
+            }
+
+            template <number T>
+            constexpr auto operator()(const masked_column<T> &a, const masked_column<T> &b) const -> masked_column<T> {
+                check_lengths(a.size(), b.size());
+                return masked_kernel<Op, T>(a.size(), masked_of(a), masked_of(b));
+            }
+
+            template <number T>
+            constexpr auto operator()(const masked_column<T> &a, std::type_identity_t<T> b) const -> masked_column<T> {
+                return masked_kernel<Op, T>(a.size(), masked_of(a), scalar_operand<T>{ b });
+            }
+
+            template <number T>
+            constexpr auto operator()(std::type_identity_t<T> a, const masked_column<T> &b) const -> masked_column<T> {
+                return masked_kernel<Op, T>(b.size(), scalar_operand<T>{ a }, masked_of(b));
+            }
+        };
+
+        template <typename Op>
+        struct unary_fn {
+            template <option_column A>
+            constexpr auto operator()(const A &a) const -> std::vector<option<column_payload<A>>> {
+                return options_kernel<Op, column_payload<A>>(std::ranges::size(a), options_of(a));
+            }
+
+            template <number T>
+            constexpr auto operator()(const masked_column<T> &a) const -> masked_column<T> {
+                return masked_kernel<Op, T>(a.size(), masked_of(a));
+            }
+        };
+
+        // Columns of plain numbers, which `gather` reads and `scatter` writes.
+        template <typename R>
+        concept value_column = std::ranges::contiguous_range<const R> && std::ranges::sized_range<const R>
+                            && number<std::ranges::range_value_t<R>>;
+
+        template <typename R>
+        concept index_column = std::ranges::contiguous_range<const R> && std::ranges::sized_range<const R>
+                            && opt::detail::option_type<std::ranges::range_value_t<R>>
+                            && std::integral<typename std::ranges::range_value_t<R>::value_type>
+                            && !std::same_as<typename std::ranges::range_value_t<R>::value_type, bool>;
+
+        template <typename R>
+        using index_payload = typename std::ranges::range_value_t<R>::value_type;
+
+        // `x` if `keep`, `T{}` otherwise, with a mask instead of a select the
+        // compiler may turn back into a branch.
+        template <typename T>
+        constexpr auto zero_unless(bool keep, T x) noexcept -> T {
+            if constexpr (std::integral<T>) {
+                return static_cast<T>(static_cast<wrapping<T>>(x) & (wrapping<T>{} - static_cast<wrapping<T>>(keep)));
+            } else if constexpr (sizeof(T) == sizeof(std::uint32_t)) {
+                return std::bit_cast<T>(std::bit_cast<std::uint32_t>(x) & (0U - static_cast<std::uint32_t>(keep)));
+            } else if constexpr (sizeof(T) == sizeof(std::uint64_t)) {
+                return std::bit_cast<T>(std::bit_cast<std::uint64_t>(x) & (std::uint64_t{} - keep));
+            } else {
+                return keep ? x : T{};
+            }
+        }
+
+        // The rows of a block of up to 64 indices that are present and less
+        // than `n`, as a word, with their indices in `idx` and 0 for the rest;
+        // `out_of_range` is set if a present index is not less than `n`. The
+        // presence flags are gathered first, and the indices read for the set
+        // bits only, so no branch depends on whether a row is `none`.
+        template <typename Idx>
+        constexpr auto index_block(const option<Idx> *rows, std::size_t count, std::size_t n, std::size_t *idx,
+                                   bool &out_of_range) noexcept -> std::uint64_t {
+            std::uint64_t present = 0;
+            for (std::size_t j = 0; j < count; ++j) {
+                present |= static_cast<std::uint64_t>(rows[j].is_some()) << j;
+                idx[j] = 0;
+            }
+            std::uint64_t word = 0;
+            bool bad = false;
+            for (; present != 0; present &= present - 1) {
+                const auto j = static_cast<std::size_t>(std::countr_zero(present));
+                // Negative indices become too large.
+                const auto raw = static_cast<std::make_unsigned_t<Idx>>(*rows[j]);
+                const bool in = std::cmp_less(raw, n);
+                bad |= !in;
+                word |= static_cast<std::uint64_t>(in) << j;
+                idx[j] = static_cast<std::size_t>(raw) & (std::size_t{} - in);
+            }
+            out_of_range |= bad;
+            return word;
+        }
+
+#if OPT_OPTION_BATCH_GATHER && defined(__AVX2__)
+        // `values[idx[j]]` into `out[j]` for the rows set in `word`, and 0 for
+        // the rest, with masked gathers of 64-bit indices.
+        template <typename T>
+        inline void simd_gather(const T *values, const std::size_t *idx, std::size_t count, std::uint64_t word,
+                                T *out) noexcept {
+            std::size_t j = 0;
+    #if defined(__AVX512F__)
+            for (; j + 8 <= count; j += 8) {
+                const __m512i index = _mm512_loadu_si512(idx + j);
+                const auto live = static_cast<__mmask8>(word >> j);
+                if constexpr (sizeof(T) == 4) {
+                    const __m256i got = _mm512_mask_i64gather_epi32(_mm256_setzero_si256(), live, index, values, 4);
+                    _mm256_storeu_si256(reinterpret_cast<__m256i *>(out + j), got);
+                } else {
+                    const __m512i got = _mm512_mask_i64gather_epi64(_mm512_setzero_si512(), live, index, values, 8);
+                    _mm512_storeu_si512(out + j, got);
+                }
+            }
+    #else
+            // Lane `k` of the mask is all ones where bit `k` of the row's word is set.
+            const __m256i lane_bits = _mm256_set_epi64x(8, 4, 2, 1);
+            for (; j + 4 <= count; j += 4) {
+                const __m256i index = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(idx + j));
+                const __m256i bits = _mm256_and_si256(_mm256_set1_epi64x(static_cast<long long>(word >> j)), lane_bits);
+                const __m256i live = _mm256_cmpeq_epi64(bits, lane_bits);
+                if constexpr (sizeof(T) == 4) {
+                    const __m128i live32 = _mm256_castsi256_si128(
+                        _mm256_permutevar8x32_epi32(live, _mm256_setr_epi32(0, 2, 4, 6, 0, 2, 4, 6)));
+                    const __m128i got = _mm256_mask_i64gather_epi32(
+                        _mm_setzero_si128(), reinterpret_cast<const int *>(values), index, live32, 4);
+                    _mm_storeu_si128(reinterpret_cast<__m128i *>(out + j), got);
+                } else {
+                    const __m256i got = _mm256_mask_i64gather_epi64(
+                        _mm256_setzero_si256(), reinterpret_cast<const long long *>(values), index, live, 8);
+                    _mm256_storeu_si256(reinterpret_cast<__m256i *>(out + j), got);
+                }
+            }
+    #endif
+            for (; j < count; ++j) {
+                out[j] = zero_unless(((word >> j) & 1) != 0, values[idx[j]]);
+            }
+        }
+#endif
+
+        // Asks for the cache line at `p`.
+        inline void prefetch(const void *p) noexcept {
+#if defined(__GNUC__) || defined(__clang__)
+            __builtin_prefetch(p);
+#else
+            static_cast<void>(p);
+#endif
+        }
+
+        // The sources of a gather: each reads a block's rows into `out`, 0 for
+        // those clear in `word`, and returns `word` without the rows whose value
+        // is `none`, and can prefetch them. Every index in `idx` is in bounds.
+        template <typename T>
+        struct gather_values {
+            const T *values;
+
+            void prefetch(const std::size_t *idx, std::uint64_t word) const noexcept {
+                for (; word != 0; word &= word - 1) {
+                    detail::prefetch(values + idx[std::countr_zero(word)]);
+                }
+            }
+
+            constexpr auto fetch(const std::size_t *idx, std::size_t count, std::uint64_t word, T *out) const noexcept
+                -> std::uint64_t {
+#if OPT_OPTION_BATCH_GATHER && defined(__AVX2__)
+                if constexpr (sizeof(T) == 4 || sizeof(T) == 8) {
+                    if !consteval {
+                        simd_gather(values, idx, count, word, out);
+                        return word;
+                    }
+                }
+#endif
+                for (std::size_t j = 0; j < count; ++j) {
+                    out[j] = zero_unless(((word >> j) & 1) != 0, values[idx[j]]);
+                }
+                return word;
+            }
+        };
+
+        template <typename T>
+        struct gather_options {
+            const option<T> *values;
+
+            void prefetch(const std::size_t *idx, std::uint64_t word) const noexcept {
+                for (; word != 0; word &= word - 1) {
+                    detail::prefetch(values + idx[std::countr_zero(word)]);
+                }
+            }
+
+            constexpr auto fetch(const std::size_t *idx, std::size_t count, std::uint64_t word, T *out) const noexcept
+                -> std::uint64_t {
+                std::uint64_t present = 0;
+                for (std::size_t j = 0; j < count; ++j) {
+                    present |= static_cast<std::uint64_t>(values[idx[j]].is_some()) << j;
+                    out[j] = T{};
+                }
+                word &= present;
+                for (std::uint64_t bits = word; bits != 0; bits &= bits - 1) {
+                    const auto j = static_cast<std::size_t>(std::countr_zero(bits));
+                    out[j] = *values[idx[j]];
+                }
+                return word;
+            }
+        };
+
+        template <typename T>
+        struct gather_masked {
+            const T *values;
+            const std::uint64_t *words;
+
+            void prefetch(const std::size_t *idx, std::uint64_t word) const noexcept {
+                for (; word != 0; word &= word - 1) {
+                    const std::size_t i = idx[std::countr_zero(word)];
+                    detail::prefetch(values + i);
+                    detail::prefetch(words + i / masked_column<T>::word_bits);
+                }
+            }
+
+            constexpr auto fetch(const std::size_t *idx, std::size_t count, std::uint64_t word, T *out) const noexcept
+                -> std::uint64_t {
+                constexpr std::size_t word_bits = masked_column<T>::word_bits;
+                std::uint64_t present = 0;
+                for (std::size_t j = 0; j < count; ++j) {
+                    present |= ((words[idx[j] / word_bits] >> (idx[j] % word_bits)) & 1) << j;
+                }
+                word &= present;
+                for (std::size_t j = 0; j < count; ++j) {
+                    out[j] = zero_unless(((word >> j) & 1) != 0, values[idx[j]]);
+                }
+                return word;
+            }
+        };
+
+        // A gather of `n` values through `m` indices, a block of 64 at a time:
+        // the indices, then the values, then `emit(block, values, word)`. The
+        // indices of the next block are read before the values of this one,
+        // and its values prefetched, so that cache misses overlap across
+        // blocks. Blocks without a present index read nothing, so neither does
+        // a gather from an empty column.
+        template <typename T, typename Idx, typename Source, typename Emit>
+        constexpr void gather_kernel(std::size_t n, const option<Idx> *rows, std::size_t m, const Source &source,
+                                     Emit emit) {
+            constexpr std::size_t word_bits = 64;
+            std::size_t idx[2][word_bits];
+            T values[word_bits];
+            bool out_of_range = false;
+            std::uint64_t next = m != 0 ? index_block(rows, std::min(word_bits, m), n, idx[0], out_of_range) : 0;
+            for (std::size_t w = 0, base = 0; base < m; ++w, base += word_bits) {
+                const std::size_t count = std::min(word_bits, m - base);
+                std::uint64_t word = next;
+                if (base + word_bits < m) {
+                    const std::size_t rest = std::min(word_bits, m - base - word_bits);
+                    next = index_block(rows + base + word_bits, rest, n, idx[(w + 1) % 2], out_of_range);
+                    if !consteval {
+                        source.prefetch(idx[(w + 1) % 2], next);
+                    }
+                }
+                if (word != 0) {
+                    word = source.fetch(idx[w % 2], count, word, values);
+                } else {
+                    std::fill_n(values, count, T{});
+                }
+                emit(w, base, count, values, word);
+            }
+            if (out_of_range) {
+                throw option_panic("opt::batch::gather: index out of range");
+            }
+        }
+
+        template <typename T, typename Idx, typename Source>
+        constexpr auto gather_to_options(std::size_t n, const option<Idx> *rows, std::size_t m, const Source &source)
+            -> std::vector<option<T>> {
+            // Rows start out `none`, and only the present ones are written.
+            std::vector<option<T>> out(m);
+            const auto emit = [&](std::size_t, std::size_t base, std::size_t, const T *values, std::uint64_t word) {
+                for (; word != 0; word &= word - 1) {
+                    const auto j = static_cast<std::size_t>(std::countr_zero(word));
+                    out[base + j] = option<T>{ values[j] };
+                }
+            };
+            gather_kernel<T>(n, rows, m, source, emit);
+            return out;
+        }
+
+        template <typename T, typename Idx, typename Source>
+        constexpr auto gather_to_masked(std::size_t n, const option<Idx> *rows, std::size_t m, const Source &source)
+            -> masked_column<T> {
+            masked_column<T> out(m);
+            T *const out_values = out.values().data();
+            std::uint64_t *const out_words = out.validity().data();
+            const auto emit = [&](std::size_t w, std::size_t base, std::size_t count, const T *values,
+                                  std::uint64_t word) {
+                std::copy_n(values, count, out_values + base);
+                out_words[w] = word;
+            };
+            gather_kernel<T>(n, rows, m, source, emit);
+            return out;
+        }
+
+        struct gather_fn {
+            template <value_column V, index_column I>
+            constexpr auto operator()(const V &values, const I &indices) const
+                -> std::vector<option<std::ranges::range_value_t<V>>> {
+                using T = std::ranges::range_value_t<V>;
+                return gather_to_options<T>(std::ranges::size(values), std::ranges::data(indices),
+                                            std::ranges::size(indices),
+                                            gather_values<T>{ std::to_address(std::ranges::data(values)) });
+            }
+
+            template <option_column V, index_column I>
+            constexpr auto operator()(const V &values, const I &indices) const
+                -> std::vector<option<column_payload<V>>> {
+                using T = column_payload<V>;
+                return gather_to_options<T>(std::ranges::size(values), std::ranges::data(indices),
+                                            std::ranges::size(indices),
+                                            gather_options<T>{ std::to_address(std::ranges::data(values)) });
+            }
+
+            template <number T, index_column I>
+            constexpr auto operator()(const masked_column<T> &values, const I &indices) const -> masked_column<T> {
+                return gather_to_masked<T>(values.size(), std::ranges::data(indices), std::ranges::size(indices),
+                                           gather_masked<T>{ values.values().data(), values.validity().data() });
+            }
+        };
+
+        // Panics before anything is written if a present index is not less than `n`.
+        template <typename Idx>
+        constexpr void check_indices(const option<Idx> *rows, std::size_t m, std::size_t n) {
+            bool bad = false;
+            for (std::size_t i = 0; i < m; ++i) {
+                const auto raw = static_cast<std::make_unsigned_t<Idx>>(rows[i].unwrap_or(Idx{}));
+                bad |= rows[i].is_some() & !std::cmp_less(raw, n);
+            }
+            if (bad) {
+                throw option_panic("opt::batch::scatter: index out of range");
+            }
+        }
+
+        // `write(i, index)` for the rows `i` whose index is present, in order,
+        // visiting the set bits of each block's word.
+        template <typename Idx, typename Write>
+        constexpr void scatter_kernel(const option<Idx> *rows, std::size_t m, std::size_t n, Write write) {
+            constexpr std::size_t word_bits = 64;
+            check_indices(rows, m, n);
+            std::size_t idx[word_bits];
+            bool out_of_range = false;
+            for (std::size_t base = 0; base < m; base += word_bits) {
+                const std::size_t count = std::min(word_bits, m - base);
+                for (std::uint64_t word = index_block(rows + base, count, n, idx, out_of_range); word != 0;
+                     word &= word - 1) {
+                    const auto j = static_cast<std::size_t>(std::countr_zero(word));
+                    write(base + j, idx[j]);
+                }
+            }
+        }
+
+        struct scatter_fn {
+            template <value_column V, index_column I>
+            constexpr void operator()(const V &values, const I &indices,
+                                      std::span<std::type_identity_t<std::ranges::range_value_t<V>>> target) const {
+                check_lengths(std::ranges::size(values), std::ranges::size(indices));
+                const auto *const from = std::to_address(std::ranges::data(values));
+                scatter_kernel(std::ranges::data(indices), std::ranges::size(indices), target.size(),
+                               [&](std::size_t i, std::size_t k) { target[k] = from[i]; });
+            }
+
+            template <option_column V, index_column I>
+            constexpr void operator()(const V &values, const I &indices,
+                                      std::span<option<column_payload<V>>> target) const {
+                check_lengths(std::ranges::size(values), std::ranges::size(indices));
+                const auto *const from = std::to_address(std::ranges::data(values));
+                scatter_kernel(std::ranges::data(indices), std::ranges::size(indices), target.size(),
+                               [&](std::size_t i, std::size_t k) { target[k] = from[i]; });
+            }
+
+            template <number T, index_column I>
+            constexpr void operator()(const masked_column<T> &values, const I &indices,
+                                      masked_column<T> &target) const {
+                constexpr std::size_t word_bits = masked_column<T>::word_bits;
+                check_lengths(values.size(), std::ranges::size(indices));
+                const T *const from = values.values().data();
+                const std::uint64_t *const from_words = values.validity().data();
+                T *const to = target.values().data();
+                std::uint64_t *const to_words = target.validity().data();
+                const auto write = [&](std::size_t i, std::size_t k) {
+                    const std::uint64_t present = (from_words[i / word_bits] >> (i % word_bits)) & 1;
+                    std::uint64_t &word = to_words[k / word_bits];
+                    to[k] = from[i];
+                    word = (word & ~(std::uint64_t{ 1 } << (k % word_bits))) | (present << (k % word_bits));
+                };
+                scatter_kernel(std::ranges::data(indices), std::ranges::size(indices), target.size(), write);
+            }
+        };
+    } // namespace detail
+
+    inline constexpr detail::binary_fn<detail::add_op> add{};
+    inline constexpr detail::binary_fn<detail::sub_op> sub{};
+    inline constexpr detail::binary_fn<detail::mul_op> mul{};
+    // `none` where the divisor is zero.
+    inline constexpr detail::binary_fn<detail::div_op> div{};
+    inline constexpr detail::binary_fn<detail::min_op> min{};
+    inline constexpr detail::binary_fn<detail::max_op> max{};
+    inline constexpr detail::unary_fn<detail::abs_op> abs{};
+
+    // `values[*indices[i]]` in row `i`, `none` where the index is.
+    inline constexpr detail::gather_fn gather{};
+    // `target[*indices[i]] = values[i]` for each present index; the last row
+    // wins where indices repeat.
+    inline constexpr detail::scatter_fn scatter{};
+} // namespace opt::batch
@@ -2,6 +2,40 @@ module;
 
 #include <cassert>
 
+#ifndef OPT_OPTION_STATS
+    #define OPT_OPTION_STATS 0
+#endif
+
+#ifndef OPT_OPTION_PROFILE
+    #define OPT_OPTION_PROFILE 0
+#endif
+
+// Debug-build performance: force the storage accessors and the hot accessors and
+// combinators inline even at -O0/-Og, and mark them artificial so that debuggers
+// step over them.
+#ifndef OPT_OPTION_DEBUG_PERF
+    #define OPT_OPTION_DEBUG_PERF 0
+#endif
+
+// Branch hints on the path that finds a value, for the `unwrap`, `unwrap_or` and
+// `get_or_insert` families: `likely`, `unlikely` or empty. A header written by
+// `opt::profiler::write_hints()` can set them through `OPT_OPTION_HINTS_HEADER`.
+#ifdef OPT_OPTION_HINTS_HEADER
+    #include OPT_OPTION_HINTS_HEADER
+#endif
+
+#ifndef OPT_OPTION_HINT_UNWRAP
+    #define OPT_OPTION_HINT_UNWRAP likely
+#endif
+
+#ifndef OPT_OPTION_HINT_UNWRAP_OR
+    #define OPT_OPTION_HINT_UNWRAP_OR likely
+#endif
+
+#ifndef OPT_OPTION_HINT_GET_OR_INSERT
+    #define OPT_OPTION_HINT_GET_OR_INSERT likely
+#endif
+
 export module option:classes;
 
 import std;
@@ -9,6 +43,9 @@ import :fwd;
 import :panic;
 import :storage;
 import :none;
+import :stats;
+import :profiler;
+import :core;
 
 #pragma push_macro("force_inline")
 #undef force_inline
@@ -26,6 +63,16 @@ import :none;
     #define hot_path
 #endif
 
+#pragma push_macro("debug_inline")
+#undef debug_inline
+#if !OPT_OPTION_DEBUG_PERF
+    #define debug_inline
+#elif defined(__clang__) || defined(__GNUC__)
+    #define debug_inline [[gnu::always_inline, gnu::artificial]]
+#else
+    #define debug_inline [[msvc::forceinline]]
+#endif
+
 #pragma push_macro("cpp20_no_unique_address")
 #undef cpp20_no_unique_address
 #if defined(_MSC_VER)
@@ -43,6 +90,68 @@ import :none;
     #define has_cpp_lib_optional_ref 0
 #endif
 
+#pragma push_macro("stats_record")
+#pragma push_macro("stats_record_if")
+#pragma push_macro("stats_record_value")
+#pragma push_macro("stats_check")
+#undef stats_record
+#undef stats_record_if
+#undef stats_record_value
+#undef stats_check
+#if OPT_OPTION_STATS
+    #define stats_record(T, e)          ::opt::stats::detail::record<T>(::opt::stats::event::e)
+    #define stats_record_if(T, cond, e) ((cond) ? stats_record(T, e) : void())
+    #define stats_record_value(T, U)    ::opt::stats::detail::record_value<T, U>()
+    #define stats_check(T, some)        ::opt::stats::detail::record_check<T>(some)
+#else
+    #define stats_record(T, e)          static_cast<void>(0)
+    #define stats_record_if(T, cond, e) static_cast<void>(0)
+    #define stats_record_value(T, U)    static_cast<void>(0)
+    #define stats_check(T, some)        (some)
+#endif
+
+#pragma push_macro("hint_some")
+#pragma push_macro("hint_none")
+#pragma push_macro("hint_none_impl")
+#pragma push_macro("hint_none_paste")
+#pragma push_macro("hint_none_of_likely")
+#pragma push_macro("hint_none_of_unlikely")
+#pragma push_macro("hint_none_of_")
+#undef hint_some
+#undef hint_none
+#undef hint_none_impl
+#undef hint_none_paste
+#undef hint_none_of_likely
+#undef hint_none_of_unlikely
+#undef hint_none_of_
+#define hint_some(family)     OPT_OPTION_HINT_##family
+#define hint_none(family)     hint_none_impl(OPT_OPTION_HINT_##family)
+#define hint_none_impl(hint)  hint_none_paste(hint)
+#define hint_none_paste(hint) hint_none_of_##hint
+#define hint_none_of_likely   unlikely
+#define hint_none_of_unlikely likely
+#define hint_none_of_
+
+#pragma push_macro("profile_site")
+#pragma push_macro("profile_site_only")
+#pragma push_macro("profile_some")
+#pragma push_macro("profile_none")
+#undef profile_site
+#undef profile_site_only
+#undef profile_some
+#undef profile_none
+#if OPT_OPTION_PROFILE
+    #define profile_site             , ::std::source_location site = ::std::source_location::current()
+    #define profile_site_only        ::std::source_location site = ::std::source_location::current()
+    #define profile_some(kind, some) ::opt::profiler::detail::record_some(::opt::profiler::site_kind::kind, site, some)
+    #define profile_none(kind, none) ::opt::profiler::detail::record_none(::opt::profiler::site_kind::kind, site, none)
+#else
+    #define profile_site
+    #define profile_site_only
+    #define profile_some(kind, some) (some)
+    #define profile_none(kind, none) (none)
+#endif
+
 export namespace opt {
     template <>
     class option<void> {
@@ -495,6 +604,16 @@ export namespace opt {
             return std::nullopt;
         }
 
+        // `core::option<T>` has the same layout, the conversions in both directions are plain copies.
+        template <typename U = T>
+            requires std::same_as<U, T> && detail::core_payload<U>
+        constexpr operator core::option<U>() const noexcept {
+            if (is_some()) {
+                return core::option<U>{ storage.get() };
+            }
+            return core::option<U>{};
+        }
+
         // https://eel.is/c++draft/optional.optional.general
         using value_type = T;
         using iterator = T *;
@@ -518,7 +637,23 @@ export namespace opt {
             }
         }
 
+        template <typename U = T>
+            requires std::same_as<U, T> && detail::core_payload<U>
+        constexpr option(const core::option<U> &rhs) noexcept {
+            if (rhs.is_some()) {
+                storage.emplace(*rhs);
+            }
+        }
+
+#if OPT_OPTION_STATS
+        constexpr option(const option &other) noexcept(std::is_nothrow_copy_constructible_v<T>)
+            requires std::is_copy_constructible_v<detail::option_storage<T>>
+            : storage{ other.storage } {
+            stats_record_if(T, other.storage.has_value(), copy);
+        }
+#else
         constexpr option(const option &) noexcept(std::is_nothrow_copy_constructible_v<T>) = default;
+#endif
 
         // https://eel.is/c++draft/optional.ctor#lib:optional,constructor__
         //
@@ -533,7 +668,15 @@ export namespace opt {
             }
         }
 
+#if OPT_OPTION_STATS
+        constexpr option(option &&other) noexcept(std::is_nothrow_move_constructible_v<T>)
+            requires std::is_move_constructible_v<detail::option_storage<T>>
+            : storage{ std::move(other.storage) } {
+            stats_record_if(T, storage.has_value(), move);
+        }
+#else
         constexpr option(option &&) noexcept(std::is_nothrow_move_constructible_v<T>) = default;
+#endif
 
         // https://eel.is/c++draft/optional.ctor#lib:optional,constructor___
         template <class... Args>
@@ -556,9 +699,12 @@ export namespace opt {
                   && (!std::is_same_v<std::remove_cvref_t<U>, option>)
                   && ((!std::same_as<std::remove_cv_t<T>, bool>)
                       || (!detail::specialization_of<std::remove_cvref_t<U>, std::optional>
-                          && !detail::specialization_of<std::remove_cvref_t<U>, option>))
+                          && !detail::specialization_of<std::remove_cvref_t<U>, option>
+                          && !detail::specialization_of<std::remove_cvref_t<U>, core::option>))
                   && std::is_constructible_v<T, U>
-            : storage(std::in_place, std::forward<U>(v)) {}
+            : storage(std::in_place, std::forward<U>(v)) {
+            stats_record_value(T, U);
+        }
 
         // https://eel.is/c++draft/optional.ctor#lib:optional,constructor______
         template <class U>
@@ -612,15 +758,38 @@ export namespace opt {
 
         // https://eel.is/c++draft/optional.assign#lib:operator=,optional
         constexpr option<T> &operator=(std::nullopt_t) noexcept {
+            stats_record_if(T, storage.has_value(), reset);
             storage.reset();
             return *this;
         }
 
         constexpr option<T> &operator=(none_t) noexcept {
+            stats_record_if(T, storage.has_value(), reset);
             storage.reset();
             return *this;
         }
 
+#if OPT_OPTION_STATS
+        // https://eel.is/c++draft/optional.optional#lib:operator=,optional_
+        constexpr option &operator=(const option &other) noexcept(std::is_nothrow_copy_assignable_v<T>
+                                                                  && std::is_nothrow_copy_constructible_v<T>)
+            requires std::is_copy_assignable_v<T> && std::is_copy_constructible_v<T>
+        {
+            storage = other.storage;
+            stats_record_if(T, other.storage.has_value(), copy);
+            return *this;
+        }
+
+        // https://eel.is/c++draft/optional.optional#lib:operator=,optional__
+        constexpr option &operator=(option &&other) noexcept(std::is_nothrow_move_assignable_v<T>
+                                                             && std::is_nothrow_move_constructible_v<T>)
+            requires std::is_move_assignable_v<T> && std::is_move_constructible_v<T>
+        {
+            storage = std::move(other.storage);
+            stats_record_if(T, storage.has_value(), move);
+            return *this;
+        }
+#else
         // https://eel.is/c++draft/optional.optional#lib:operator=,optional_
         constexpr option &operator=(const option &) noexcept(std::is_nothrow_copy_assignable_v<T>
                                                              && std::is_nothrow_copy_constructible_v<T>)
@@ -632,6 +801,7 @@ export namespace opt {
                                                         && std::is_nothrow_move_constructible_v<T>)
             requires std::is_move_assignable_v<T> && std::is_move_constructible_v<T>
         = default;
+#endif
 
         // https://eel.is/c++draft/optional.assign#lib:operator=,optional___
         template <class U = std::remove_cv_t<T>>
@@ -763,6 +933,7 @@ export namespace opt {
             static_assert(std::constructible_from<T, Args...>);
             reset();
             storage.emplace(std::forward<Args>(args)...);
+            stats_record(T, emplace);
             return storage.get();
         }
 
@@ -776,6 +947,7 @@ export namespace opt {
         {
             reset();
             storage.emplace(il, std::forward<Args>(args)...);
+            stats_record(T, emplace);
             return storage.get();
         }
 
@@ -849,7 +1021,7 @@ export namespace opt {
 
         // https://eel.is/c++draft/optional.observe#lib:operator-%3e,optional
         template <class Self>
-        hot_path constexpr auto operator->(this Self &&self) noexcept
+        hot_path debug_inline constexpr auto operator->(this Self &&self) noexcept
             -> std::conditional_t<std::is_const_v<std::remove_reference_t<Self>>, const T *, T *> {
             assert(self.has_value());
             return std::addressof(self.storage.get());
@@ -858,25 +1030,25 @@ export namespace opt {
         // https://eel.is/c++draft/optional.observe#lib:operator*,optional
         // https://eel.is/c++draft/optional.observe#lib:operator*,optional_
         template <class Self>
-        hot_path constexpr auto operator*(this Self &&self) noexcept -> auto && {
+        hot_path debug_inline constexpr auto operator*(this Self &&self) noexcept -> auto && {
             assert(self.has_value());
             return std::forward_like<Self>(self.storage.get());
         }
 
         // https://eel.is/c++draft/optional.observe#lib:operator_bool,optional
-        constexpr explicit operator bool() const noexcept {
+        debug_inline constexpr explicit operator bool() const noexcept {
             return is_some();
         }
 
         // https://eel.is/c++draft/optional.observe#lib:has_value,optional
-        constexpr bool has_value() const noexcept {
+        debug_inline constexpr bool has_value() const noexcept {
             return is_some();
         }
 
         // https://eel.is/c++draft/optional.observe#lib:value,optional
         // https://eel.is/c++draft/optional.observe#lib:value,optional_
         template <class Self>
-        constexpr auto value(this Self &&self) -> auto && {
+        debug_inline constexpr auto value(this Self &&self) -> auto && {
             if (self.is_none()) {
                 throw std::bad_optional_access{};
             }
@@ -886,7 +1058,7 @@ export namespace opt {
         // https://eel.is/c++draft/optional.observe#lib:value_or,optional
         // https://eel.is/c++draft/optional.observe#lib:value_or,optional_
         template <typename Self, typename U = std::remove_cv_t<T>>
-        constexpr auto value_or(this Self &&self, U &&v) -> T {
+        debug_inline constexpr auto value_or(this Self &&self, U &&v) -> T {
             static_assert(std::is_lvalue_reference_v<Self>
                               ? std::is_copy_constructible_v<T> && std::is_convertible_v<U &&, T>
                               : std::is_move_constructible_v<T> && std::is_convertible_v<U &&, T>);
@@ -900,7 +1072,7 @@ export namespace opt {
         // https://eel.is/c++draft/optional.monadic#lib:and_then,optional
         // https://eel.is/c++draft/optional.monadic#lib:and_then,optional_
         template <typename Self, typename F>
-        constexpr auto and_then(this Self &&self, F &&f) {
+        debug_inline constexpr auto and_then(this Self &&self, F &&f) {
             using U = std::invoke_result_t<F, decltype(*std::forward<Self>(self))>;
 
             static_assert(detail::option_type<U> || detail::specialization_of<std::remove_cvref_t<U>, std::optional>);
@@ -984,6 +1156,7 @@ export namespace opt {
 
         // https://eel.is/c++draft/optional.mod#lib:reset,optional
         constexpr void reset() noexcept {
+            stats_record_if(T, storage.has_value(), reset);
             storage.reset();
         }
 
@@ -1060,8 +1233,9 @@ export namespace opt {
         //
         // Throws if the option is empty with a custom message provided by `msg`.
         template <class Self>
-        constexpr auto expect(this Self &&self, const char *msg) -> auto && {
-            if (self.is_none()) {
+        debug_inline constexpr auto expect(this Self &&self, const char *msg profile_site) -> auto && {
+            if (profile_none(unwrap, self.is_none())) [[hint_none(UNWRAP)]] {
+                stats_record(T, panic);
                 throw option_panic(msg);
             }
             return *std::forward<Self>(self);
@@ -1073,7 +1247,7 @@ export namespace opt {
         // - `some(t)` if `predicate` returns `true` (where `t` is the wrapped value)
         // - `none` if `predicate` returns `false`
         template <typename Self, typename F>
-        constexpr auto filter(this Self &&self, F &&predicate) -> option
+        debug_inline constexpr auto filter(this Self &&self, F &&predicate) -> option
             requires std::predicate<F, decltype(self.storage.get())>
         {
             if (self.is_some() && std::invoke(std::forward<F>(predicate), self.storage.get())) {
@@ -1099,22 +1273,24 @@ export namespace opt {
         // See also `option::insert`, which updates the value even if the option already
         // contains a value.
         template <typename U>
-        constexpr auto get_or_insert(U &&value) -> T &
+        debug_inline constexpr auto get_or_insert(U &&value profile_site) -> T &
             requires (std::copy_constructible<T> || std::move_constructible<T>) && std::convertible_to<U &&, T>
         {
-            if (is_none()) [[unlikely]] {
+            if (profile_none(get_or_insert, is_none())) [[hint_none(GET_OR_INSERT)]] {
                 storage.emplace(std::forward<U>(value));
+                stats_record(T, emplace);
             }
             return storage.get();
         }
 
         // Inserts the default value into the option if it is empty, then returns a
         // reference to the contained value.
-        constexpr auto get_or_insert_default() -> T &
+        constexpr auto get_or_insert_default(profile_site_only) -> T &
             requires std::default_initializable<T>
         {
-            if (is_none()) {
+            if (profile_none(get_or_insert, is_none())) [[hint_none(GET_OR_INSERT)]] {
                 storage.emplace(T{});
+                stats_record(T, emplace);
             }
             return storage.get();
         }
@@ -1122,11 +1298,12 @@ export namespace opt {
         // Inserts a value computed from `f` into the option if it is empty, then returns
         // a reference to the contained value.
         template <std::invocable F>
-        constexpr auto get_or_insert_with(F &&f) -> T &
+        debug_inline constexpr auto get_or_insert_with(F &&f profile_site) -> T &
             requires std::constructible_from<T, std::invoke_result_t<F>>
         {
-            if (is_none()) [[unlikely]] {
+            if (profile_none(get_or_insert, is_none())) [[hint_none(GET_OR_INSERT)]] {
                 storage.emplace(std::invoke(std::forward<F>(f)));
+                stats_record(T, emplace);
             }
             return storage.get();
         }
@@ -1143,6 +1320,7 @@ export namespace opt {
         {
             storage.reset();
             storage.emplace(std::forward<U>(value));
+            stats_record(T, emplace);
             return storage.get();
         }
 
@@ -1159,27 +1337,27 @@ export namespace opt {
         }
 
         // Returns `true` if the option is empty.
-        constexpr auto is_none() const noexcept -> bool {
+        debug_inline constexpr auto is_none() const noexcept -> bool {
             return !is_some();
         }
 
         // Returns `true` if the option is empty or the value inside matches a predicate.
         template <typename F>
-        constexpr auto is_none_or(this auto &&self, F &&f) -> bool
+        debug_inline constexpr auto is_none_or(this auto &&self, F &&f) -> bool
             requires std::predicate<F, decltype(self.storage.get())>
         {
             return self.is_none() || std::invoke(std::forward<F>(f), self.storage.get());
         }
 
         // Returns `true` if the option contains a value.
-        hot_path constexpr auto is_some() const noexcept -> bool {
-            return storage.has_value();
+        hot_path debug_inline constexpr auto is_some() const noexcept -> bool {
+            return stats_check(T, storage.has_value());
         }
 
         // Returns `true` if the option contains a value and the value inside matches a
         // predicate.
         template <typename F>
-        constexpr auto is_some_and(this auto &&self, F &&predicate) -> bool
+        debug_inline constexpr auto is_some_and(this auto &&self, F &&predicate) -> bool
             requires std::predicate<F, decltype(self.storage.get())>
         {
             return self.is_some() && std::invoke(std::forward<F>(predicate), self.storage.get());
@@ -1188,7 +1366,7 @@ export namespace opt {
         // Maps an `option<T>` to `option<U>` by applying a function to a contained value
         // (if the option contains a value) or returns `none` (if the option is empty).
         template <typename Self, typename F>
-        constexpr auto map(this Self &&self, F &&f)
+        debug_inline constexpr auto map(this Self &&self, F &&f)
             -> option<std::remove_cv_t<std::invoke_result_t<F, decltype(*std::forward<Self>(self))>>> {
             using U = std::remove_cv_t<std::invoke_result_t<F, decltype(*std::forward<Self>(self))>>;
 
@@ -1213,7 +1391,7 @@ export namespace opt {
                   typename RF = std::invoke_result_t<F, decltype(*std::declval<Self>())>,
                   typename Ret = std::conditional_t<std::is_lvalue_reference_v<RF> && std::is_lvalue_reference_v<U>,
                                                     std::common_reference_t<RF, U>, std::remove_cvref_t<RF>>>
-        constexpr Ret map_or(this Self &&self, U &&default_value, F &&f)
+        debug_inline constexpr Ret map_or(this Self &&self, U &&default_value, F &&f)
             requires (std::is_lvalue_reference_v<Self> ? std::copy_constructible<T> : std::move_constructible<T>)
                   && std::invocable<F, decltype(*self)>
                   && (!std::is_lvalue_reference_v<RF> || std::is_lvalue_reference_v<U>)
@@ -1305,7 +1483,7 @@ export namespace opt {
         // of a function call, it is recommended to use `or_else`, which is lazily
         // evaluated.
         template <detail::option_like U>
-        constexpr auto or_(this auto &&self, U &&optb) -> option {
+        debug_inline constexpr auto or_(this auto &&self, U &&optb) -> option {
             if (self.is_some()) {
                 return self;
             }
@@ -1324,21 +1502,30 @@ export namespace opt {
             requires (std::copy_constructible<T> || std::move_constructible<T>) && std::convertible_to<U, T>
         {
             option<T> old{};
-            if (self.is_some()) {
-                std::ranges::swap(self.storage, old.storage);
+            if constexpr (detail::plain_payload<std::remove_cv_t<T>> && !std::is_const_v<T>) {
+                old.storage = self.storage;
+            } else {
+                if (self.is_some()) {
+                    std::ranges::swap(self.storage, old.storage);
+                }
+                self.storage.reset();
             }
-
-            self.storage.reset();
             self.storage.emplace(std::forward<U>(value));
+            stats_record(T, emplace);
 
             return old;
         }
 
         // Takes the value out of the option, leaving an empty option in its place.
-        constexpr auto take(this auto &&self) -> option {
+        debug_inline constexpr auto take(this auto &&self) -> option {
             option result{};
-            if (self.is_some()) {
-                std::ranges::swap(self.storage, result.storage);
+            if constexpr (detail::plain_payload<std::remove_cv_t<T>> && !std::is_const_v<T>) {
+                result.storage = self.storage;
+                self.storage.reset();
+            } else {
+                if (self.is_some()) {
+                    std::ranges::swap(self.storage, result.storage);
+                }
             }
             return result;
         }
@@ -1386,10 +1573,11 @@ export namespace opt {
         //
         // Throws an `option_panic` exception if the option is empty.
         template <typename Self>
-        constexpr auto unwrap(this Self &&self) -> auto &&
+        debug_inline constexpr auto unwrap(this Self &&self profile_site) -> auto &&
             requires (!std::same_as<std::remove_cv_t<T>, void>)
         {
-            if (self.is_none()) [[unlikely]] {
+            if (profile_none(unwrap, self.is_none())) [[hint_none(UNWRAP)]] {
+                stats_record(T, panic);
                 throw option_panic("Attempted to access value of empty option");
             }
             return *std::forward<Self>(self);
@@ -1403,12 +1591,12 @@ export namespace opt {
         template <typename Self, typename U = std::remove_cv_t<T>, typename R = decltype(*std::declval<Self>()),
                   typename Ret = std::conditional_t<std::is_lvalue_reference_v<R> && std::is_lvalue_reference_v<U>,
                                                     std::common_reference_t<R, U>, std::remove_cvref_t<R>>>
-        constexpr Ret unwrap_or(this Self &&self, U &&default_value)
+        debug_inline constexpr Ret unwrap_or(this Self &&self, U &&default_value profile_site)
             requires (std::is_lvalue_reference_v<Self> ? std::copy_constructible<T> : std::move_constructible<T>)
                   && std::convertible_to<R, Ret>
                   && std::convertible_to<U, Ret>
         {
-            if (self.is_some()) [[likely]] {
+            if (profile_some(unwrap_or, self.is_some())) [[hint_some(UNWRAP_OR)]] {
                 return *std::forward<Self>(self);
             }
             return std::forward<U>(default_value);
@@ -1419,10 +1607,10 @@ export namespace opt {
         // If the option contains a value, returns the contained value; otherwise, returns
         // the default value for that type.
         template <typename Self>
-        constexpr auto unwrap_or_default(this Self &&self) -> T
+        debug_inline constexpr auto unwrap_or_default(this Self &&self profile_site) -> T
             requires std::default_initializable<T>
         {
-            if (self.is_some()) [[likely]] {
+            if (profile_some(unwrap_or, self.is_some())) [[hint_some(UNWRAP_OR)]] {
                 return *std::forward<Self>(self);
             }
             return T{};
@@ -1433,20 +1621,20 @@ export namespace opt {
                   typename RF = std::invoke_result_t<F>,
                   typename Ret = std::conditional_t<std::is_lvalue_reference_v<R> && std::is_lvalue_reference_v<RF>,
                                                     std::common_reference_t<R, RF>, std::remove_cvref_t<R>>>
-        constexpr Ret unwrap_or_else(this Self &&self, F &&f)
+        debug_inline constexpr Ret unwrap_or_else(this Self &&self, F &&f profile_site)
             requires (std::is_lvalue_reference_v<Self> ? std::copy_constructible<T> : std::move_constructible<T>)
                   && (!std::is_lvalue_reference_v<RF> || std::is_lvalue_reference_v<R>)
                   && std::convertible_to<R, Ret>
                   && std::convertible_to<RF, Ret>
         {
-            if (self.is_some()) {
+            if (profile_some(unwrap_or, self.is_some())) [[hint_some(UNWRAP_OR)]] {
                 return *std::forward<Self>(self);
             }
             return std::invoke(std::forward<F>(f));
         }
 
         // Returns the contained value, without checking that the value is not empty.
-        hot_path constexpr auto unwrap_unchecked(this auto &&self) noexcept -> auto && {
+        hot_path debug_inline constexpr auto unwrap_unchecked(this auto &&self) noexcept -> auto && {
             return *std::forward<decltype(self)>(self);
         }
 
@@ -1567,6 +1755,7 @@ export namespace opt {
             requires detail::cloneable<T>
         {
             if (self.is_some()) {
+                stats_record(T, clone);
                 return option{ detail::clone(*self) };
             }
             return option{};
@@ -1576,6 +1765,7 @@ export namespace opt {
             requires detail::cloneable<T> && std::is_copy_assignable_v<T>
         {
             if (source.is_some()) {
+                stats_record(T, clone);
                 if (self.is_some()) {
                     if constexpr (detail::has_clone<T>) {
                         self.storage.get() = detail::clone(*source);
@@ -2138,33 +2328,33 @@ export namespace opt {
         }
 
         // https://eel.is/c++draft/optional.ref.observe#itemdecl:1
-        constexpr T *operator->() const noexcept {
+        debug_inline constexpr T *operator->() const noexcept {
             return storage.ptr;
         }
 
         // https://eel.is/c++draft/optional.ref.observe#itemdecl:2
-        constexpr T &operator*() const noexcept {
+        debug_inline constexpr T &operator*() const noexcept {
             return storage.get();
         }
 
         // https://eel.is/c++draft/optional.ref.observe#itemdecl:3
-        constexpr explicit operator bool() const noexcept {
+        debug_inline constexpr explicit operator bool() const noexcept {
             return is_some();
         }
 
         // https://eel.is/c++draft/optional.ref.observe#itemdecl:4
-        constexpr bool has_value() const noexcept {
+        debug_inline constexpr bool has_value() const noexcept {
             return is_some();
         }
 
         // https://eel.is/c++draft/optional.ref.observe#itemdecl:5
-        constexpr T &value() const {
+        debug_inline constexpr T &value() const {
             return is_some() ? storage.get() : throw std::bad_optional_access();
         }
 
         // https://eel.is/c++draft/optional.ref.observe#itemdecl:6
         template <class U = std::remove_cv_t<T>>
-        constexpr std::decay_t<T> value_or(U &&u) const
+        debug_inline constexpr std::decay_t<T> value_or(U &&u) const
             requires (!std::is_array_v<T>) && std::is_object_v<T>
         {
             static_assert(std::is_constructible_v<std::remove_cv_t<T>, T &>
@@ -2174,7 +2364,7 @@ export namespace opt {
 
         // https://eel.is/c++draft/optional.ref.monadic#itemdecl:1
         template <class F>
-        constexpr auto and_then(F &&f) const {
+        debug_inline constexpr auto and_then(F &&f) const {
             using U = std::invoke_result_t<F, T &>;
             static_assert(detail::specialization_of<std::remove_cvref_t<U>, std::optional>
                           || detail::specialization_of<std::remove_cvref_t<U>, option>);
@@ -2310,15 +2500,15 @@ export namespace opt {
             return option<std::remove_cvref_t<T>>{};
         }
 
-        constexpr auto expect(const char *msg) const -> T & {
-            if (is_none()) {
+        debug_inline constexpr auto expect(const char *msg profile_site) const -> T & {
+            if (profile_none(unwrap, is_none())) [[hint_none(UNWRAP)]] {
                 throw option_panic(msg);
             }
             return storage.get();
         }
 
         template <typename F>
-        constexpr auto filter(F &&predicate) const -> option<T &>
+        debug_inline constexpr auto filter(F &&predicate) const -> option<T &>
             requires std::predicate<F, T &>
         {
             if (is_some() && std::invoke(std::forward<F>(predicate), storage.get())) {
@@ -2328,10 +2518,10 @@ export namespace opt {
         }
 
         template <typename U>
-        constexpr auto get_or_insert(U &&value) -> T &
+        debug_inline constexpr auto get_or_insert(U &&value profile_site) -> T &
             requires std::convertible_to<U, T &>
         {
-            if (is_none()) {
+            if (profile_none(get_or_insert, is_none())) [[hint_none(GET_OR_INSERT)]] {
                 storage.convert_ref_init_val(std::forward<U>(value));
             }
             return storage.get();
@@ -2353,30 +2543,30 @@ export namespace opt {
             return std::forward<Self>(self);
         }
 
-        constexpr auto is_none() const noexcept -> bool {
+        debug_inline constexpr auto is_none() const noexcept -> bool {
             return !is_some();
         }
 
         template <typename F>
-        constexpr auto is_none_or(F &&predicate) const -> bool
+        debug_inline constexpr auto is_none_or(F &&predicate) const -> bool
             requires std::predicate<F, T &>
         {
             return is_none() || std::invoke(std::forward<F>(predicate), storage.get());
         }
 
-        constexpr auto is_some() const noexcept -> bool {
+        debug_inline constexpr auto is_some() const noexcept -> bool {
             return storage.has_value();
         }
 
         template <typename F>
-        constexpr auto is_some_and(F &&predicate) const -> bool
+        debug_inline constexpr auto is_some_and(F &&predicate) const -> bool
             requires std::predicate<F, T &>
         {
             return is_some() && std::invoke(std::forward<F>(predicate), storage.get());
         }
 
         template <typename F>
-        constexpr auto map(F &&f) const -> option<std::remove_cv_t<std::invoke_result_t<F, T &>>> {
+        debug_inline constexpr auto map(F &&f) const -> option<std::remove_cv_t<std::invoke_result_t<F, T &>>> {
             using U = std::remove_cv_t<std::invoke_result_t<F, T &>>;
 
             if (is_some()) {
@@ -2394,7 +2584,7 @@ export namespace opt {
         template <typename F, typename U, typename R = std::invoke_result_t<F, T &>,
                   typename Ret = std::conditional_t<std::is_lvalue_reference_v<R> && std::is_lvalue_reference_v<U>,
                                                     std::common_reference_t<R, U>, std::remove_cvref_t<R>>>
-        constexpr Ret map_or(U &&default_value, F &&f) const
+        debug_inline constexpr Ret map_or(U &&default_value, F &&f) const
             requires std::invocable<F, T &>
                   && (!std::is_lvalue_reference_v<R> || std::is_lvalue_reference_v<U>)
                   && std::convertible_to<R, Ret>
@@ -2457,7 +2647,7 @@ export namespace opt {
         }
 
         template <detail::option_like U>
-        constexpr auto or_(U &&optb) const -> option<T &> {
+        debug_inline constexpr auto or_(U &&optb) const -> option<T &> {
             if (is_some()) {
                 return option<T &>{ storage.get() };
             }
@@ -2473,7 +2663,7 @@ export namespace opt {
             return old;
         }
 
-        constexpr auto take() -> option<T &> {
+        debug_inline constexpr auto take() -> option<T &> {
             if (is_some()) {
                 auto result = option<T &>{ storage.get() };
                 reset();
@@ -2492,8 +2682,8 @@ export namespace opt {
             return option<T &>{};
         }
 
-        constexpr auto unwrap() const -> T & {
-            if (is_none()) {
+        debug_inline constexpr auto unwrap(profile_site_only) const -> T & {
+            if (profile_none(unwrap, is_none())) [[hint_none(UNWRAP)]] {
                 throw option_panic("called `option::unwrap()` on a `none` value");
             }
             return storage.get();
@@ -2502,10 +2692,10 @@ export namespace opt {
         template <typename U = std::remove_cv_t<T>,
                   typename Ret = std::conditional_t<std::is_lvalue_reference_v<U>, std::common_reference_t<T &, U>,
                                                     std::remove_cvref_t<T>>>
-        constexpr Ret unwrap_or(U &&default_value) const
+        debug_inline constexpr Ret unwrap_or(U &&default_value profile_site) const
             requires std::convertible_to<T &, Ret> && std::convertible_to<U, Ret>
         {
-            if (is_some()) [[likely]] {
+            if (profile_some(unwrap_or, is_some())) [[hint_some(UNWRAP_OR)]] {
                 return storage.get();
             }
             return std::forward<U>(default_value);
@@ -2516,16 +2706,16 @@ export namespace opt {
         template <std::invocable F, typename RF = std::invoke_result_t<F>,
                   typename Ret = std::conditional_t<std::is_lvalue_reference_v<RF>, std::common_reference_t<T &, RF>,
                                                     std::remove_cvref_t<T>>>
-        constexpr Ret unwrap_or_else(F &&f) const
+        debug_inline constexpr Ret unwrap_or_else(F &&f profile_site) const
             requires std::convertible_to<T &, Ret> && std::convertible_to<RF, Ret>
         {
-            if (is_some()) {
+            if (profile_some(unwrap_or, is_some())) [[hint_some(UNWRAP_OR)]] {
                 return storage.get();
             }
             return std::invoke(std::forward<F>(f));
         }
 
-        constexpr auto unwrap_unchecked() const noexcept -> T & {
+        debug_inline constexpr auto unwrap_unchecked() const noexcept -> T & {
             return storage.get();
         }
 
@@ -2747,5 +2937,21 @@ export namespace opt {
 
 #pragma pop_macro("force_inline")
 #pragma pop_macro("hot_path")
+#pragma pop_macro("debug_inline")
 #pragma pop_macro("cpp20_no_unique_address")
 #pragma pop_macro("has_cpp_lib_optional_ref")
+#pragma pop_macro("stats_record")
+#pragma pop_macro("stats_record_if")
+#pragma pop_macro("stats_record_value")
+#pragma pop_macro("stats_check")
+#pragma pop_macro("hint_some")
+#pragma pop_macro("hint_none")
+#pragma pop_macro("hint_none_impl")
+#pragma pop_macro("hint_none_paste")
+#pragma pop_macro("hint_none_of_likely")
+#pragma pop_macro("hint_none_of_unlikely")
+#pragma pop_macro("hint_none_of_")
+#pragma pop_macro("profile_site")
+#pragma pop_macro("profile_site_only")
+#pragma pop_macro("profile_some")
+#pragma pop_macro("profile_none")
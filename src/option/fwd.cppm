@@ -18,6 +18,12 @@ export namespace opt {
     class option;
 
     namespace detail {
+        // The payloads of `core::option`: kept equal to `core::detail::payload` in
+        // :core, which test_unit checks.
+        template <typename T>
+        concept core_payload = std::is_trivially_copyable_v<T> && !std::is_array_v<T>
+                            && std::is_same_v<std::remove_cv_t<T>, T>;
+
         template <typename T, template <typename...> typename Template>
         constexpr bool is_specialization_of_v = false;
 
@@ -0,0 +1,116 @@
+export module option:masked_column;
+
+import std;
+import :fwd;
+import :classes;
+
+export namespace opt {
+    template <typename T>
+    class masked_column {
+    public:
+        using value_type = T;
+
+        static_assert(std::default_initializable<T> && std::copyable<T>,
+                      "opt::masked_column: `T` must be default-initializable and copyable");
+
+        static constexpr std::size_t word_bits = 64;
+
+        constexpr masked_column() = default;
+
+        // `n` rows, all `none`.
+        constexpr explicit masked_column(std::size_t n) : data(n), mask(words_for(n)) {}
+
+        template <typename R>
+            requires std::ranges::input_range<R> && std::same_as<std::ranges::range_value_t<R>, option<T>>
+        constexpr explicit masked_column(const R &options) {
+            if constexpr (std::ranges::sized_range<R>) {
+                data.reserve(std::ranges::size(options));
+                mask.reserve(words_for(std::ranges::size(options)));
+            }
+            for (const option<T> &o : options) {
+                if (data.size() % word_bits == 0) {
+                    mask.push_back(0);
+                }
+                if (o.is_some()) {
+                    mask.back() |= bit_of(data.size());
+                    data.push_back(*o);
+                } else {
+                    data.emplace_back();
+                }
+            }
+        }
+
+        constexpr auto size() const noexcept -> std::size_t {
+            return data.size();
+        }
+
+        constexpr auto is_some(std::size_t i) const noexcept -> bool {
+            return (mask[i / word_bits] & bit_of(i)) != 0;
+        }
+
+        constexpr auto get(std::size_t i) const noexcept -> option<const T &> {
+            return is_some(i) ? option<const T &>{ data[i] } : option<const T &>{};
+        }
+
+        constexpr void set(std::size_t i, const T &value) {
+            data[i] = value;
+            mask[i / word_bits] |= bit_of(i);
+        }
+
+        constexpr void reset(std::size_t i) noexcept {
+            mask[i / word_bits] &= ~bit_of(i);
+        }
+
+        // The number of present rows.
+        constexpr auto count() const noexcept -> std::size_t {
+            std::size_t n = 0;
+            for (const std::uint64_t word : mask) {
+                n += static_cast<std::size_t>(std::popcount(word));
+            }
+            return n;
+        }
+
+        constexpr auto values() noexcept -> std::span<T> {
+            return data;
+        }
+
+        constexpr auto values() const noexcept -> std::span<const T> {
+            return data;
+        }
+
+        // Changing the validity words directly must keep the bits past `size()` 0.
+        constexpr auto validity() noexcept -> std::span<std::uint64_t> {
+            return mask;
+        }
+
+        constexpr auto validity() const noexcept -> std::span<const std::uint64_t> {
+            return mask;
+        }
+
+        constexpr auto to_options() const -> std::vector<option<T>> {
+            std::vector<option<T>> options(data.size());
+            for (std::size_t i = 0; i < data.size(); ++i) {
+                if (is_some(i)) {
+                    options[i].insert(data[i]);
+                }
+            }
+            return options;
+        }
+
+        static constexpr auto words_for(std::size_t n) noexcept -> std::size_t {
+            return (n + word_bits - 1) / word_bits;
+        }
+
+    private:
+        std::vector<T> data;
+        std::vector<std::uint64_t> mask;
+
+        static constexpr auto bit_of(std::size_t i) noexcept -> std::uint64_t {
+            return std::uint64_t{ 1 } << (i % word_bits);
+        }
+    };
+
+    template <typename R>
+        requires std::ranges::input_range<R>
+    masked_column(const R &) -> masked_column<typename std::ranges::range_value_t<R>::value_type>;
+} // namespace opt
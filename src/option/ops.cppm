@@ -3,6 +3,7 @@ export module option:ops;
 import std;
 import :fwd;
 import :classes;
+import :core;
 import :none;
 
 export template <class T>
@@ -240,9 +241,10 @@ export namespace opt {
     // https://eel.is/c++draft/optional.comp.with.t#lib:operator==,optional
     template <class T, class U>
     constexpr bool operator==(const option<T> &x, const U &v) noexcept(noexcept(static_cast<bool>(*x == v)))
-        requires (!detail::specialization_of<U, std::optional>) && (!detail::specialization_of<U, option>) && requires {
-            { *x == v } -> std::convertible_to<bool>;
-        }
+        requires (!detail::specialization_of<U, std::optional>) && (!detail::specialization_of<U, option>)
+              && (!detail::specialization_of<U, core::option>) && requires {
+                     { *x == v } -> std::convertible_to<bool>;
+                 }
     {
         // LWG 4370
         // return x.has_value() ? *x == v : false;
@@ -254,9 +256,10 @@ export namespace opt {
     // https://eel.is/c++draft/optional.comp.with.t#lib:operator==,optional_
     template <class T, class U>
     constexpr bool operator==(const T &v, const option<U> &x) noexcept(noexcept(static_cast<bool>(v == *x)))
-        requires (!detail::specialization_of<U, std::optional>) && (!detail::specialization_of<U, option>) && requires {
-            { v == *x } -> std::convertible_to<bool>;
-        }
+        requires (!detail::specialization_of<U, std::optional>) && (!detail::specialization_of<U, option>)
+              && (!detail::specialization_of<U, core::option>) && requires {
+                     { v == *x } -> std::convertible_to<bool>;
+                 }
     {
         // LWG 4370
         // return x.has_value() ? v == *x : false;
@@ -268,9 +271,10 @@ export namespace opt {
     // https://eel.is/c++draft/optional.comp.with.t#lib:operator!=,optional
     template <class T, class U>
     constexpr bool operator!=(const option<T> &x, const U &v) noexcept(noexcept(static_cast<bool>(*x != v)))
-        requires (!detail::specialization_of<U, std::optional>) && (!detail::specialization_of<U, option>) && requires {
-            { *x != v } -> std::convertible_to<bool>;
-        }
+        requires (!detail::specialization_of<U, std::optional>) && (!detail::specialization_of<U, option>)
+              && (!detail::specialization_of<U, core::option>) && requires {
+                     { *x != v } -> std::convertible_to<bool>;
+                 }
     {
         // LWG 4370
         // return x.has_value() ? *x != v : true;
@@ -282,9 +286,10 @@ export namespace opt {
     // https://eel.is/c++draft/optional.comp.with.t#lib:operator!=,optional_
     template <class T, class U>
     constexpr bool operator!=(const T &v, const option<U> &x) noexcept(noexcept(static_cast<bool>(v != *x)))
-        requires (!detail::specialization_of<U, std::optional>) && (!detail::specialization_of<U, option>) && requires {
-            { v != *x } -> std::convertible_to<bool>;
-        }
+        requires (!detail::specialization_of<U, std::optional>) && (!detail::specialization_of<U, option>)
+              && (!detail::specialization_of<U, core::option>) && requires {
+                     { v != *x } -> std::convertible_to<bool>;
+                 }
     {
         // LWG 4370
         // return x.has_value() ? v != *x : true;
@@ -296,9 +301,10 @@ export namespace opt {
     // https://eel.is/c++draft/optional.comp.with.t#lib:operator%3c,optional
     template <class T, class U>
     constexpr bool operator<(const option<T> &x, const U &v)
-        requires (!detail::specialization_of<U, std::optional>) && (!detail::specialization_of<U, option>) && requires {
-            { *x < v } -> std::convertible_to<bool>;
-        }
+        requires (!detail::specialization_of<U, std::optional>) && (!detail::specialization_of<U, option>)
+              && (!detail::specialization_of<U, core::option>) && requires {
+                     { *x < v } -> std::convertible_to<bool>;
+                 }
     {
         // LWG 4370
         // return x.has_value() ? *x < v : true;
@@ -310,9 +316,10 @@ export namespace opt {
     // https://eel.is/c++draft/optional.comp.with.t#lib:operator%3c,optional_
     template <class T, class U>
     constexpr bool operator<(const T &v, const option<U> &x)
-        requires (!detail::specialization_of<U, std::optional>) && (!detail::specialization_of<U, option>) && requires {
-            { v < *x } -> std::convertible_to<bool>;
-        }
+        requires (!detail::specialization_of<U, std::optional>) && (!detail::specialization_of<U, option>)
+              && (!detail::specialization_of<U, core::option>) && requires {
+                     { v < *x } -> std::convertible_to<bool>;
+                 }
     {
         // LWG 4370
         // return x.has_value() ? v < *x : false;
@@ -324,9 +331,10 @@ export namespace opt {
     // https://eel.is/c++draft/optional.comp.with.t#lib:operator%3e,optional
     template <class T, class U>
     constexpr bool operator>(const option<T> &x, const U &v)
-        requires (!detail::specialization_of<U, std::optional>) && (!detail::specialization_of<U, option>) && requires {
-            { *x > v } -> std::convertible_to<bool>;
-        }
+        requires (!detail::specialization_of<U, std::optional>) && (!detail::specialization_of<U, option>)
+              && (!detail::specialization_of<U, core::option>) && requires {
+                     { *x > v } -> std::convertible_to<bool>;
+                 }
     {
         // LWG 4370
         // return x.has_value() ? *x > v : false;
@@ -338,9 +346,10 @@ export namespace opt {
     // https://eel.is/c++draft/optional.comp.with.t#lib:operator%3e,optional_
     template <class T, class U>
     constexpr bool operator>(const T &v, const option<U> &x)
-        requires (!detail::specialization_of<U, std::optional>) && (!detail::specialization_of<U, option>) && requires {
-            { v > *x } -> std::convertible_to<bool>;
-        }
+        requires (!detail::specialization_of<U, std::optional>) && (!detail::specialization_of<U, option>)
+              && (!detail::specialization_of<U, core::option>) && requires {
+                     { v > *x } -> std::convertible_to<bool>;
+                 }
     {
         // LWG 4370
         // return x.has_value() ? v > *x : true;
@@ -352,9 +361,10 @@ export namespace opt {
     // https://eel.is/c++draft/optional.comp.with.t#lib:operator%3c=,optional
     template <class T, class U>
     constexpr bool operator<=(const option<T> &x, const U &v)
-        requires (!detail::specialization_of<U, std::optional>) && (!detail::specialization_of<U, option>) && requires {
-            { *x <= v } -> std::convertible_to<bool>;
-        }
+        requires (!detail::specialization_of<U, std::optional>) && (!detail::specialization_of<U, option>)
+              && (!detail::specialization_of<U, core::option>) && requires {
+                     { *x <= v } -> std::convertible_to<bool>;
+                 }
     {
         // LWG 4370
         // return x.has_value() ? *x <= v : true;
@@ -366,9 +376,10 @@ export namespace opt {
     // https://eel.is/c++draft/optional.comp.with.t#lib:operator%3c=,optional_
     template <class T, class U>
     constexpr bool operator<=(const T &v, const option<U> &x)
-        requires (!detail::specialization_of<U, std::optional>) && (!detail::specialization_of<U, option>) && requires {
-            { v <= *x } -> std::convertible_to<bool>;
-        }
+        requires (!detail::specialization_of<U, std::optional>) && (!detail::specialization_of<U, option>)
+              && (!detail::specialization_of<U, core::option>) && requires {
+                     { v <= *x } -> std::convertible_to<bool>;
+                 }
     {
         // LWG 4370
         // return x.has_value() ? v <= *x : false;
@@ -380,9 +391,10 @@ export namespace opt {
     // https://eel.is/c++draft/optional.comp.with.t#lib:operator%3e=,optional
     template <class T, class U>
     constexpr bool operator>=(const option<T> &x, const U &v)
-        requires (!detail::specialization_of<U, std::optional>) && (!detail::specialization_of<U, option>) && requires {
-            { *x >= v } -> std::convertible_to<bool>;
-        }
+        requires (!detail::specialization_of<U, std::optional>) && (!detail::specialization_of<U, option>)
+              && (!detail::specialization_of<U, core::option>) && requires {
+                     { *x >= v } -> std::convertible_to<bool>;
+                 }
     {
         // LWG 4370
         // return x.has_value() ? *x >= v : false;
@@ -394,9 +406,10 @@ export namespace opt {
     // https://eel.is/c++draft/optional.comp.with.t#lib:operator%3e=,optional_
     template <class T, class U>
     constexpr bool operator>=(const T &v, const option<U> &x)
-        requires (!detail::specialization_of<U, std::optional>) && (!detail::specialization_of<U, option>) && requires {
-            { v >= *x } -> std::convertible_to<bool>;
-        }
+        requires (!detail::specialization_of<U, std::optional>) && (!detail::specialization_of<U, option>)
+              && (!detail::specialization_of<U, core::option>) && requires {
+                     { v >= *x } -> std::convertible_to<bool>;
+                 }
     {
         // LWG 4370
         // return x.has_value() ? v >= *x : true;
@@ -408,7 +421,7 @@ export namespace opt {
     // https://eel.is/c++draft/optional.comp.with.t#lib:operator%3c=%3e,optional
     template <class T, class U>
     constexpr std::compare_three_way_result_t<T, U> operator<=>(const option<T> &x, const U &v)
-        requires (!detail::is_derived_from_optional<U>)
+        requires (!detail::is_derived_from_optional<U>) && (!detail::specialization_of<U, core::option>)
               // https://gcc.gnu.org/bugzilla/show_bug.cgi?id=104606
               // prevent recursive `<=>` checks
               && requires { typename std::compare_three_way_result_t<T, U>; }
@@ -0,0 +1,346 @@
+module;
+
+#include <cstdio> // stderr
+
+#ifdef OPT_OPTION_HINTS_HEADER
+    #include OPT_OPTION_HINTS_HEADER
+#endif
+
+#ifndef OPT_OPTION_PROFILE_PERIOD
+    #define OPT_OPTION_PROFILE_PERIOD 16
+#endif
+
+#ifndef OPT_OPTION_PROFILE_SITES
+    #define OPT_OPTION_PROFILE_SITES 4096
+#endif
+
+#pragma push_macro("hint_string")
+#pragma push_macro("hint_string_impl")
+#undef hint_string
+#undef hint_string_impl
+#define hint_string(h)      hint_string_impl(h)
+#define hint_string_impl(h) #h
+
+export module option:profiler;
+
+import std;
+
+// Opt-in call-site profiler for the presence checks of `option<T>`.
+//
+// Compile with `OPT_OPTION_PROFILE=1` and the `unwrap`, `unwrap_or` and
+// `get_or_insert` families of `option<T>` and `option<T &>` take a defaulted
+// `std::source_location` and report whether they found a value there. Roughly one
+// call in `OPT_OPTION_PROFILE_PERIOD` (randomized per thread so that loops do not
+// alias with the period) is recorded into a fixed-size, lock-free hash table keyed
+// by call site.
+//
+// `opt::profiler::dump()` ranks the sites by how often they went against the
+// branch hint of the method they called, and `opt::profiler::write_hints()` turns
+// the profile into a header that overrides those hints (`OPT_OPTION_HINT_*`).
+// Rebuild with `OPT_OPTION_HINTS_HEADER` naming that header to apply it.
+//
+// With the switch off (the default) the methods in `:classes` keep their usual
+// signatures and this partition only provides the (empty) reporting functions.
+
+export namespace opt::profiler {
+    // The method families that share one branch hint.
+    enum class site_kind : std::uint8_t {
+        unwrap,        // `unwrap`, `expect`
+        unwrap_or,     // `unwrap_or`, `unwrap_or_default`, `unwrap_or_else`
+        get_or_insert, // `get_or_insert`, `get_or_insert_default`, `get_or_insert_with`
+    };
+
+    inline constexpr std::size_t site_kind_count = 3;
+
+    inline constexpr std::array<std::string_view, site_kind_count> site_kind_names{
+        "unwrap",
+        "unwrap_or",
+        "get_or_insert",
+    };
+
+    inline constexpr std::array<std::string_view, site_kind_count> hint_macro_names{
+        "OPT_OPTION_HINT_UNWRAP",
+        "OPT_OPTION_HINT_UNWRAP_OR",
+        "OPT_OPTION_HINT_GET_OR_INSERT",
+    };
+
+    // A branch hint on the path that found a value.
+    enum class hint : std::uint8_t {
+        none,
+        likely,
+        unlikely,
+    };
+
+    inline constexpr std::array<std::string_view, 3> hint_names{ "", "likely", "unlikely" };
+
+    inline constexpr std::uint32_t sample_period = OPT_OPTION_PROFILE_PERIOD;
+
+    inline constexpr std::size_t site_capacity = OPT_OPTION_PROFILE_SITES;
+
+    static_assert(sample_period > 0, "OPT_OPTION_PROFILE_PERIOD must be positive");
+    static_assert(site_capacity > 0 && (site_capacity & (site_capacity - 1)) == 0,
+                  "OPT_OPTION_PROFILE_SITES must be a power of two");
+
+    namespace detail {
+        constexpr auto parse_hint(std::string_view s) noexcept -> hint {
+            if (s == "likely") {
+                return hint::likely;
+            }
+            if (s == "unlikely") {
+                return hint::unlikely;
+            }
+            return hint::none;
+        }
+    } // namespace detail
+
+    // The hints this translation unit was compiled with.
+    inline constexpr std::array<hint, site_kind_count> current_hints{
+#ifdef OPT_OPTION_HINT_UNWRAP
+        detail::parse_hint(hint_string(OPT_OPTION_HINT_UNWRAP)),
+#else
+        hint::likely,
+#endif
+#ifdef OPT_OPTION_HINT_UNWRAP_OR
+        detail::parse_hint(hint_string(OPT_OPTION_HINT_UNWRAP_OR)),
+#else
+        hint::likely,
+#endif
+#ifdef OPT_OPTION_HINT_GET_OR_INSERT
+        detail::parse_hint(hint_string(OPT_OPTION_HINT_GET_OR_INSERT)),
+#else
+        hint::likely,
+#endif
+    };
+
+    // The hint a profile with the given share of empty outcomes calls for. Sites
+    // in between are left unhinted: no static layout suits a coin flip.
+    constexpr auto suggest_hint(double none_ratio) noexcept -> hint {
+        if (none_ratio <= 1.0 / 3.0) {
+            return hint::likely;
+        }
+        if (none_ratio >= 2.0 / 3.0) {
+            return hint::unlikely;
+        }
+        return hint::none;
+    }
+
+    struct site_profile {
+        std::source_location location;
+        site_kind kind;
+        std::uint64_t some = 0; // sampled calls that found a value
+        std::uint64_t none = 0; // sampled calls that found none
+
+        constexpr auto samples() const noexcept -> std::uint64_t {
+            return some + none;
+        }
+
+        // Estimated number of calls, sampled calls scaled by the sample period.
+        constexpr auto calls() const noexcept -> std::uint64_t {
+            return samples() * sample_period;
+        }
+
+        constexpr auto none_ratio() const noexcept -> double {
+            return samples() == 0 ? 0.0 : static_cast<double>(none) / static_cast<double>(samples());
+        }
+
+        constexpr auto current_hint() const noexcept -> hint {
+            return current_hints[static_cast<std::size_t>(kind)];
+        }
+
+        constexpr auto suggested_hint() const noexcept -> hint {
+            return suggest_hint(none_ratio());
+        }
+
+        // Estimated calls that took the path the current hint marks as unexpected;
+        // without a hint, the rarer path. This is what the site is ranked by.
+        constexpr auto against_hint() const noexcept -> std::uint64_t {
+            switch (current_hint()) {
+            case hint::likely:
+                return none * sample_period;
+            case hint::unlikely:
+                return some * sample_period;
+            case hint::none:
+                break;
+            }
+            return std::min(some, none) * sample_period;
+        }
+    };
+
+    namespace detail {
+        struct site_slot {
+            std::atomic<std::uint64_t> key{ 0 };
+            std::atomic<bool> ready{ false };
+            std::source_location location;
+            site_kind kind{};
+            std::atomic<std::uint64_t> some{ 0 };
+            std::atomic<std::uint64_t> none{ 0 };
+        };
+
+        inline site_slot site_table[site_capacity];
+
+        // Samples that found the table full.
+        inline std::atomic<std::uint64_t> dropped{ 0 };
+
+        // FNV-1a over the file name, so that a site compiled into several
+        // translation units is counted once, mixed with line, column and kind.
+        inline auto site_key(site_kind kind, const std::source_location &site) noexcept -> std::uint64_t {
+            std::uint64_t h = 14695981039346656037ull;
+            for (const char *p = site.file_name(); *p != '\0'; ++p) {
+                h = (h ^ static_cast<unsigned char>(*p)) * 1099511628211ull;
+            }
+            h ^= (static_cast<std::uint64_t>(site.line()) << 32) ^ (static_cast<std::uint64_t>(site.column()) << 8)
+               ^ static_cast<std::uint64_t>(kind);
+            h ^= h >> 33;
+            h *= 0xff51afd7ed558ccdull;
+            h ^= h >> 33;
+            return h == 0 ? 1 : h;
+        }
+
+        inline void record_sample(site_kind kind, const std::source_location &site, bool some) noexcept {
+            const auto key = site_key(kind, site);
+            for (std::size_t probe = 0, i = key & (site_capacity - 1); probe < site_capacity;
+                 ++probe, i        = (i + 1) & (site_capacity - 1)) {
+                auto &slot     = site_table[i];
+                auto  existing = slot.key.load(std::memory_order_relaxed);
+                if (existing == 0) {
+                    if (slot.key.compare_exchange_strong(existing, key, std::memory_order_relaxed)) {
+                        slot.location = site;
+                        slot.kind     = kind;
+                        slot.ready.store(true, std::memory_order_release);
+                        existing = key;
+                    }
+                }
+                if (existing == key) {
+                    (some ? slot.some : slot.none).fetch_add(1, std::memory_order_relaxed);
+                    return;
+                }
+            }
+            dropped.fetch_add(1, std::memory_order_relaxed);
+        }
+
+        // Thread-local countdown to the next sample, redrawn uniformly from
+        // `[1, 2 * sample_period - 1]` so that the mean interval is the period.
+        inline auto take_sample() noexcept -> bool {
+            if constexpr (sample_period == 1) {
+                return true;
+            } else {
+                thread_local std::uint32_t countdown = 1;
+                thread_local std::uint64_t state     = 0;
+                if (--countdown != 0) [[likely]] {
+                    return false;
+                }
+                if (state == 0) {
+                    state = reinterpret_cast<std::uintptr_t>(&state) | 1;
+                }
+                state ^= state << 13;
+                state ^= state >> 7;
+                state ^= state << 17;
+                countdown = 1 + static_cast<std::uint32_t>(state % (2 * sample_period - 1));
+                return true;
+            }
+        }
+
+        constexpr auto record_some(site_kind kind, const std::source_location &site, bool some) noexcept -> bool {
+            if !consteval {
+                if (take_sample()) {
+                    record_sample(kind, site, some);
+                }
+            }
+            return some;
+        }
+
+        constexpr auto record_none(site_kind kind, const std::source_location &site, bool none) noexcept -> bool {
+            return !record_some(kind, site, !none);
+        }
+    } // namespace detail
+
+    // Returns every call site sampled so far, most calls against the current
+    // hint first.
+    inline auto profile() -> std::vector<site_profile> {
+        std::vector<site_profile> result;
+        for (const auto &slot : detail::site_table) {
+            if (!slot.ready.load(std::memory_order_acquire)) {
+                continue;
+            }
+            result.push_back(site_profile{
+                .location = slot.location,
+                .kind     = slot.kind,
+                .some     = slot.some.load(std::memory_order_relaxed),
+                .none     = slot.none.load(std::memory_order_relaxed),
+            });
+        }
+
+        std::ranges::sort(result, [](const site_profile &a, const site_profile &b) {
+            if (a.against_hint() != b.against_hint()) {
+                return a.against_hint() > b.against_hint();
+            }
+            return a.samples() > b.samples();
+        });
+        return result;
+    }
+
+    // Returns the number of samples lost because the site table was full.
+    inline auto dropped_samples() noexcept -> std::uint64_t {
+        return detail::dropped.load(std::memory_order_relaxed);
+    }
+
+    // Zeroes the counts of every site. Sites stay registered.
+    inline void reset() noexcept {
+        for (auto &slot : detail::site_table) {
+            slot.some.store(0, std::memory_order_relaxed);
+            slot.none.store(0, std::memory_order_relaxed);
+        }
+        detail::dropped.store(0, std::memory_order_relaxed);
+    }
+
+    // Prints the profile, one line per call site, in the order of `profile()`.
+    inline void dump(std::FILE *out = stderr) {
+        const auto sites = profile();
+
+        std::string report = std::format("{:<14} {:>12} {:>7} {:>9} {:>9} {:>12}  {}\n", "kind", "calls~", "none%",
+                                         "hint", "suggest", "against~", "site");
+        for (const auto &s : sites) {
+            report += std::format("{:<14} {:>12} {:>6.1f}% {:>9} {:>9} {:>12}  {}:{}:{} ({})\n",
+                                  site_kind_names[static_cast<std::size_t>(s.kind)], s.calls(), s.none_ratio() * 100.0,
+                                  hint_names[static_cast<std::size_t>(s.current_hint())],
+                                  hint_names[static_cast<std::size_t>(s.suggested_hint())], s.against_hint(),
+                                  s.location.file_name(), s.location.line(), s.location.column(),
+                                  s.location.function_name());
+        }
+        if (const auto lost = dropped_samples(); lost != 0) {
+            report += std::format("{} samples dropped, raise OPT_OPTION_PROFILE_SITES\n", lost);
+        }
+        std::fputs(report.c_str(), out);
+    }
+
+    // Writes a header that sets every `OPT_OPTION_HINT_*` from the profile. The
+    // hints live in the methods rather than at the call sites, so each method
+    // family gets the hint suggested by the outcomes of all its sites together.
+    // Families without samples keep the hint of this build.
+    inline void write_hints(std::FILE *out) {
+        std::array<std::uint64_t, site_kind_count> some{};
+        std::array<std::uint64_t, site_kind_count> none{};
+        std::array<std::size_t, site_kind_count> sites{};
+        for (const auto &s : profile()) {
+            const auto k = static_cast<std::size_t>(s.kind);
+            some[k] += s.some;
+            none[k] += s.none;
+            ++sites[k];
+        }
+
+        std::string header = "// Generated by opt::profiler::write_hints().\n"
+                             "// Build with -DOPT_OPTION_HINTS_HEADER=\"<this file>\" to apply.\n";
+        for (std::size_t k = 0; k < site_kind_count; ++k) {
+            const auto samples = some[k] + none[k];
+            const auto ratio   = samples == 0 ? 0.0 : static_cast<double>(none[k]) / static_cast<double>(samples);
+            const auto chosen  = samples == 0 ? current_hints[k] : suggest_hint(ratio);
+            header += std::format("#ifndef {0}\n    #define {0} {1} // {2:.1f}% none, {3} sites, {4} samples\n#endif\n",
+                                  hint_macro_names[k], hint_names[static_cast<std::size_t>(chosen)], ratio * 100.0,
+                                  sites[k], samples);
+        }
+        std::fputs(header.c_str(), out);
+    }
+} // namespace opt::profiler
+
+#pragma pop_macro("hint_string")
+#pragma pop_macro("hint_string_impl")
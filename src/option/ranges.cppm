@@ -0,0 +1,580 @@
+module;
+
+#pragma push_macro("cpp20_no_unique_address")
+#undef cpp20_no_unique_address
+#if __has_cpp_attribute(msvc::no_unique_address)
+    #define cpp20_no_unique_address [[msvc::no_unique_address]]
+#else
+    #define cpp20_no_unique_address [[no_unique_address]]
+#endif
+
+#ifndef OPT_OPTION_SIMD
+    #define OPT_OPTION_SIMD 1
+#endif
+
+#if OPT_OPTION_SIMD && (defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2))
+    #include <immintrin.h>
+    #define OPT_OPTION_SIMD_X86 1
+#else
+    #define OPT_OPTION_SIMD_X86 0
+#endif
+
+export module option:ranges;
+
+import std;
+import :fwd;
+import :classes;
+
+export namespace opt {
+    namespace detail {
+        // Ranges whose elements can be returned as `option<range_reference_t<R>>`
+        // without dangling.
+        template <typename R>
+        concept searchable_range =
+            std::ranges::input_range<R> && std::ranges::borrowed_range<R>
+            && (std::is_lvalue_reference_v<std::ranges::range_reference_t<R>>
+                || !std::is_reference_v<std::ranges::range_reference_t<R>>);
+
+        template <typename R>
+        using search_result = option<std::ranges::range_reference_t<R>>;
+
+        template <typename R, typename I>
+        constexpr auto found(I &&it) -> search_result<R> {
+            return search_result<R>{ *std::forward<I>(it) };
+        }
+
+        // Contiguous ranges of plain numbers, which `find` can compare a register
+        // at a time.
+        template <typename R, typename T>
+        concept simd_searchable =
+            std::ranges::contiguous_range<R> && std::ranges::sized_range<R>
+            && (std::integral<std::ranges::range_value_t<R>> || std::same_as<std::ranges::range_value_t<R>, float>
+                || std::same_as<std::ranges::range_value_t<R>, double>)
+            && std::same_as<std::remove_cvref_t<T>, std::ranges::range_value_t<R>>
+            && !std::is_volatile_v<std::remove_reference_t<std::ranges::range_reference_t<R>>>;
+
+#if OPT_OPTION_SIMD_X86
+    #if defined(__AVX2__)
+        using simd_vector = __m256i;
+        inline constexpr std::size_t simd_bytes = 32;
+    #else
+        using simd_vector = __m128i;
+        inline constexpr std::size_t simd_bytes = 16;
+    #endif
+
+        template <typename T>
+        auto simd_splat(T value) noexcept -> simd_vector {
+    #if defined(__AVX2__)
+            if constexpr (std::same_as<T, float>) {
+                return _mm256_castps_si256(_mm256_set1_ps(value));
+            } else if constexpr (std::same_as<T, double>) {
+                return _mm256_castpd_si256(_mm256_set1_pd(value));
+            } else if constexpr (sizeof(T) == 1) {
+                return _mm256_set1_epi8(std::bit_cast<char>(value));
+            } else if constexpr (sizeof(T) == 2) {
+                return _mm256_set1_epi16(std::bit_cast<short>(value));
+            } else if constexpr (sizeof(T) == 4) {
+                return _mm256_set1_epi32(std::bit_cast<int>(value));
+            } else {
+                return _mm256_set1_epi64x(std::bit_cast<long long>(value));
+            }
+    #else
+            if constexpr (std::same_as<T, float>) {
+                return _mm_castps_si128(_mm_set1_ps(value));
+            } else if constexpr (std::same_as<T, double>) {
+                return _mm_castpd_si128(_mm_set1_pd(value));
+            } else if constexpr (sizeof(T) == 1) {
+                return _mm_set1_epi8(std::bit_cast<char>(value));
+            } else if constexpr (sizeof(T) == 2) {
+                return _mm_set1_epi16(std::bit_cast<short>(value));
+            } else if constexpr (sizeof(T) == 4) {
+                return _mm_set1_epi32(std::bit_cast<int>(value));
+            } else {
+                return _mm_set1_epi64x(std::bit_cast<long long>(value));
+            }
+    #endif
+        }
+
+        // One bit per byte of `p[0, simd_bytes / sizeof(T))`, set in every byte of
+        // the elements equal to the splatted `needle`.
+        template <typename T>
+        auto simd_equal_bytes(const T *p, simd_vector needle) noexcept -> std::uint32_t {
+    #if defined(__AVX2__)
+            const __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(p));
+            __m256i eq;
+            if constexpr (std::same_as<T, float>) {
+                const __m256 cmp = _mm256_cmp_ps(_mm256_castsi256_ps(v), _mm256_castsi256_ps(needle), _CMP_EQ_OQ);
+                eq = _mm256_castps_si256(cmp);
+            } else if constexpr (std::same_as<T, double>) {
+                const __m256d cmp = _mm256_cmp_pd(_mm256_castsi256_pd(v), _mm256_castsi256_pd(needle), _CMP_EQ_OQ);
+                eq = _mm256_castpd_si256(cmp);
+            } else if constexpr (sizeof(T) == 1) {
+                eq = _mm256_cmpeq_epi8(v, needle);
+            } else if constexpr (sizeof(T) == 2) {
+                eq = _mm256_cmpeq_epi16(v, needle);
+            } else if constexpr (sizeof(T) == 4) {
+                eq = _mm256_cmpeq_epi32(v, needle);
+            } else {
+                eq = _mm256_cmpeq_epi64(v, needle);
+            }
+            return static_cast<std::uint32_t>(_mm256_movemask_epi8(eq));
+    #else
+            const __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i *>(p));
+            __m128i eq;
+            if constexpr (std::same_as<T, float>) {
+                eq = _mm_castps_si128(_mm_cmpeq_ps(_mm_castsi128_ps(v), _mm_castsi128_ps(needle)));
+            } else if constexpr (std::same_as<T, double>) {
+                eq = _mm_castpd_si128(_mm_cmpeq_pd(_mm_castsi128_pd(v), _mm_castsi128_pd(needle)));
+            } else if constexpr (sizeof(T) == 1) {
+                eq = _mm_cmpeq_epi8(v, needle);
+            } else if constexpr (sizeof(T) == 2) {
+                eq = _mm_cmpeq_epi16(v, needle);
+            } else if constexpr (sizeof(T) == 4) {
+                eq = _mm_cmpeq_epi32(v, needle);
+            } else {
+                // SSE2 has no 64-bit compare: both 32-bit halves must match.
+                eq = _mm_cmpeq_epi32(v, needle);
+                eq = _mm_and_si128(eq, _mm_shuffle_epi32(eq, _MM_SHUFFLE(2, 3, 0, 1)));
+            }
+            return static_cast<std::uint32_t>(_mm_movemask_epi8(eq));
+    #endif
+        }
+
+        // The index of the first element of `[p, p + n)` equal to `value`, or `n`.
+        template <typename T>
+        auto simd_find(const T *p, std::size_t n, T value) noexcept -> std::size_t {
+            constexpr std::size_t lanes = simd_bytes / sizeof(T);
+            const simd_vector needle = simd_splat(value);
+            std::size_t i = 0;
+            // Four registers per step, tested together: one branch per 64 or 128 bytes.
+            for (; i + 4 * lanes <= n; i += 4 * lanes) {
+                const std::uint32_t m0 = simd_equal_bytes(p + i, needle);
+                const std::uint32_t m1 = simd_equal_bytes(p + i + lanes, needle);
+                const std::uint32_t m2 = simd_equal_bytes(p + i + 2 * lanes, needle);
+                const std::uint32_t m3 = simd_equal_bytes(p + i + 3 * lanes, needle);
+                if ((m0 | m1 | m2 | m3) != 0) {
+                    break;
+                }
+            }
+            for (; i + lanes <= n; i += lanes) {
+                if (const std::uint32_t mask = simd_equal_bytes(p + i, needle); mask != 0) {
+                    return i + static_cast<std::size_t>(std::countr_zero(mask)) / sizeof(T);
+                }
+            }
+            for (; i < n; ++i) {
+                if (p[i] == value) {
+                    return i;
+                }
+            }
+            return n;
+        }
+#endif
+
+        // Asks for the cache line at `address`. It never faults, so the address may
+        // lie past the end of the data.
+        inline void prefetch(std::uintptr_t address) noexcept {
+#if defined(__GNUC__) || defined(__clang__)
+            __builtin_prefetch(reinterpret_cast<const void *>(address));
+#elif OPT_OPTION_SIMD_X86
+            _mm_prefetch(reinterpret_cast<const char *>(address), _MM_HINT_T0);
+#else
+            static_cast<void>(address);
+#endif
+        }
+
+        // Allocates on cache-line boundaries, so that a prefetch computed from
+        // the start of the storage covers exactly the nodes it is meant for.
+        template <typename T>
+        struct line_allocator {
+            using value_type = T;
+
+            static constexpr std::size_t alignment = alignof(T) > 64 ? alignof(T) : 64;
+
+            line_allocator() = default;
+
+            template <typename U>
+            constexpr line_allocator(const line_allocator<U> &) noexcept {}
+
+            auto allocate(std::size_t n) -> T * {
+                return static_cast<T *>(::operator new(n * sizeof(T), std::align_val_t{ alignment }));
+            }
+
+            void deallocate(T *p, std::size_t n) noexcept {
+                ::operator delete(p, n * sizeof(T), std::align_val_t{ alignment });
+            }
+
+            friend constexpr auto operator==(const line_allocator &, const line_allocator &) noexcept -> bool {
+                return true;
+            }
+        };
+
+        // Branch-free lower bound over `[first, first + n)`: the loop runs
+        // `ceil(log2(n))` times whatever the data, and each step is a conditional
+        // move instead of a branch the predictor misses half of the time. Over
+        // contiguous memory, each step also prefetches both possible next probes.
+        template <typename I, typename K, typename Compare>
+        constexpr auto lower_bound_index(I first, std::size_t n, const K &key, Compare &comp) -> std::size_t {
+            if (n == 0) {
+                return 0;
+            }
+            std::size_t base = 0;
+            while (n > 1) {
+                const std::size_t half = n / 2;
+                if constexpr (std::contiguous_iterator<I>) {
+                    if !consteval {
+                        // Both candidates for the next probe, one of which is needed.
+                        const auto address = reinterpret_cast<std::uintptr_t>(std::to_address(first));
+                        const std::size_t size = sizeof(std::iter_value_t<I>);
+                        prefetch(address + (base + (n - half) / 2) * size);
+                        prefetch(address + (base + half + (n - half) / 2) * size);
+                    }
+                }
+                base = std::invoke(comp, first[static_cast<std::ptrdiff_t>(base + half)], key) ? base + half : base;
+                n -= half;
+            }
+            return base + static_cast<std::size_t>(std::invoke(comp, first[static_cast<std::ptrdiff_t>(base)], key));
+        }
+    } // namespace detail
+
+    namespace ranges {
+        // Returns the first element equal to `value`, or `none`.
+        template <typename R, typename T>
+            requires detail::searchable_range<R>
+                  && std::equality_comparable_with<std::ranges::range_reference_t<R>, const T &>
+        constexpr auto find(R &&r, const T &value) -> detail::search_result<R> {
+#if OPT_OPTION_SIMD_X86
+            if constexpr (detail::simd_searchable<R, T>) {
+                if !consteval {
+                    const std::size_t n = std::ranges::size(r);
+                    const std::size_t i = detail::simd_find(std::to_address(std::ranges::data(r)), n, value);
+                    if (i == n) {
+                        return detail::search_result<R>{};
+                    }
+                    return detail::found<R>(std::ranges::begin(r) + static_cast<std::ptrdiff_t>(i));
+                }
+            }
+#endif
+            auto it = std::ranges::find(r, value);
+            if (it == std::ranges::end(r)) {
+                return detail::search_result<R>{};
+            }
+            return detail::found<R>(it);
+        }
+
+        // Returns the first element that satisfies `predicate`, or `none`.
+        template <typename R, typename F>
+            requires detail::searchable_range<R>
+                  && std::indirect_unary_predicate<F, std::ranges::iterator_t<R>>
+        constexpr auto find_if(R &&r, F &&predicate) -> detail::search_result<R> {
+            auto it = std::ranges::find_if(r, std::ref(predicate));
+            if (it == std::ranges::end(r)) {
+                return detail::search_result<R>{};
+            }
+            return detail::found<R>(it);
+        }
+
+        // Applies `f` to the elements in order and returns the first `some` it
+        // returns, or `none`.
+        template <typename R, typename F>
+            requires std::ranges::input_range<R>
+                  && detail::option_type<std::invoke_result_t<F &, std::ranges::range_reference_t<R>>>
+        constexpr auto find_map(R &&r, F &&f)
+            -> std::remove_cvref_t<std::invoke_result_t<F &, std::ranges::range_reference_t<R>>> {
+            for (auto &&element : r) {
+                auto result = std::invoke(f, std::forward<decltype(element)>(element));
+                if (result.is_some()) {
+                    return result;
+                }
+            }
+            return {};
+        }
+
+        // Returns the index of the first element that satisfies `predicate`, or
+        // `none`.
+        template <typename R, typename F>
+            requires std::ranges::input_range<R> && std::indirect_unary_predicate<F, std::ranges::iterator_t<R>>
+        constexpr auto position(R &&r, F &&predicate) -> option<std::size_t> {
+            std::size_t i = 0;
+            for (auto it = std::ranges::begin(r); it != std::ranges::end(r); ++it, ++i) {
+                if (std::invoke(predicate, *it)) {
+                    return option<std::size_t>{ i };
+                }
+            }
+            return option<std::size_t>{};
+        }
+
+        // Returns the first element with the smallest `key(element)`, or `none` if
+        // the range is empty. Each key is computed once.
+        template <typename R, typename F>
+            requires detail::searchable_range<R> && std::ranges::forward_range<R>
+                  && std::totally_ordered<std::invoke_result_t<F &, std::ranges::range_reference_t<R>>>
+        constexpr auto min_by_key(R &&r, F &&key) -> detail::search_result<R> {
+            auto it = std::ranges::begin(r);
+            const auto last = std::ranges::end(r);
+            if (it == last) {
+                return detail::search_result<R>{};
+            }
+            auto best = it;
+            auto best_key = std::invoke(key, *it);
+            while (++it != last) {
+                auto k = std::invoke(key, *it);
+                if (k < best_key) {
+                    best = it;
+                    best_key = std::move(k);
+                }
+            }
+            return detail::found<R>(best);
+        }
+
+        // Returns the last element with the largest `key(element)`, or `none` if
+        // the range is empty. Each key is computed once.
+        template <typename R, typename F>
+            requires detail::searchable_range<R> && std::ranges::forward_range<R>
+                  && std::totally_ordered<std::invoke_result_t<F &, std::ranges::range_reference_t<R>>>
+        constexpr auto max_by_key(R &&r, F &&key) -> detail::search_result<R> {
+            auto it = std::ranges::begin(r);
+            const auto last = std::ranges::end(r);
+            if (it == last) {
+                return detail::search_result<R>{};
+            }
+            auto best = it;
+            auto best_key = std::invoke(key, *it);
+            while (++it != last) {
+                auto k = std::invoke(key, *it);
+                if (!(k < best_key)) {
+                    best = it;
+                    best_key = std::move(k);
+                }
+            }
+            return detail::found<R>(best);
+        }
+
+        // Returns the first element, or `none` if the range is empty.
+        template <typename R>
+            requires detail::searchable_range<R>
+        constexpr auto first(R &&r) -> detail::search_result<R> {
+            auto it = std::ranges::begin(r);
+            if (it == std::ranges::end(r)) {
+                return detail::search_result<R>{};
+            }
+            return detail::found<R>(it);
+        }
+
+        // Returns the last element, or `none` if the range is empty.
+        template <typename R>
+            requires detail::searchable_range<R> && std::ranges::forward_range<R>
+        constexpr auto last(R &&r) -> detail::search_result<R> {
+            auto it = std::ranges::begin(r);
+            const auto end = std::ranges::end(r);
+            if (it == end) {
+                return detail::search_result<R>{};
+            }
+            if constexpr (std::ranges::bidirectional_range<R> && std::ranges::common_range<R>) {
+                return detail::found<R>(std::ranges::prev(end));
+            } else {
+                for (auto next = std::ranges::next(it); next != end; ++next) {
+                    it = next;
+                }
+                return detail::found<R>(it);
+            }
+        }
+
+        // Returns the element at index `n`, or `none` if the range is shorter.
+        template <typename R>
+            requires detail::searchable_range<R>
+        constexpr auto nth(R &&r, std::size_t n) -> detail::search_result<R> {
+            if constexpr (std::ranges::sized_range<R>) {
+                if (n >= std::ranges::size(r)) {
+                    return detail::search_result<R>{};
+                }
+                return detail::found<R>(std::ranges::next(std::ranges::begin(r), static_cast<std::ptrdiff_t>(n)));
+            } else {
+                auto it = std::ranges::begin(r);
+                const auto end = std::ranges::end(r);
+                for (; n != 0 && it != end; --n) {
+                    ++it;
+                }
+                if (it == end) {
+                    return detail::search_result<R>{};
+                }
+                return detail::found<R>(it);
+            }
+        }
+
+        // Returns the index of an element equivalent to `key` in `r`, which must be
+        // sorted by `comp`, or `none`. See `detail::lower_bound_index`.
+        template <typename R, typename K, typename Compare = std::ranges::less>
+            requires std::ranges::random_access_range<R> && std::ranges::sized_range<R>
+                  && std::predicate<Compare &, std::ranges::range_reference_t<R>, const K &>
+                  && std::predicate<Compare &, const K &, std::ranges::range_reference_t<R>>
+        constexpr auto binary_position(R &&r, const K &key, Compare comp = {}) -> option<std::size_t> {
+            const auto first = std::ranges::begin(r);
+            const auto n = static_cast<std::size_t>(std::ranges::size(r));
+            const std::size_t i = detail::lower_bound_index(first, n, key, comp);
+            if (i == n || std::invoke(comp, key, first[static_cast<std::ptrdiff_t>(i)])) {
+                return option<std::size_t>{};
+            }
+            return option<std::size_t>{ i };
+        }
+
+        // Returns an element equivalent to `key` in `r`, which must be sorted by
+        // `comp`, or `none`.
+        template <typename R, typename K, typename Compare = std::ranges::less>
+            requires detail::searchable_range<R> && std::ranges::random_access_range<R> && std::ranges::sized_range<R>
+                  && std::predicate<Compare &, std::ranges::range_reference_t<R>, const K &>
+                  && std::predicate<Compare &, const K &, std::ranges::range_reference_t<R>>
+        constexpr auto binary_find(R &&r, const K &key, Compare comp = {}) -> detail::search_result<R> {
+            const auto at = [&](std::size_t i) {
+                return detail::found<R>(std::ranges::begin(r) + static_cast<std::ptrdiff_t>(i));
+            };
+            return binary_position(r, key, std::move(comp)).map_or_else([] { return detail::search_result<R>{}; }, at);
+        }
+
+        // `binary_position` for every key of `keys`, written to `out`. The searches
+        // run in groups of 16 that advance in lockstep, and each step prefetches the
+        // next probe of every search, so up to 16 cache misses are in flight at once
+        // instead of one. Worth it once `r` is much larger than the cache.
+        template <typename R, typename Keys, std::output_iterator<option<std::size_t>> O,
+                  typename Compare = std::ranges::less>
+            requires std::ranges::contiguous_range<R> && std::ranges::sized_range<R> && std::ranges::input_range<Keys>
+                  && std::predicate<Compare &, std::ranges::range_reference_t<R>, std::ranges::range_reference_t<Keys>>
+                  && std::predicate<Compare &, std::ranges::range_reference_t<Keys>, std::ranges::range_reference_t<R>>
+        auto binary_positions(R &&r, Keys &&keys, O out, Compare comp = {}) -> O {
+            constexpr std::size_t group = 16;
+            const auto *const first = std::to_address(std::ranges::data(r));
+            const auto n = static_cast<std::size_t>(std::ranges::size(r));
+            const auto address = [first](std::size_t i) {
+                return reinterpret_cast<std::uintptr_t>(first) + i * sizeof(*first);
+            };
+
+            auto it = std::ranges::begin(keys);
+            const auto last = std::ranges::end(keys);
+            std::array<std::ranges::range_value_t<Keys>, group> batch;
+            std::array<std::size_t, group> base;
+            while (it != last) {
+                std::size_t count = 0;
+                for (; count < group && it != last; ++count, ++it) {
+                    batch[count] = *it;
+                    base[count] = 0;
+                }
+                std::size_t len = n;
+                while (len > 1) {
+                    const std::size_t half = len / 2;
+                    len -= half;
+                    for (std::size_t j = 0; j < count; ++j) {
+                        base[j] = std::invoke(comp, first[base[j] + half], batch[j]) ? base[j] + half : base[j];
+                        detail::prefetch(address(base[j] + len / 2));
+                    }
+                }
+                for (std::size_t j = 0; j < count; ++j) {
+                    std::size_t i = base[j];
+                    if (n != 0) {
+                        i += static_cast<std::size_t>(std::invoke(comp, first[i], batch[j]));
+                    }
+                    *out = i == n || std::invoke(comp, batch[j], first[i]) ? option<std::size_t>{}
+                                                                           : option<std::size_t>{ i };
+                    ++out;
+                }
+            }
+            return out;
+        }
+
+        // A sorted table stored in Eytzinger (breadth-first) order: the children of
+        // node `k` are `2k` and `2k + 1`. A search walks one root-to-leaf path whose
+        // first levels share cache lines, and prefetches the line holding the
+        // node's descendants four levels down, so on tables far larger than the
+        // cache it keeps several misses in flight where a plain binary search
+        // waits for each one. Build it once from a sorted range.
+        template <typename T, typename Compare = std::ranges::less>
+        class eytzinger {
+        public:
+            // Copies `sorted`, which must be sorted by `comp`.
+            template <typename R>
+                requires std::ranges::forward_range<R> && std::ranges::sized_range<R>
+                      && std::convertible_to<std::ranges::range_reference_t<R>, T>
+            explicit eytzinger(R &&sorted, Compare comp = {}) : comp(std::move(comp)) {
+                const auto n = static_cast<std::size_t>(std::ranges::size(sorted));
+                ranks.resize(n);
+                std::size_t next = 0;
+                fill(1, n, next);
+                std::vector<T> in_order(std::ranges::begin(sorted), std::ranges::end(sorted));
+                if (n == 0) {
+                    return;
+                }
+                // Node `k` goes at `nodes[k]`, after a copy of the first one as padding.
+                nodes.reserve(n + 1);
+                nodes.push_back(in_order.front());
+                for (const std::size_t rank : ranks) {
+                    nodes.push_back(in_order[rank]);
+                }
+            }
+
+            // Returns the element equivalent to `key`, or `none`.
+            template <typename K>
+                requires std::predicate<const Compare &, const T &, const K &>
+                      && std::predicate<const Compare &, const K &, const T &>
+            auto find(const K &key) const -> option<const T &> {
+                const std::size_t k = lower_bound(key);
+                if (k == 0 || std::invoke(comp, key, nodes[k])) {
+                    return option<const T &>{};
+                }
+                return option<const T &>{ nodes[k] };
+            }
+
+            // Returns the index in the original sorted range of the element
+            // equivalent to `key`, or `none`.
+            template <typename K>
+                requires std::predicate<const Compare &, const T &, const K &>
+                      && std::predicate<const Compare &, const K &, const T &>
+            auto position(const K &key) const -> option<std::size_t> {
+                const std::size_t k = lower_bound(key);
+                if (k == 0 || std::invoke(comp, key, nodes[k])) {
+                    return option<std::size_t>{};
+                }
+                return option<std::size_t>{ ranks[k - 1] };
+            }
+
+            auto size() const noexcept -> std::size_t {
+                return ranks.size();
+            }
+
+        private:
+            // Nodes of one cache line: the descendants of `k` four levels down start
+            // at `16k` for 4-byte elements, which is the start of a line since
+            // `nodes` is line-aligned and node `k` is at `nodes[k]`.
+            static constexpr std::size_t line = 64 / sizeof(T) > 0 ? 64 / sizeof(T) : 1;
+
+            // The nodes in breadth-first order from index 1; index 0 is padding.
+            std::vector<T, detail::line_allocator<T>> nodes;
+            // The sorted index of each node.
+            std::vector<std::size_t> ranks;
+            cpp20_no_unique_address Compare comp;
+
+            // Numbers the nodes of the subtree at `k` in order.
+            void fill(std::size_t k, std::size_t n, std::size_t &next) {
+                if (k <= n) {
+                    fill(2 * k, n, next);
+                    ranks[k - 1] = next++;
+                    fill(2 * k + 1, n, next);
+                }
+            }
+
+            // The 1-based node of the first element not less than `key`, or 0.
+            template <typename K>
+            auto lower_bound(const K &key) const -> std::size_t {
+                const std::size_t n = size();
+                const auto base = reinterpret_cast<std::uintptr_t>(nodes.data());
+                std::size_t k = 1;
+                while (k <= n) {
+                    detail::prefetch(base + k * line * sizeof(T));
+                    k = 2 * k + static_cast<std::size_t>(std::invoke(comp, nodes[k], key));
+                }
+                // The path went right (1) every time the node was less than `key`;
+                // the answer is the last node where it went left.
+                return k >> (std::countr_one(k) + 1);
+            }
+        };
+    } // namespace ranges
+} // namespace opt
+
+#pragma pop_macro("cpp20_no_unique_address")
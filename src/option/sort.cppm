@@ -0,0 +1,259 @@
+export module option:sort;
+
+import std;
+import :fwd;
+import :classes;
+
+export namespace opt {
+    enum class none_position : std::uint8_t {
+        first,
+        last,
+    };
+
+    namespace detail {
+        // Payloads whose `<` order a radix sort reproduces.
+        template <typename T, typename Compare>
+        concept radix_sortable = (std::integral<T> || std::same_as<T, float> || std::same_as<T, double>)
+                              && std::same_as<Compare, std::ranges::less>;
+
+        template <typename T>
+        using radix_key = std::conditional_t<
+            sizeof(T) == 1, std::uint8_t,
+            std::conditional_t<sizeof(T) == 2, std::uint16_t,
+                               std::conditional_t<sizeof(T) == 4, std::uint32_t, std::uint64_t>>>;
+
+        // Maps `value` to an unsigned key with the same order: flip the sign bit of
+        // signed integers and of positive floats, and every bit of negative floats.
+        template <typename T>
+        constexpr auto to_radix_key(T value) noexcept -> radix_key<T> {
+            using K = radix_key<T>;
+            constexpr K sign = K{ 1 } << (8 * sizeof(T) - 1);
+            const K bits = std::bit_cast<K>(value);
+            if constexpr (std::floating_point<T>) {
+                return (bits & sign) != 0 ? static_cast<K>(~bits) : static_cast<K>(bits | sign);
+            } else if constexpr (std::is_signed_v<T>) {
+                return static_cast<K>(bits ^ sign);
+            } else {
+                return bits;
+            }
+        }
+
+        template <typename T>
+        constexpr auto from_radix_key(radix_key<T> key) noexcept -> T {
+            using K = radix_key<T>;
+            constexpr K sign = K{ 1 } << (8 * sizeof(T) - 1);
+            if constexpr (std::floating_point<T>) {
+                return std::bit_cast<T>((key & sign) != 0 ? static_cast<K>(key ^ sign) : static_cast<K>(~key));
+            } else if constexpr (std::is_signed_v<T>) {
+                return std::bit_cast<T>(static_cast<K>(key ^ sign));
+            } else {
+                return std::bit_cast<T>(key);
+            }
+        }
+
+        // The key of the stable paths, which must not order values that `<` finds
+        // equivalent: both zeros map to the key of `0.0`, and all NaNs to that of
+        // the positive quiet NaN. The values themselves are sorted, not decoded.
+        template <typename T>
+        constexpr auto to_stable_radix_key(T value) noexcept -> radix_key<T> {
+            if constexpr (std::floating_point<T>) {
+                if (value != value) {
+                    return to_radix_key(std::numeric_limits<T>::quiet_NaN());
+                }
+                if (value == T{}) {
+                    return to_radix_key(T{});
+                }
+            }
+            return to_radix_key(value);
+        }
+
+        // The key a sort compares floats by at every size: `<` is no strict weak
+        // order once NaNs are present, and would leave the zeros' order to the size.
+        template <bool Stable, typename T>
+        constexpr auto sort_key(T value) noexcept -> radix_key<T> {
+            if constexpr (Stable) {
+                return to_stable_radix_key(value);
+            } else {
+                return to_radix_key(value);
+            }
+        }
+
+        // Below this size a comparison sort is faster than the histogram passes.
+        inline constexpr std::size_t radix_threshold = 256;
+
+        // Stable LSD radix sort of `items` by `key_of(item)`, one byte per pass.
+        // The histograms of all bytes come from one read of the data, and bytes
+        // that are the same in every key are skipped.
+        template <typename E, typename KeyOf>
+        void radix_sort(std::vector<E> &items, KeyOf key_of) {
+            using K = std::remove_cvref_t<std::invoke_result_t<KeyOf &, const E &>>;
+            constexpr std::size_t passes = sizeof(K);
+            std::array<std::array<std::size_t, 256>, passes> counts{};
+            for (const E &item : items) {
+                const K key = key_of(item);
+                for (std::size_t pass = 0; pass < passes; ++pass) {
+                    ++counts[pass][static_cast<std::uint8_t>(key >> (8 * pass))];
+                }
+            }
+
+            std::vector<E> buffer(items.size());
+            for (std::size_t pass = 0; pass < passes; ++pass) {
+                auto &count = counts[pass];
+                if (std::ranges::find(count, items.size()) != count.end()) {
+                    continue;
+                }
+                std::size_t offset = 0;
+                for (auto &c : count) {
+                    offset += std::exchange(c, offset);
+                }
+                for (const E &item : items) {
+                    buffer[count[static_cast<std::uint8_t>(key_of(item) >> (8 * pass))]++] = item;
+                }
+                items.swap(buffer);
+            }
+        }
+
+        // Moves the `some`s of `values` to the end given by `where`, keeping their
+        // order, and returns them. `none`s are all alike, so the pass is stable.
+        template <typename T>
+        constexpr auto partition_none(std::span<option<T>> values, none_position where) -> std::span<option<T>> {
+            const std::size_t n = values.size();
+            if (where == none_position::first) {
+                std::size_t w = n;
+                for (std::size_t i = n; i-- > 0;) {
+                    if (values[i].is_some() && --w != i) {
+                        values[w].swap(values[i]);
+                    }
+                }
+                return values.subspan(w);
+            }
+            std::size_t w = 0;
+            for (std::size_t i = 0; i < n; ++i) {
+                if (values[i].is_some() && w++ != i) {
+                    values[w - 1].swap(values[i]);
+                }
+            }
+            return values.first(w);
+        }
+
+        template <typename R>
+        concept option_range = std::ranges::contiguous_range<R> && std::ranges::sized_range<R>
+                            && option_type<std::ranges::range_value_t<R>>;
+
+        template <typename R>
+        concept mutable_range = !std::is_const_v<std::remove_reference_t<std::ranges::range_reference_t<R>>>;
+
+        template <typename R>
+        using option_payload = typename std::ranges::range_value_t<R>::value_type;
+
+        template <bool Stable, typename T, typename Compare>
+        void sort_values(std::span<option<T>> present, Compare &comp) {
+            if constexpr (radix_sortable<T, Compare> && Stable && std::floating_point<T>) {
+                if (present.size() >= radix_threshold) {
+                    std::vector<T> sorted;
+                    sorted.reserve(present.size());
+                    for (const auto &value : present) {
+                        sorted.push_back(*value);
+                    }
+                    radix_sort(sorted, [](T value) { return to_stable_radix_key(value); });
+                    for (std::size_t i = 0; i < sorted.size(); ++i) {
+                        *present[i] = sorted[i];
+                    }
+                    return;
+                }
+            } else if constexpr (radix_sortable<T, Compare>) {
+                if (present.size() >= radix_threshold) {
+                    std::vector<radix_key<T>> keys;
+                    keys.reserve(present.size());
+                    for (const auto &value : present) {
+                        keys.push_back(to_radix_key(*value));
+                    }
+                    radix_sort(keys, std::identity{});
+                    for (std::size_t i = 0; i < keys.size(); ++i) {
+                        *present[i] = from_radix_key<T>(keys[i]);
+                    }
+                    return;
+                }
+            }
+            const auto sort_present = [&](auto order, auto project) {
+                if constexpr (Stable) {
+                    std::ranges::stable_sort(present, order, project);
+                } else {
+                    std::ranges::sort(present, order, project);
+                }
+            };
+            if constexpr (radix_sortable<T, Compare> && std::floating_point<T>) {
+                sort_present(std::ranges::less{}, [](const option<T> &o) { return sort_key<Stable>(*o); });
+            } else {
+                sort_present(std::ref(comp), [](const option<T> &o) -> const T & { return *o; });
+            }
+        }
+    } // namespace detail
+
+    // Sorts `values` by `comp` with all `none`s at the end given by `where`.
+    template <typename R, typename Compare = std::ranges::less>
+        requires detail::option_range<R> && detail::mutable_range<R>
+              && std::strict_weak_order<Compare &, const detail::option_payload<R> &, const detail::option_payload<R> &>
+    void sort(R &&values, none_position where = none_position::first, Compare comp = {}) {
+        using T = detail::option_payload<R>;
+        const auto present = detail::partition_none(std::span<option<T>>{ values }, where);
+        detail::sort_values<false>(present, comp);
+    }
+
+    // As `sort`, but keeps the order of equivalent values.
+    template <typename R, typename Compare = std::ranges::less>
+        requires detail::option_range<R> && detail::mutable_range<R>
+              && std::strict_weak_order<Compare &, const detail::option_payload<R> &, const detail::option_payload<R> &>
+    void stable_sort(R &&values, none_position where = none_position::first, Compare comp = {}) {
+        using T = detail::option_payload<R>;
+        const auto present = detail::partition_none(std::span<option<T>>{ values }, where);
+        detail::sort_values<true>(present, comp);
+    }
+
+    // Returns the stable permutation that sorts `values` as `stable_sort` would,
+    // leaving `values` untouched: `values[result[0]]` comes first.
+    template <typename R, typename Compare = std::ranges::less>
+        requires detail::option_range<R>
+              && std::strict_weak_order<Compare &, const detail::option_payload<R> &, const detail::option_payload<R> &>
+    auto sort_indices(R &&values, none_position where = none_position::first, Compare comp = {})
+        -> std::vector<std::size_t> {
+        using T = detail::option_payload<R>;
+        const std::span<const option<T>> all{ values };
+        std::vector<std::size_t> nones;
+        std::vector<std::size_t> indices;
+        indices.reserve(all.size());
+        for (std::size_t i = 0; i < all.size(); ++i) {
+            (all[i].is_some() ? indices : nones).push_back(i);
+        }
+
+        bool sorted = false;
+        if constexpr (detail::radix_sortable<T, Compare>) {
+            if (indices.size() >= detail::radix_threshold) {
+                using K = detail::radix_key<T>;
+                struct keyed {
+                    K key;
+                    std::size_t index;
+                };
+                std::vector<keyed> items;
+                items.reserve(indices.size());
+                for (const std::size_t i : indices) {
+                    items.push_back(keyed{ detail::to_stable_radix_key(*all[i]), i });
+                }
+                detail::radix_sort(items, [](const keyed &item) { return item.key; });
+                std::ranges::transform(items, indices.begin(), &keyed::index);
+                sorted = true;
+            }
+        }
+        if (!sorted) {
+            if constexpr (detail::radix_sortable<T, Compare> && std::floating_point<T>) {
+                std::ranges::stable_sort(indices, std::ranges::less{},
+                                         [&](std::size_t i) { return detail::sort_key<true>(*all[i]); });
+            } else {
+                std::ranges::stable_sort(indices, std::ref(comp), [&](std::size_t i) -> const T & { return *all[i]; });
+            }
+        }
+
+        indices.insert(where == none_position::first ? indices.begin() : indices.end(), nones.begin(), nones.end());
+        return indices;
+    }
+} // namespace opt
@@ -0,0 +1,198 @@
+export module option:static_map;
+
+import std;
+import :fwd;
+import :panic;
+import :classes;
+
+export namespace opt {
+    template <typename K>
+    struct static_hash;
+
+    namespace detail {
+        // The splitmix64 finalizer.
+        constexpr auto mix64(std::uint64_t x) noexcept -> std::uint64_t {
+            x ^= x >> 30;
+            x *= 0xbf58476d1ce4e5b9ULL;
+            x ^= x >> 27;
+            x *= 0x94d049bb133111ebULL;
+            x ^= x >> 31;
+            return x;
+        }
+
+        // Maps a hash to `[0, n)` with a multiply instead of a division.
+        constexpr auto reduce(std::uint64_t hash, std::size_t n) noexcept -> std::size_t {
+            return static_cast<std::size_t>(((hash >> 32) * static_cast<std::uint64_t>(n)) >> 32);
+        }
+
+        inline constexpr std::uint64_t bucket_seed = 0x9e3779b97f4a7c15ULL;
+
+        inline constexpr std::uint32_t max_displacement = 1U << 24;
+    } // namespace detail
+
+    template <typename K>
+        requires std::integral<K> || std::is_enum_v<K>
+    struct static_hash<K> {
+        constexpr auto operator()(const K &key, std::uint64_t seed) const noexcept -> std::uint64_t {
+            if constexpr (std::is_enum_v<K>) {
+                return detail::mix64(static_cast<std::uint64_t>(std::to_underlying(key)) ^ seed);
+            } else {
+                return detail::mix64(static_cast<std::uint64_t>(key) ^ seed);
+            }
+        }
+    };
+
+    template <>
+    struct static_hash<std::string_view> {
+        // FNV-1a, started from the seed and finished with `mix64`.
+        constexpr auto operator()(std::string_view key, std::uint64_t seed) const noexcept -> std::uint64_t {
+            std::uint64_t hash = 0xcbf29ce484222325ULL ^ seed;
+            for (const char c : key) {
+                hash ^= static_cast<unsigned char>(c);
+                hash *= 0x100000001b3ULL;
+            }
+            return detail::mix64(hash);
+        }
+    };
+
+    template <typename K, typename V, std::size_t N, typename Hash = static_hash<K>>
+    class static_map {
+    public:
+        using key_type = K;
+        using mapped_type = V;
+        using value_type = std::pair<K, V>;
+        using const_iterator = const value_type *;
+
+        // About four keys per bucket: small seeds suffice and the seed table stays
+        // a quarter of the entries.
+        static constexpr std::size_t bucket_count = (N + 3) / 4;
+
+        static_assert(N > 0, "opt::static_map needs at least one entry");
+
+        // Builds the table. Prefer `make_static_map`, which deduces `N`.
+        constexpr explicit static_map(const value_type (&items)[N]) :
+            static_map(items, place(items), std::make_index_sequence<N>{}) {}
+
+        // Returns the value stored for `key`, or `none`.
+        constexpr auto find(const K &key) const noexcept -> option<const V &> {
+            const auto &entry = entries[slot_of(key, seeds[bucket_of(key)])];
+            if (entry.first == key) {
+                return option<const V &>{ entry.second };
+            }
+            return option<const V &>{};
+        }
+
+        constexpr auto contains(const K &key) const noexcept -> bool {
+            return find(key).is_some();
+        }
+
+        constexpr auto size() const noexcept -> std::size_t {
+            return N;
+        }
+
+        // The entries in slot order.
+        constexpr auto begin() const noexcept -> const_iterator {
+            return entries.data();
+        }
+
+        constexpr auto end() const noexcept -> const_iterator {
+            return entries.data() + N;
+        }
+
+    private:
+        struct placement {
+            std::array<std::size_t, N> item_of_slot{};
+            std::array<std::uint32_t, bucket_count> seeds{};
+        };
+
+        std::array<value_type, N> entries;
+        std::array<std::uint32_t, bucket_count> seeds;
+
+        template <std::size_t... Is>
+        constexpr static_map(const value_type (&items)[N], const placement &p, std::index_sequence<Is...>) :
+            entries{ { items[p.item_of_slot[Is]]... } }, seeds{ p.seeds } {}
+
+        static constexpr auto bucket_of(const K &key) noexcept -> std::size_t {
+            return detail::reduce(Hash{}(key, detail::bucket_seed), bucket_count);
+        }
+
+        static constexpr auto slot_of(const K &key, std::uint32_t seed) noexcept -> std::size_t {
+            return detail::reduce(Hash{}(key, seed), N);
+        }
+
+        // Hash-and-displace: buckets are placed largest first, each with the first
+        // seed that maps all of its keys to distinct free slots.
+        static constexpr auto place(const value_type (&items)[N]) -> placement {
+            placement p;
+            // Item indices grouped by bucket (a counting sort).
+            std::array<std::size_t, bucket_count + 1> start{};
+            std::array<std::size_t, N> bucket{};
+            for (std::size_t i = 0; i < N; ++i) {
+                bucket[i] = bucket_of(items[i].first);
+                ++start[bucket[i] + 1];
+            }
+            for (std::size_t b = 0; b < bucket_count; ++b) {
+                start[b + 1] += start[b];
+            }
+            std::array<std::size_t, N> members{};
+            std::array<std::size_t, bucket_count> fill{};
+            for (std::size_t i = 0; i < N; ++i) {
+                members[start[bucket[i]] + fill[bucket[i]]++] = i;
+            }
+
+            std::array<std::size_t, bucket_count> order{};
+            for (std::size_t b = 0; b < bucket_count; ++b) {
+                order[b] = b;
+            }
+            std::ranges::sort(order, std::ranges::greater{}, [&](std::size_t b) { return start[b + 1] - start[b]; });
+
+            std::array<bool, N> taken{};
+            for (const std::size_t b : order) {
+                const std::size_t first = start[b];
+                const std::size_t last  = start[b + 1];
+                if (first == last) {
+                    break;
+                }
+                for (std::size_t i = first; i < last; ++i) {
+                    for (std::size_t j = first; j < i; ++j) {
+                        if (items[members[i]].first == items[members[j]].first) {
+                            throw option_panic("opt::static_map: duplicate key");
+                        }
+                    }
+                }
+
+                std::uint32_t seed = 1;
+                for (;; ++seed) {
+                    if (seed == detail::max_displacement) {
+                        throw option_panic("opt::static_map: no perfect hash found, check `Hash`");
+                    }
+                    bool fits = true;
+                    for (std::size_t i = first; i < last && fits; ++i) {
+                        const std::size_t slot = slot_of(items[members[i]].first, seed);
+                        fits = !taken[slot];
+                        for (std::size_t j = first; j < i && fits; ++j) {
+                            fits = slot != slot_of(items[members[j]].first, seed);
+                        }
+                    }
+                    if (fits) {
+                        break;
+                    }
+                }
+
+                p.seeds[b] = seed;
+                for (std::size_t i = first; i < last; ++i) {
+                    const std::size_t slot = slot_of(items[members[i]].first, seed);
+                    taken[slot] = true;
+                    p.item_of_slot[slot] = members[i];
+                }
+            }
+            return p;
+        }
+    };
+
+    // Builds a `static_map` from a braced list of `{ key, value }` pairs.
+    template <typename K, typename V, typename Hash = static_hash<K>, std::size_t N>
+    constexpr auto make_static_map(const std::pair<K, V> (&items)[N]) -> static_map<K, V, N, Hash> {
+        return static_map<K, V, N, Hash>{ items };
+    }
+} // namespace opt
@@ -3,6 +3,20 @@ export module option:storage;
 import std;
 import :fwd;
 
+#ifndef OPT_OPTION_DEBUG_PERF
+    #define OPT_OPTION_DEBUG_PERF 0
+#endif
+
+#pragma push_macro("debug_inline")
+#undef debug_inline
+#if !OPT_OPTION_DEBUG_PERF
+    #define debug_inline
+#elif defined(__clang__) || defined(__GNUC__)
+    #define debug_inline [[gnu::always_inline, gnu::artificial]]
+#else
+    #define debug_inline [[msvc::forceinline]]
+#endif
+
 #pragma push_macro("cpp20_no_unique_address")
 #undef cpp20_no_unique_address
 #if defined(_MSC_VER)
@@ -12,6 +26,14 @@ import :fwd;
 #endif
 
 export namespace opt::detail {
+    // Payloads whose storage is copied, assigned and (re)activated by plain
+    // assignment. Constant evaluation then skips `construct_at`/`destroy_at` and the
+    // swaps of `take`/`replace`, which keeps `constexpr` pipelines within the step limits.
+    // `emplace` assigns a temporary, so a deleted move assignment opts out.
+    template <typename T>
+    concept plain_payload = std::is_trivially_copyable_v<T> && std::is_trivially_default_constructible_v<T>
+                         && std::is_copy_assignable_v<T> && std::is_move_assignable_v<T>;
+
     struct empty_byte {};
 
     template <typename T>
@@ -167,7 +189,7 @@ export namespace opt::detail {
         }
 
         template <typename Self>
-        constexpr auto &&get(this Self &&self) noexcept {
+        debug_inline constexpr auto &&get(this Self &&self) noexcept {
             if constexpr (std::is_const_v<T>) {
                 return std::as_const(std::forward_like<Self>(self.value));
             } else {
@@ -175,19 +197,26 @@ export namespace opt::detail {
             }
         }
 
-        constexpr bool has_value() const noexcept {
+        debug_inline constexpr bool has_value() const noexcept {
             return has_value_;
         }
 
         template <typename... Ts>
+            requires std::constructible_from<stored_type, Ts...>
         constexpr void emplace(Ts &&...args) noexcept(std::is_nothrow_constructible_v<T, Ts...>) {
-            if constexpr (!std::is_trivially_destructible_v<T>) {
-                if (has_value_) {
-                    std::destroy_at(std::addressof(value));
-                    has_value_ = false;
+            if constexpr (plain_payload<stored_type>) {
+                // A direct initialization: the constraint rules out the casts a one-argument
+                // functional cast could otherwise perform.
+                value = stored_type(std::forward<Ts>(args)...);
+            } else {
+                if constexpr (!std::is_trivially_destructible_v<T>) {
+                    if (has_value_) {
+                        std::destroy_at(std::addressof(value));
+                        has_value_ = false;
+                    }
                 }
+                std::construct_at(std::addressof(value), std::forward<Ts>(args)...);
             }
-            std::construct_at(std::addressof(value), std::forward<Ts>(args)...);
             has_value_ = true;
         }
 
@@ -221,11 +250,11 @@ export namespace opt::detail {
 
         constexpr option_storage(std::in_place_t, pointer_t val) noexcept : ptr{ val }, has_value_{ true } {}
 
-        constexpr auto &&get(this auto &&self) noexcept {
+        debug_inline constexpr auto &&get(this auto &&self) noexcept {
             return self.ptr;
         }
 
-        constexpr bool has_value() const noexcept {
+        debug_inline constexpr bool has_value() const noexcept {
             return has_value_;
         }
         constexpr void reset() noexcept {
@@ -252,11 +281,11 @@ export namespace opt::detail {
         constexpr option_storage &operator=(const option_storage &other) = default;
         constexpr option_storage &operator=(option_storage &&other)      = default;
 
-        constexpr T &get() const noexcept {
+        debug_inline constexpr T &get() const noexcept {
             return *ptr;
         }
 
-        constexpr bool has_value() const noexcept {
+        debug_inline constexpr bool has_value() const noexcept {
             return ptr != nullptr;
         }
         constexpr void reset() noexcept {
@@ -285,8 +314,8 @@ export namespace opt::detail {
         constexpr option_storage() = default;
         constexpr option_storage(bool has_val) noexcept : has_value_{ has_val } {}
 
-        constexpr void get() const noexcept {}
-        constexpr bool has_value() const noexcept {
+        debug_inline constexpr void get() const noexcept {}
+        debug_inline constexpr bool has_value() const noexcept {
             return has_value_;
         }
         constexpr void reset() noexcept {
@@ -355,11 +384,11 @@ export namespace opt::detail {
             requires std::is_move_constructible_v<T> && std::is_move_assignable_v<T>
         = default;
 
-        constexpr auto &&get(this auto &&self) noexcept {
+        debug_inline constexpr auto &&get(this auto &&self) noexcept {
             return self.value;
         }
 
-        constexpr bool has_value() const noexcept {
+        debug_inline constexpr bool has_value() const noexcept {
             return has_value_;
         }
 
@@ -382,4 +411,5 @@ export namespace opt::detail {
     };
 } // namespace opt::detail
 
+#pragma pop_macro("debug_inline")
 #pragma pop_macro("cpp20_no_unique_address")
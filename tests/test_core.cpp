@@ -0,0 +1,124 @@
+// `option_core.hpp` on its own: `opt::core::option<T>` must work without
+// `option.hpp`, and match the layout `opt::option<T>` uses for the same payload.
+
+#include <cassert>
+#include <cstring>
+#include <string_view>
+#include <type_traits>
+
+#include "option_core.hpp"
+
+#ifdef OPT_OPTION_HPP
+    #error "option_core.hpp must not pull in option.hpp"
+#endif
+
+using opt::core::option;
+
+namespace {
+    enum class id : unsigned { first = 1 };
+
+    struct empty {};
+
+    struct point {
+        int x;
+        double y;
+
+        friend constexpr auto operator==(point, point) -> bool = default;
+    };
+} // namespace
+
+namespace core_::layout {
+    void run_test() {
+        static_assert(sizeof(option<empty>) == 1);
+        static_assert(sizeof(option<int>) == 2 * sizeof(int));
+        static_assert(sizeof(option<id>) == sizeof(option<unsigned>));
+        static_assert(std::is_trivially_copyable_v<option<point>>);
+        static_assert(std::is_trivially_copyable_v<option<int *>>);
+
+        const option<int> a{ 7 };
+        int value = 0;
+        std::memcpy(&value, &a, sizeof(value));
+        assert(value == 7);
+    }
+} // namespace core_::layout
+
+namespace core_::observers {
+    void run_test() {
+        option<int> a{ 3 };
+        const option<int> b = opt::core::none;
+        assert(a.is_some() && b.is_none());
+        assert(a.is_some_and([](int v) { return v == 3; }));
+        assert(b.is_none_or([](int) { return false; }));
+        assert(*a == 3 && b.unwrap_or(4) == 4 && b.unwrap_or_default() == 0);
+        assert(b.unwrap_or_else([] { return 5; }) == 5);
+
+        bool panicked = false;
+        try {
+            (void) b.expect("empty");
+        } catch (const opt::option_panic &e) {
+            panicked = std::string_view{ e.what() } == "empty";
+        }
+        assert(panicked);
+    }
+} // namespace core_::observers
+
+namespace core_::combinators {
+    constexpr auto fold() -> int {
+        option<int> a{ 3 };
+        option<int> b;
+        int r = a.map([](int v) { return v * 2; }).unwrap_or(0);                                      // 6
+        r += a.and_then([](int v) { return v > 2 ? option<int>{ v } : option<int>{}; }).unwrap_or(0); // 3
+        r += a.filter([](int v) { return v % 2 == 0; }).unwrap_or(100);                               // 100
+        r += b.or_else([] { return option<int>{ 1 }; }).unwrap();                                     // 1
+        r += a.xor_(b).unwrap() + a.and_(b).unwrap_or(0) + b.or_(a).unwrap();                         // 3 + 0 + 3
+        r += a.map_or(0, [](int v) { return v; });                                                    // 3
+        return r;
+    }
+
+    void run_test() {
+        static_assert(fold() == 6 + 3 + 100 + 1 + 3 + 0 + 3 + 3);
+        assert(fold() == 119);
+    }
+} // namespace core_::combinators
+
+namespace core_::modifiers {
+    constexpr auto fold() -> int {
+        option<int> a{ 1 };
+        option<int> b;
+        int r = b.get_or_insert(5);                                               // 5
+        r += b.take().unwrap_or(0) + b.is_none();                                 // 5 + 1
+        r += a.replace(9).unwrap() + a.unwrap();                                  // 1 + 9
+        r += b.get_or_insert_with([] { return 2; });                              // 2
+        r += b.take_if([](int &v) { return v == 2; }).unwrap_or(0) + b.is_none(); // 2 + 1
+        option<point> p;
+        p.emplace(1, 2.0);
+        r += p->x;                     // 1
+        a.swap(b);
+        r += a.is_none() + b.unwrap(); // 1 + 9
+        return r;
+    }
+
+    void run_test() {
+        static_assert(fold() == 5 + 5 + 1 + 1 + 9 + 2 + 2 + 1 + 1 + 1 + 9);
+    }
+} // namespace core_::modifiers
+
+namespace core_::comparisons {
+    void run_test() {
+        static_assert(option<int>{} == opt::core::none);
+        static_assert(option<int>{} < option<int>{ 0 });
+        static_assert(option<int>{ 1 } < option<int>{ 2 });
+        static_assert(option<int>{ 1 } == 1 && option<int>{} != 1);
+        static_assert(option<point>{ point{ 1, 2.0 } } == point{ 1, 2.0 });
+        static_assert(option<double>{ 1.0 } > opt::core::none);
+    }
+} // namespace core_::comparisons
+
+int main() {
+    core_::layout::run_test();
+    core_::observers::run_test();
+    core_::combinators::run_test();
+    core_::modifiers::run_test();
+    core_::comparisons::run_test();
+    return 0;
+}
@@ -0,0 +1,181 @@
+// Call-site profiler (`OPT_OPTION_PROFILE=1`): the presence checks of the
+// `unwrap`, `unwrap_or` and `get_or_insert` families are recorded per call site.
+// Sampling is disabled (`OPT_OPTION_PROFILE_PERIOD=1`) so that counts are exact.
+
+#include <cassert>
+#include <cstdint>
+#include <cstdio>
+#include <source_location>
+#include <string>
+#include <thread>
+
+#ifndef OPT_OPTION_PROFILE
+    #define OPT_OPTION_PROFILE 1
+#endif
+
+#ifndef OPT_OPTION_PROFILE_PERIOD
+    #define OPT_OPTION_PROFILE_PERIOD 1
+#endif
+
+#include "option.hpp"
+
+static_assert(OPT_OPTION_PROFILE);
+
+namespace {
+    auto find_site(std::uint_least32_t line) -> opt::option<opt::profiler::site_profile> {
+        for (const auto &site : opt::profiler::profile()) {
+            if (site.location.line() == line) {
+                return opt::option<opt::profiler::site_profile>{ site };
+            }
+        }
+        return opt::option<opt::profiler::site_profile>{};
+    }
+} // namespace
+
+namespace profiler_::per_call_site {
+    void run_test() {
+        opt::profiler::reset();
+
+        int total       = 0;
+        const auto line = std::source_location::current().line();
+        for (int i = 0; i < 100; ++i) {
+            const auto value = i % 4 == 0 ? opt::some(i) : opt::option<int>{};
+            total += value.unwrap_or(0);                     // line + 3
+            total += value.unwrap_or_else([] { return 1; }); // line + 4
+        }
+        (void) total;
+
+        const auto a = find_site(line + 3).expect("unwrap_or site");
+        const auto b = find_site(line + 4).expect("unwrap_or_else site");
+        assert(a.kind == opt::profiler::site_kind::unwrap_or);
+        assert(a.some == 25 && a.none == 75);
+        assert(b.some == 25 && b.none == 75);
+
+        // The default hint expects a value, so every empty outcome counts against it.
+        assert(a.current_hint() == opt::profiler::hint::likely);
+        assert(a.against_hint() == 75);
+        assert(a.suggested_hint() == opt::profiler::hint::unlikely);
+    }
+} // namespace profiler_::per_call_site
+
+namespace profiler_::families {
+    void run_test() {
+        opt::profiler::reset();
+
+        opt::option<std::string> cache;
+        for (int i = 0; i < 10; ++i) {
+            cache.get_or_insert_with([] { return std::string{ "x" }; });
+        }
+        const auto line_insert = std::source_location::current().line() - 2;
+
+        int x = 1;
+        opt::option<int &> ref{ x };
+        for (int i = 0; i < 10; ++i) {
+            ref.unwrap() += 1;
+        }
+        const auto line_unwrap = std::source_location::current().line() - 2;
+
+        const auto insert = find_site(line_insert).expect("get_or_insert_with site");
+        assert(insert.kind == opt::profiler::site_kind::get_or_insert);
+        assert(insert.none == 1 && insert.some == 9);
+
+        const auto unwrap = find_site(line_unwrap).expect("unwrap site");
+        assert(unwrap.kind == opt::profiler::site_kind::unwrap);
+        assert(unwrap.some == 10 && unwrap.none == 0);
+        assert(x == 11);
+    }
+} // namespace profiler_::families
+
+namespace profiler_::ranking {
+    void run_test() {
+        opt::profiler::reset();
+
+        const opt::option<int> empty;
+        const opt::option<int> full{ 1 };
+        for (int i = 0; i < 50; ++i) {
+            (void) empty.unwrap_or(0);
+            (void) full.unwrap_or(0);
+        }
+
+        // The site that mostly missed its hint comes first.
+        const auto sites = opt::profiler::profile();
+        assert(sites.size() >= 2);
+        assert(sites[0].none == 50 && sites[0].against_hint() == 50);
+        for (std::size_t i = 1; i < sites.size(); ++i) {
+            assert(sites[i - 1].against_hint() >= sites[i].against_hint());
+        }
+    }
+} // namespace profiler_::ranking
+
+namespace profiler_::threads {
+    void run_test() {
+        opt::profiler::reset();
+
+        auto worker = [] {
+            for (int i = 0; i < 1000; ++i) {
+                const opt::option<int> o{ i };
+                (void) o.unwrap_or(0);
+            }
+        };
+        std::thread t1{ worker };
+        std::thread t2{ worker };
+        t1.join();
+        t2.join();
+
+        std::uint64_t some = 0;
+        for (const auto &site : opt::profiler::profile()) {
+            some += site.some;
+        }
+        assert(some == 2000);
+        assert(opt::profiler::dropped_samples() == 0);
+    }
+} // namespace profiler_::threads
+
+namespace profiler_::constant_evaluation {
+    constexpr auto fold() -> int {
+        opt::option<int> o;
+        o.get_or_insert(1);
+        return o.unwrap() + opt::option<int>{}.unwrap_or(2);
+    }
+
+    void run_test() {
+        static_assert(fold() == 3);
+    }
+} // namespace profiler_::constant_evaluation
+
+namespace profiler_::hints_header {
+    void run_test() {
+        opt::profiler::reset();
+
+        const opt::option<int> empty;
+        for (int i = 0; i < 10; ++i) {
+            (void) empty.unwrap_or(0);
+        }
+
+        std::FILE *tmp = std::tmpfile();
+        assert(tmp != nullptr);
+        opt::profiler::write_hints(tmp);
+        std::rewind(tmp);
+
+        std::string header;
+        for (int c = std::fgetc(tmp); c != EOF; c = std::fgetc(tmp)) {
+            header += static_cast<char>(c);
+        }
+        std::fclose(tmp);
+
+        assert(header.find("#define OPT_OPTION_HINT_UNWRAP_OR unlikely") != std::string::npos);
+        assert(header.find("#define OPT_OPTION_HINT_UNWRAP likely") != std::string::npos);
+    }
+} // namespace profiler_::hints_header
+
+int main() {
+    profiler_::per_call_site::run_test();
+    profiler_::families::run_test();
+    profiler_::ranking::run_test();
+    profiler_::threads::run_test();
+    profiler_::constant_evaluation::run_test();
+    profiler_::hints_header::run_test();
+
+    opt::profiler::dump();
+    return 0;
+}
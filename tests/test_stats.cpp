@@ -0,0 +1,140 @@
+// Runtime statistics (`OPT_OPTION_STATS=1`): copies, moves, clones, emplaces,
+// resets, panics and presence checks are counted per payload type.
+
+#include <cassert>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#ifndef OPT_OPTION_STATS
+    #define OPT_OPTION_STATS 1
+#endif
+
+#include "option.hpp"
+
+static_assert(OPT_OPTION_STATS);
+
+struct Payload {
+    std::vector<int> data;
+
+    Payload clone() const {
+        return Payload{ data };
+    }
+};
+
+namespace stats_::copies_and_moves {
+    void run_test() {
+        opt::stats::reset();
+
+        Payload p{ { 1, 2, 3 } };
+        opt::option<Payload> a{ p };            // copy
+        opt::option<Payload> b{ std::move(p) }; // move
+        opt::option<Payload> c = a;             // copy
+        opt::option<Payload> d = std::move(b);  // move
+        opt::option<Payload> e;
+        opt::option<Payload> f = e; // copy of none: not counted
+        e = c;                      // copy
+        (void) d;
+        (void) f;
+
+        const auto s = opt::stats::snapshot_of<Payload>();
+        assert(s[opt::stats::event::copy] == 3);
+        assert(s[opt::stats::event::move] == 2);
+    }
+} // namespace stats_::copies_and_moves
+
+namespace stats_::clone_emplace_reset {
+    void run_test() {
+        opt::stats::reset();
+
+        opt::option<Payload> a{ Payload{ { 1 } } };
+        auto b = a.clone();
+        (void) b;
+
+        opt::option<Payload> c;
+        c.emplace(Payload{ { 2 } });
+        c.get_or_insert_with([] { return Payload{}; }); // already some: no emplace
+        c.reset();
+        c.get_or_insert_with([] { return Payload{}; });
+        c = opt::none;
+        c = opt::none; // already none: no reset
+
+        const auto s = opt::stats::snapshot_of<Payload>();
+        assert(s[opt::stats::event::clone] == 1);
+        assert(s[opt::stats::event::emplace] == 2);
+        assert(s[opt::stats::event::reset] == 2);
+    }
+} // namespace stats_::clone_emplace_reset
+
+namespace stats_::panics_and_checks {
+    void run_test() {
+        opt::stats::reset();
+
+        opt::option<std::string> none;
+        opt::option<std::string> some{ std::string{ "x" } };
+        try {
+            (void) none.unwrap();
+            assert(false);
+        } catch (const opt::option_panic &) {
+        }
+        try {
+            (void) none.expect("empty");
+            assert(false);
+        } catch (const opt::option_panic &) {
+        }
+        (void) some.is_some();
+        (void) none.is_none();
+
+        const auto s = opt::stats::snapshot_of<std::string>();
+        assert(s[opt::stats::event::panic] == 2);
+        assert(s[opt::stats::event::check] == 4);
+        assert(s[opt::stats::event::check_none] == 3);
+        assert(s.none_ratio() == 0.75);
+    }
+} // namespace stats_::panics_and_checks
+
+namespace stats_::threads {
+    void run_test() {
+        opt::stats::reset();
+
+        std::vector<std::thread> workers;
+        for (int t = 0; t < 4; ++t) {
+            workers.emplace_back([] {
+                for (int i = 0; i < 1000; ++i) {
+                    opt::option<long> o{ static_cast<long>(i) };
+                    opt::option<long> copy = o;
+                    (void) copy;
+                }
+            });
+        }
+        for (auto &w : workers) {
+            w.join();
+        }
+
+        // Worker threads flush their counters when they exit.
+        assert(opt::stats::snapshot_of<long>()[opt::stats::event::copy] == 4000);
+    }
+} // namespace stats_::threads
+
+namespace stats_::constant_evaluation {
+    constexpr int sum() {
+        opt::option<int> a{ 1 };
+        opt::option<int> b = a;
+        return a.unwrap_or(0) + b.unwrap_or(0);
+    }
+
+    void run_test() {
+        // The hooks are skipped during constant evaluation.
+        static_assert(sum() == 2);
+        opt::stats::dump();
+    }
+} // namespace stats_::constant_evaluation
+
+int main() {
+    stats_::copies_and_moves::run_test();
+    stats_::clone_emplace_reset::run_test();
+    stats_::panics_and_checks::run_test();
+    stats_::threads::run_test();
+    stats_::constant_evaluation::run_test();
+}
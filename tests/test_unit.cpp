@@ -1,8 +1,28 @@
 // NOLINTBEGIN
 
 #include "option.hpp"
+#include "option_batch.hpp"
+#include "option_column_stats.hpp"
+#include "option_core.hpp"
+#include "option_group_by.hpp"
+#include "option_hash_join.hpp"
+#include "option_iter.hpp"
+#include "option_kleene.hpp"
+#include "option_masked_column.hpp"
+#include "option_memo_cache.hpp"
+#include "option_ranges.hpp"
+#include "option_result.hpp"
+#include "option_slot_pool.hpp"
+#include "option_sort.hpp"
+#include "option_static_map.hpp"
+#include "option_text.hpp"
+#include "option_ts.hpp"
+#include <cmath>
 #include <format>
 #include <gtest/gtest.h>
+#include <limits>
+#include <span>
+#include <stdexcept>
 #include <string>
 #include <unordered_set>
 
@@ -762,6 +782,1326 @@ TEST(OptionAPI, CustomType) {
     EXPECT_TRUE(a.is_none());
 }
 
+// =============================
+// 41. Opt-in Statistics Compile to Nothing by Default
+// =============================
+TEST(OptionStats, DisabledByDefault) {
+    // Without `OPT_OPTION_STATS` the hooks vanish, so `option` keeps its trivial
+    // special members and its size.
+    static_assert(OPT_OPTION_STATS == 0);
+    static_assert(std::is_trivially_copyable_v<opt::option<int>>);
+    static_assert(std::is_trivially_copy_assignable_v<opt::option<double>>);
+    static_assert(std::is_trivially_move_constructible_v<opt::option<std::pair<int, int>>>);
+    static_assert(sizeof(opt::option<int>) == sizeof(std::optional<int>));
+    static_assert(opt::some(1).map([](int x) { return x + 1; }) == opt::some(2));
+}
+
+// =============================
+// 42. Interop with the Lightweight core::option
+// =============================
+namespace {
+    // option.hpp restates `core::detail::payload` so that it need not include
+    // option_core.hpp; the two concepts must accept the same payloads.
+    template <typename... Ts>
+    constexpr bool same_core_payloads = ((opt::detail::core_payload<Ts> == opt::core::detail::payload<Ts>) && ...);
+
+    struct trivial_pair {
+        int first;
+        double second;
+    };
+
+    struct counted_copy {
+        counted_copy(const counted_copy &) {}
+    };
+
+    static_assert(same_core_payloads<int, const int, volatile int, bool, double, int *, const char *, int[2],
+                                     trivial_pair, const trivial_pair, counted_copy, std::string,
+                                     std::string_view, int &, opt::none_t>);
+} // namespace
+
+TEST(OptionCore, Interop) {
+    // `core::option<T>` shares the layout of `option<T>` and converts both ways.
+    struct tag {};
+    static_assert(sizeof(opt::core::option<int>) == sizeof(opt::option<int>));
+    static_assert(sizeof(opt::core::option<tag>) == sizeof(opt::option<tag>));
+    static_assert(std::is_convertible_v<opt::core::option<int>, opt::option<int>>);
+    static_assert(std::is_convertible_v<opt::option<int>, opt::core::option<int>>);
+    static_assert(!std::is_convertible_v<opt::option<std::string>, opt::core::option<int>>);
+
+    const opt::core::option<int> c{ 4 };
+    const opt::option<int> full = c;
+    EXPECT_EQ(full, opt::some(4));
+    EXPECT_EQ(full, c);
+    EXPECT_EQ(opt::core::option<int>{ full }.unwrap(), 4);
+
+    const opt::core::option<int> empty = opt::none;
+    EXPECT_TRUE(opt::option<int>{ empty }.is_none());
+    EXPECT_EQ(opt::option<int>{}, empty);
+    EXPECT_NE(full, empty);
+
+    // `bool` payloads convert as options, not through `operator bool`.
+    const opt::option<bool> flag{ opt::core::option<bool>{ false } };
+    EXPECT_EQ(flag, opt::some(false));
+}
+
+// =============================
+// 43. Constant Evaluation of take/replace/emplace on Plain Payloads
+// =============================
+namespace {
+    template <typename T, typename... Args>
+    concept storage_emplaceable = requires(opt::detail::option_storage<T> &storage, Args &&...args) {
+        storage.emplace(std::forward<Args>(args)...);
+    };
+} // namespace
+
+TEST(OptionAPI, ConstexprPlainPayload) {
+    // Trivially copyable payloads skip `construct_at` and the swaps; the results
+    // must match the general path.
+    struct point {
+        int x;
+        int y;
+    };
+    constexpr auto fold = [] {
+        opt::option<point> p;
+        p.emplace(1, 2);
+        const auto old = p.replace(point{ 3, 4 });
+        const auto taken = p.take();
+        opt::option<int> i;
+        i.get_or_insert_with([] { return 5; });
+        i.emplace(6);
+        const auto prev = i.take();
+        return old->x + old->y + taken->x + taken->y + *prev + p.is_none() + i.is_none();
+    };
+    static_assert(fold() == 1 + 2 + 3 + 4 + 6 + 1 + 1);
+    EXPECT_EQ(fold(), 18);
+
+    // The plain path initializes directly, so a pointer does not cast to an integer.
+    static_assert(storage_emplaceable<std::uintptr_t, std::uintptr_t>);
+    static_assert(storage_emplaceable<point, int, int>);
+    static_assert(!storage_emplaceable<std::uintptr_t, int *>);
+
+    // Trivially copyable, but only copy-assignable: `emplace` takes the general path.
+    struct pinned {
+        int v;
+        pinned() = default;
+        constexpr explicit pinned(int value) : v(value) {}
+        pinned(const pinned &) = default;
+        auto operator=(const pinned &) -> pinned & = default;
+        auto operator=(pinned &&) -> pinned & = delete;
+    };
+    static_assert(std::is_trivially_copyable_v<pinned> && std::is_trivially_default_constructible_v<pinned>);
+    opt::option<pinned> kept;
+    kept.emplace(7);
+    kept.emplace(8);
+    EXPECT_EQ(kept->v, 8);
+
+    opt::option<std::string> s{ "a" };
+    EXPECT_EQ(s.replace("b"), opt::some(std::string{ "a" }));
+    EXPECT_EQ(s.take(), opt::some(std::string{ "b" }));
+    EXPECT_TRUE(s.is_none());
+}
+
+// =============================
+// 44. Compile-time static_map
+// =============================
+TEST(StaticMap, Lookup) {
+    enum class op : unsigned char { add, sub, mul, div };
+    static constexpr auto ops = opt::make_static_map<std::string_view, op>({
+        { "add", op::add },
+        { "sub", op::sub },
+        { "mul", op::mul },
+        { "div", op::div },
+    });
+    static_assert(ops.size() == 4);
+    static_assert(*ops.find("mul") == op::mul);
+    static_assert(ops.find("mod").is_none());
+    static_assert(!ops.contains(""));
+
+    const std::string key = "div";
+    EXPECT_EQ(ops.find(key), opt::some(op::div));
+    EXPECT_TRUE(ops.find("ad").is_none());
+
+    // Every entry is reachable, and iteration visits each one once.
+    int sum = 0;
+    for (const auto &[name, value] : ops) {
+        EXPECT_EQ(ops.find(name), opt::some(value));
+        sum += static_cast<int>(value);
+    }
+    EXPECT_EQ(sum, 0 + 1 + 2 + 3);
+
+    static constexpr auto codes = opt::make_static_map<int, int>({
+        { 200, 0 }, { 301, 1 }, { 404, 2 }, { 500, 3 }, { 503, 4 }, { -1, 5 },
+    });
+    static_assert(codes.find(404).map([](int i) { return i * 10; }) == opt::some(20));
+    EXPECT_EQ(codes.find(-1), opt::some(5));
+    EXPECT_TRUE(codes.find(0).is_none());
+}
+
+// =============================
+// 45. Memoization Cache
+// =============================
+TEST(MemoCache, GetOrCompute) {
+    int calls = 0;
+    const auto square = [&](int x) {
+        ++calls;
+        return x * x;
+    };
+
+    opt::memo_cache<int, int, 16> direct;
+    EXPECT_EQ(direct.get_or_compute(3, square), 9);
+    EXPECT_EQ(direct.get_or_compute(3, square), 9);
+    EXPECT_EQ(calls, 1);
+    EXPECT_EQ(direct.find(3), opt::some(9));
+    EXPECT_TRUE(direct.find(4).is_none());
+    EXPECT_EQ(direct.erase(3), opt::some(9));
+    EXPECT_FALSE(direct.contains(3));
+    EXPECT_EQ(direct.size(), 0U);
+
+    // One set of four ways: the least recently used key goes first.
+    opt::memo_cache<int, int, 4, 4> lru;
+    for (const int k : { 1, 2, 3, 4 }) {
+        lru.get_or_compute(k, square);
+    }
+    lru.get_or_compute(1, square);
+    lru.get_or_compute(5, square);
+    EXPECT_FALSE(lru.contains(2));
+    EXPECT_TRUE(lru.contains(1) && lru.contains(5));
+
+    // CLOCK gives every used slot a second chance before evicting it.
+    opt::memo_cache<int, int, 4, 4, opt::memo_eviction::clock> clock;
+    for (const int k : { 1, 2, 3, 4 }) {
+        clock.get_or_compute(k, square);
+    }
+    clock.get_or_compute(5, square);
+    clock.get_or_compute(2, square);
+    clock.get_or_compute(6, square);
+    EXPECT_FALSE(clock.contains(1) || clock.contains(3));
+    EXPECT_TRUE(clock.contains(2) && clock.contains(5) && clock.contains(6));
+    EXPECT_EQ(clock.size(), 4U);
+}
+
+namespace {
+    opt::memo_cache<int, long long, 64, 4> fib_cache;
+
+    auto fib(int n) -> long long {
+        return n < 2 ? n : fib_cache.get_or_compute(n, [](int k) { return fib(k - 1) + fib(k - 2); });
+    }
+} // namespace
+
+TEST(MemoCache, RecursiveAndThreadLocal) {
+    // `f` may insert into the cache before its own result is stored.
+    EXPECT_EQ(fib(80), 23416728348467685LL);
+
+    using names = opt::memo_cache<std::string, std::size_t, 8, 2>;
+    auto &local = opt::thread_local_memo<names>();
+    EXPECT_EQ(local.get_or_compute("four", [](const std::string &s) { return s.size(); }), 4U);
+    EXPECT_EQ(&local, &opt::thread_local_memo<names>());
+    EXPECT_NE(&local, &opt::thread_local_memo<names, struct other_tag>());
+}
+
+// =============================
+// 46. Generation-checked slot_pool
+// =============================
+TEST(SlotPool, Handles) {
+    static_assert(sizeof(opt::option<std::string &>) == sizeof(std::string *));
+
+    opt::slot_pool<std::string> pool;
+    pool.reserve(4);
+    const auto a = pool.insert("a");
+    const auto b = pool.emplace(2, 'b');
+    const auto c = pool.insert("c");
+    EXPECT_EQ(pool.get(b), opt::some(std::string{ "bb" }));
+    EXPECT_EQ(pool.size(), 3U);
+
+    // Erasing moves the last value into the hole; the other handles still work.
+    EXPECT_EQ(pool.erase(a), opt::some(std::string{ "a" }));
+    EXPECT_TRUE(pool.get(a).is_none());
+    EXPECT_TRUE(pool.erase(a).is_none());
+    EXPECT_EQ(pool.get(c), opt::some(std::string{ "c" }));
+
+    // A handle that matches the generation of a free slot is not live either.
+    const decltype(a) forged{ a.index, a.generation + 1 };
+    EXPECT_FALSE(pool.contains(forged));
+    EXPECT_TRUE(pool.get(forged).is_none());
+    EXPECT_TRUE(pool.erase(forged).is_none());
+
+    // A reused slot gets a new generation, so the stale handle stays dead.
+    const auto d = pool.insert("d");
+    EXPECT_EQ(d.index, a.index);
+    EXPECT_NE(d, a);
+    EXPECT_TRUE(pool.get(a).is_none());
+    pool.get(d).unwrap() += "!";
+    EXPECT_EQ(std::as_const(pool).get(d), opt::some(std::string{ "d!" }));
+
+    std::string joined;
+    for (auto it = pool.begin(); it != pool.end(); ++it) {
+        EXPECT_EQ(&pool.get(pool.handle_of(it)).unwrap(), &*it);
+        joined += *it;
+    }
+    EXPECT_EQ(joined.size(), 5U);
+
+    pool.clear();
+    EXPECT_TRUE(pool.empty());
+    EXPECT_FALSE(pool.contains(b) || pool.contains(c) || pool.contains(d));
+    EXPECT_FALSE(pool.contains({}));
+
+    // A constructor that throws leaves the pool as it was.
+    struct checked {
+        explicit checked(int v) {
+            if (v < 0) {
+                throw std::invalid_argument("negative");
+            }
+        }
+    };
+    opt::slot_pool<checked> strict;
+    const auto first = strict.emplace(1);
+    EXPECT_THROW(strict.emplace(-1), std::invalid_argument);
+    EXPECT_EQ(strict.size(), 1U);
+    const auto second = strict.emplace(2);
+    EXPECT_TRUE(strict.contains(first) && strict.contains(second));
+    EXPECT_EQ(strict.handle_of(strict.begin() + 1), second);
+}
+
+// =============================
+// 47. Range Searches Returning option
+// =============================
+TEST(Ranges, Search) {
+    std::vector<int> ids{ 7, 3, 9, 3, 12 };
+    auto found = opt::ranges::find(ids, 3);
+    static_assert(std::is_same_v<decltype(found), opt::option<int &>>);
+    ASSERT_TRUE(found.is_some());
+    EXPECT_EQ(&*found, &ids[1]);
+    EXPECT_TRUE(opt::ranges::find(ids, 4).is_none());
+    EXPECT_EQ(opt::ranges::find_if(ids, [](int id) { return id > 8; }), opt::some(9));
+    EXPECT_EQ(opt::ranges::position(ids, [](int id) { return id > 8; }), opt::some(std::size_t{ 2 }));
+    EXPECT_TRUE(opt::ranges::position(ids, [](int id) { return id < 0; }).is_none());
+
+    // The first minimum and the last maximum, as in Rust.
+    const std::vector<std::string> words{ "bb", "a", "cc", "d" };
+    EXPECT_EQ(&*opt::ranges::min_by_key(words, &std::string::size), &words[1]);
+    EXPECT_EQ(&*opt::ranges::max_by_key(words, &std::string::size), &words[2]);
+    const std::vector<int> empty;
+    EXPECT_TRUE(opt::ranges::max_by_key(empty, [](int v) { return v; }).is_none());
+    EXPECT_TRUE(opt::ranges::last(empty).is_none());
+
+    const auto parse = [](const std::string &s) { return s.size() == 1 ? opt::some(s[0]) : opt::none_opt<char>(); };
+    EXPECT_EQ(opt::ranges::find_map(words, parse), opt::some('a'));
+
+    EXPECT_EQ(opt::ranges::first(words), opt::some(std::string{ "bb" }));
+    EXPECT_EQ(opt::ranges::last(words), opt::some(std::string{ "d" }));
+    EXPECT_EQ(opt::ranges::nth(words, 2), opt::some(std::string{ "cc" }));
+    EXPECT_TRUE(opt::ranges::nth(words, 4).is_none());
+    EXPECT_EQ(opt::ranges::nth(std::views::iota(10, 20), 3), opt::some(13));
+
+    constexpr auto in_constexpr = [] {
+        const int values[]{ 1, 2, 3 };
+        return opt::ranges::find(values, 2).is_some() && opt::ranges::first(values) == 1;
+    };
+    static_assert(in_constexpr());
+}
+
+TEST(Ranges, VectorizedFind) {
+    // Every position and tail length the register-wide path handles.
+    for (std::size_t n = 0; n < 80; ++n) {
+        std::vector<std::uint8_t> bytes(n, 0);
+        std::vector<long long> wide(n, -1);
+        std::vector<double> reals(n, 0.5);
+        for (std::size_t i = 0; i < n; ++i) {
+            bytes[i] = 1;
+            wide[i] = (1LL << 32) | 7;
+            reals[i] = -0.0;
+            EXPECT_EQ(&*opt::ranges::find(bytes, std::uint8_t{ 1 }), &bytes[i]);
+            EXPECT_EQ(&*opt::ranges::find(wide, (1LL << 32) | 7), &wide[i]);
+            EXPECT_EQ(&*opt::ranges::find(reals, 0.0), &reals[i]);
+            bytes[i] = 0;
+            wide[i] = 7;
+            reals[i] = 0.5;
+        }
+        EXPECT_TRUE(opt::ranges::find(bytes, std::uint8_t{ 1 }).is_none());
+        EXPECT_TRUE(opt::ranges::find(wide, (1LL << 32) | 7).is_none());
+    }
+}
+
+// =============================
+// 48. Branch-free Binary Search
+// =============================
+TEST(Ranges, BinarySearch) {
+    std::vector<int> sorted{ 2, 3, 5, 7, 11, 13, 17, 19, 23 };
+    EXPECT_EQ(opt::ranges::binary_position(sorted, 11), opt::some(std::size_t{ 4 }));
+    EXPECT_TRUE(opt::ranges::binary_position(sorted, 12).is_none());
+    EXPECT_TRUE(opt::ranges::binary_position(sorted, 1).is_none());
+    EXPECT_TRUE(opt::ranges::binary_position(sorted, 24).is_none());
+    EXPECT_TRUE(opt::ranges::binary_position(std::span<const int>{}, 1).is_none());
+    EXPECT_EQ(&*opt::ranges::binary_find(sorted, 23), &sorted.back());
+
+    const std::vector<int> descending{ 9, 7, 5, 3 };
+    EXPECT_EQ(opt::ranges::binary_position(descending, 3, std::ranges::greater{}), opt::some(std::size_t{ 3 }));
+    static_assert([] {
+        const int values[]{ 1, 3, 5, 7 };
+        return opt::ranges::binary_position(values, 5) == std::size_t{ 2 };
+    }());
+
+    // The batched and Eytzinger searches agree with the plain one for hits and misses.
+    std::vector<int> keys;
+    for (int k = 0; k <= 24; ++k) {
+        keys.push_back(k);
+    }
+    std::vector<opt::option<std::size_t>> batched(keys.size());
+    EXPECT_EQ(opt::ranges::binary_positions(sorted, keys, batched.begin()), batched.end());
+    const opt::ranges::eytzinger<int> table{ sorted };
+    EXPECT_EQ(table.size(), sorted.size());
+    for (std::size_t i = 0; i < keys.size(); ++i) {
+        const auto expected = opt::ranges::binary_position(sorted, keys[i]);
+        EXPECT_EQ(batched[i], expected);
+        EXPECT_EQ(table.position(keys[i]), expected);
+        EXPECT_EQ(table.find(keys[i]).is_some(), expected.is_some());
+    }
+    const opt::ranges::eytzinger<int> empty{ std::vector<int>{} };
+    EXPECT_EQ(empty.size(), 0U);
+    EXPECT_TRUE(empty.find(1).is_none());
+
+    // Deep enough for the prefetches to run past the last node.
+    std::vector<std::int64_t> evens(5000);
+    for (std::size_t i = 0; i < evens.size(); ++i) {
+        evens[i] = static_cast<std::int64_t>(2 * i);
+    }
+    const opt::ranges::eytzinger<std::int64_t> deep{ evens };
+    for (std::int64_t k = -1; k <= 10'000; ++k) {
+        EXPECT_EQ(deep.position(k), k % 2 == 0 && k < 10'000 ? opt::some(static_cast<std::size_t>(k / 2))
+                                                             : opt::option<std::size_t>{});
+    }
+}
+
+// =============================
+// 49. Sorting option Columns
+// =============================
+TEST(Sort, NonePosition) {
+    std::vector<opt::option<int>> small{ 3, opt::none, -1, 2, opt::none };
+    opt::sort(small);
+    EXPECT_EQ(small, (std::vector<opt::option<int>>{ opt::none, opt::none, -1, 2, 3 }));
+    opt::sort(small, opt::none_position::last);
+    EXPECT_EQ(small, (std::vector<opt::option<int>>{ -1, 2, 3, opt::none, opt::none }));
+
+    // Large enough for the radix path: the same result as a comparison sort.
+    std::vector<opt::option<double>> column;
+    for (int i = 0; i < 1000; ++i) {
+        column.push_back(i % 7 == 0 ? opt::none_opt<double>() : opt::some((i * 37 % 101) - 50.5));
+    }
+    column.push_back(opt::some(-0.0));
+    column.push_back(opt::some(0.0));
+    auto expected = column;
+    std::ranges::stable_sort(expected, [](const opt::option<double> &a, const opt::option<double> &b) {
+        return a.is_some() && (b.is_none() || *a < *b);
+    });
+    const auto original = column;
+    const auto order = opt::sort_indices(column, opt::none_position::last);
+    opt::sort(column, opt::none_position::last);
+    ASSERT_EQ(order.size(), column.size());
+    for (std::size_t i = 0; i < column.size(); ++i) {
+        EXPECT_EQ(column[i], expected[i]);
+        EXPECT_EQ(original[order[i]], expected[i]);
+    }
+
+    // Other payloads and comparators take the comparison sort.
+    std::vector<opt::option<std::string>> names{ "b", opt::none, "a", "c" };
+    opt::stable_sort(names, opt::none_position::last, std::ranges::greater{});
+    EXPECT_EQ(names, (std::vector<opt::option<std::string>>{ "c", "b", "a", opt::none }));
+}
+
+TEST(Sort, StableIndices) {
+    // Equal keys keep their input order, on both the radix and comparison paths.
+    for (const std::size_t n : { std::size_t{ 10 }, std::size_t{ 600 } }) {
+        std::vector<opt::option<int>> keys;
+        for (std::size_t i = 0; i < n; ++i) {
+            keys.push_back(i % 5 == 4 ? opt::none_opt<int>() : opt::some(static_cast<int>(i % 3)));
+        }
+        const auto order = opt::sort_indices(keys);
+        ASSERT_EQ(order.size(), n);
+        for (std::size_t i = 1; i < n; ++i) {
+            const auto &prev = keys[order[i - 1]];
+            const auto &next = keys[order[i]];
+            EXPECT_TRUE(prev <= next);
+            if (prev == next) {
+                EXPECT_LT(order[i - 1], order[i]);
+            }
+        }
+    }
+
+    // `0.0` and `-0.0` are equivalent under `<`: both sizes keep them in input
+    // order, `0.0` first here, and NaNs all go after infinity.
+    for (const std::size_t n : { std::size_t{ 30 }, std::size_t{ 300 } }) {
+        std::vector<opt::option<double>> zeros;
+        for (std::size_t i = 0; i < n; ++i) {
+            zeros.push_back(i % 3 == 2 ? opt::some(1.0) : opt::some(i % 3 == 0 ? 0.0 : -0.0));
+        }
+        const auto input = zeros;
+        const auto order = opt::sort_indices(zeros);
+        opt::stable_sort(zeros);
+        std::vector<bool> expected_signs;
+        for (const auto &z : input) {
+            if (*z == 0.0) {
+                expected_signs.push_back(std::signbit(*z));
+            }
+        }
+        for (std::size_t i = 0; i < expected_signs.size(); ++i) {
+            EXPECT_EQ(std::signbit(*zeros[i]), expected_signs[i]);
+            EXPECT_EQ(std::signbit(*input[order[i]]), expected_signs[i]);
+            if (i > 0) {
+                EXPECT_LT(order[i - 1], order[i]);
+            }
+        }
+        EXPECT_EQ(zeros.back(), opt::some(1.0));
+    }
+    // NaNs break `<`'s strict weak order, so below the radix threshold floats are
+    // compared by their keys too: every size orders them as the radix path does.
+    for (const std::size_t n : { std::size_t{ 30 }, std::size_t{ 300 } }) {
+        std::vector<opt::option<double>> nans(n, opt::some(2.0));
+        nans[0] = std::numeric_limits<double>::quiet_NaN();
+        nans[1] = -std::numeric_limits<double>::quiet_NaN();
+        nans[2] = std::numeric_limits<double>::infinity();
+        nans[3] = 0.0;
+        nans[4] = -0.0;
+        nans[5] = opt::none;
+        const auto nan_order = opt::sort_indices(nans);
+        EXPECT_EQ(nan_order[nan_order.size() - 3], 2U);
+        EXPECT_EQ(nan_order[nan_order.size() - 2], 0U);
+        EXPECT_EQ(nan_order.back(), 1U);
+        EXPECT_EQ(nan_order[0], 5U);
+        EXPECT_EQ(nan_order[1], 3U);
+        EXPECT_EQ(nan_order[2], 4U);
+
+        auto stable = nans;
+        opt::stable_sort(stable);
+        EXPECT_FALSE(std::signbit(*stable[1]));
+        EXPECT_TRUE(std::signbit(*stable[2]));
+        EXPECT_EQ(stable[n - 3], opt::some(std::numeric_limits<double>::infinity()));
+        EXPECT_TRUE(std::isnan(*stable[n - 2]) && !std::signbit(*stable[n - 2]));
+        EXPECT_TRUE(std::isnan(*stable[n - 1]) && std::signbit(*stable[n - 1]));
+
+        // `sort` follows `std::strong_order`: negative NaNs first, `-0.0` before `0.0`.
+        auto strong = nans;
+        opt::sort(strong, opt::none_position::last);
+        EXPECT_TRUE(std::isnan(*strong[0]) && std::signbit(*strong[0]));
+        EXPECT_TRUE(std::signbit(*strong[1]) && *strong[1] == 0.0);
+        EXPECT_FALSE(std::signbit(*strong[2]));
+        EXPECT_EQ(strong[n - 3], opt::some(std::numeric_limits<double>::infinity()));
+        EXPECT_TRUE(std::isnan(*strong[n - 2]) && !std::signbit(*strong[n - 2]));
+        EXPECT_TRUE(strong[n - 1].is_none());
+    }
+}
+
+// =============================
+// 50. Null-aware Group-by
+// =============================
+namespace {
+    // A key whose copies throw for negative values, to check that the worker
+    // threads hand their exceptions to the caller.
+    struct fragile_key {
+        int v;
+
+        explicit fragile_key(int value) : v(value) {}
+        fragile_key(fragile_key &&) noexcept = default;
+        fragile_key(const fragile_key &other) : v(other.v) {
+            if (v < 0) {
+                throw std::runtime_error("fragile_key");
+            }
+        }
+        auto operator=(const fragile_key &) -> fragile_key & = default;
+        auto operator=(fragile_key &&) noexcept -> fragile_key & = default;
+
+        friend auto operator==(const fragile_key &, const fragile_key &) -> bool = default;
+    };
+
+    auto fragile_keys(int n, int bad_row) -> std::vector<opt::option<fragile_key>> {
+        std::vector<opt::option<fragile_key>> keys;
+        for (int i = 0; i < n; ++i) {
+            keys.emplace_back(std::in_place, i == bad_row ? -1 : i % 1000);
+        }
+        return keys;
+    }
+} // namespace
+
+template <>
+struct std::hash<fragile_key> {
+    auto operator()(const fragile_key &key) const noexcept -> std::size_t {
+        return std::hash<int>{}(key.v);
+    }
+};
+
+TEST(GroupBy, Aggregates) {
+    const std::vector<opt::option<int>> keys{ 1, 2, opt::none, 1, 2, opt::none, 1 };
+    const std::vector<opt::option<double>> values{ 4.0, opt::none, 1.0, 2.0, opt::none, opt::none, 6.0 };
+
+    const auto g = opt::group_by(keys, values);
+    ASSERT_EQ(g.size(), 3U);
+    EXPECT_EQ(g.keys, (std::vector<opt::option<int>>{ 1, 2, opt::none }));
+    EXPECT_EQ(g.rows, (std::vector<std::size_t>{ 3, 2, 2 }));
+    EXPECT_EQ(g.count, (std::vector<std::size_t>{ 3, 0, 1 }));
+    // `SUM`, `MIN` and friends of a group without values are `none`.
+    EXPECT_EQ(g.sum, (std::vector<opt::option<double>>{ 12.0, opt::none, 1.0 }));
+    EXPECT_EQ(g.min, (std::vector<opt::option<double>>{ 2.0, opt::none, 1.0 }));
+    EXPECT_EQ(g.max, (std::vector<opt::option<double>>{ 6.0, opt::none, 1.0 }));
+    EXPECT_EQ(g.first, (std::vector<opt::option<double>>{ 4.0, opt::none, 1.0 }));
+    EXPECT_EQ(g.last, (std::vector<opt::option<double>>{ 6.0, opt::none, 1.0 }));
+
+    const auto dropped = opt::group_by(keys, values,
+                                       { .nulls = opt::null_keys::drop, .min = false, .max = false, .first = false });
+    EXPECT_EQ(dropped.keys, (std::vector<opt::option<int>>{ 1, 2 }));
+    EXPECT_EQ(dropped.sum, (std::vector<opt::option<double>>{ 12.0, opt::none }));
+    EXPECT_TRUE(dropped.min.empty());
+    EXPECT_EQ(dropped.last.size(), 2U);
+
+    const std::vector<opt::option<double>> short_values{ 1.0 };
+    EXPECT_THROW((void) opt::group_by(keys, short_values), opt::option_panic);
+
+    // Payloads without a sum need not be default-constructible.
+    struct price {
+        explicit price(int c) : cents(c) {}
+        auto operator<=>(const price &) const = default;
+        int cents;
+    };
+    static_assert(!std::is_default_constructible_v<price>);
+    const std::vector<opt::option<price>> prices{ price{ 5 }, price{ 3 }, opt::none, price{ 9 }, opt::none,
+                                                  opt::none, price{ 1 } };
+    const auto p = opt::group_by(keys, prices, { .sum = false, .first = false, .last = false });
+    EXPECT_EQ(p.count, (std::vector<std::size_t>{ 3, 1, 0 }));
+    EXPECT_EQ(p.min[0].map([](const price &m) { return m.cents; }), opt::some(1));
+    EXPECT_EQ(p.max[1].map([](const price &m) { return m.cents; }), opt::some(3));
+    EXPECT_TRUE(p.sum.empty());
+
+    // Integer sums wrap around modulo 2^64 instead of overflowing.
+    constexpr long long big = std::numeric_limits<long long>::max();
+    const std::vector<opt::option<int>> two{ 1, 1, 2, 2 };
+    const std::vector<opt::option<long long>> wide{ big, 2, -big, -3 };
+    const auto wrapped = opt::group_by(two, wide);
+    EXPECT_EQ(wrapped.sum, (std::vector<opt::option<long long>>{ std::numeric_limits<long long>::min() + 1,
+                                                                  std::numeric_limits<long long>::max() - 1 }));
+}
+
+TEST(GroupBy, Parallel) {
+    // Enough rows for the partitioned path; the groups match the serial ones.
+    std::vector<opt::option<std::string>> keys;
+    std::vector<opt::option<int>> values;
+    for (int i = 0; i < 100000; ++i) {
+        keys.push_back(i % 11 == 0 ? opt::none_opt<std::string>() : opt::some(std::to_string(i * 7 % 1009)));
+        values.push_back(i % 3 == 0 ? opt::none_opt<int>() : opt::some(i % 100 - 50));
+    }
+    const auto serial = opt::group_by(keys, values);
+    const auto parallel = opt::group_by(keys, values, { .threads = 4 });
+    ASSERT_EQ(parallel.size(), serial.size());
+    for (std::size_t i = 0; i < serial.size(); ++i) {
+        const auto it = std::ranges::find(parallel.keys, serial.keys[i]);
+        ASSERT_TRUE(it != parallel.keys.end());
+        const auto j = static_cast<std::size_t>(it - parallel.keys.begin());
+        EXPECT_EQ(parallel.rows[j], serial.rows[i]);
+        EXPECT_EQ(parallel.sum[j], serial.sum[i]);
+        EXPECT_EQ(parallel.min[j], serial.min[i]);
+        EXPECT_EQ(parallel.first[j], serial.first[i]);
+        EXPECT_EQ(parallel.last[j], serial.last[i]);
+    }
+
+    // An exception in a worker reaches the caller instead of terminating.
+    const auto fragile = fragile_keys(100000, 70000);
+    const std::vector<opt::option<int>> ones(fragile.size(), opt::some(1));
+    EXPECT_THROW((void) opt::group_by(fragile, ones, { .threads = 4 }), std::runtime_error);
+}
+
+// =============================
+// 51. Hash Join
+// =============================
+TEST(HashJoin, NullSemantics) {
+    const std::vector<opt::option<int>> orders{ 7, opt::none, 9, 7, 5 };
+    const std::vector<opt::option<int>> users{ 9, 7, opt::none, 7 };
+
+    // `none` keys match nothing, not even each other.
+    const auto inner = opt::hash_join(orders, users);
+    EXPECT_EQ(inner.left, (std::vector<std::size_t>{ 0, 0, 2, 3, 3 }));
+    EXPECT_EQ(inner.right, (std::vector<opt::option<std::size_t>>{ 1U, 3U, 0U, 1U, 3U }));
+
+    const auto outer = opt::hash_join(orders, users, { .kind = opt::join_kind::left });
+    EXPECT_EQ(outer.left, (std::vector<std::size_t>{ 0, 0, 1, 2, 3, 3, 4 }));
+    EXPECT_EQ(outer.right, (std::vector<opt::option<std::size_t>>{ 1U, 3U, opt::none, 0U, 1U, 3U, opt::none }));
+
+    const auto anti = opt::hash_join(orders, users, { .kind = opt::join_kind::anti });
+    EXPECT_EQ(anti.left, (std::vector<std::size_t>{ 1, 4 }));
+    EXPECT_TRUE(anti.right.empty());
+
+    const opt::join_table table{ users };
+    EXPECT_EQ(table.size(), 3U);
+    EXPECT_EQ(table.find(7).size(), 2U);
+    EXPECT_TRUE(table.find(5).empty());
+}
+
+TEST(HashJoin, Parallel) {
+    // Enough rows for the partitioned build and the chunked probe.
+    std::vector<opt::option<std::string>> left;
+    std::vector<opt::option<std::string>> right;
+    for (int i = 0; i < 60000; ++i) {
+        left.push_back(i % 13 == 0 ? opt::none_opt<std::string>() : opt::some(std::to_string(i * 7 % 5003)));
+        if (i % 2 == 0) {
+            right.push_back(i % 9 == 0 ? opt::none_opt<std::string>() : opt::some(std::to_string(i % 4001)));
+        }
+    }
+    for (const auto kind : { opt::join_kind::inner, opt::join_kind::left, opt::join_kind::anti }) {
+        const auto serial = opt::hash_join(left, right, { .kind = kind });
+        const auto parallel = opt::hash_join(left, right, { .kind = kind, .threads = 4 });
+        EXPECT_EQ(parallel.left, serial.left);
+        EXPECT_EQ(parallel.right, serial.right);
+    }
+
+    // An exception in a build worker reaches the caller.
+    const auto clean = fragile_keys(60000, -1);
+    const auto broken = fragile_keys(60000, 50000);
+    EXPECT_THROW((void) opt::hash_join(clean, broken, { .threads = 4 }), std::runtime_error);
+}
+
+// =============================
+// 52. Time-series Gap Filling
+// =============================
+TEST(MaskedColumn, Basic) {
+    const std::vector<opt::option<int>> options{ 1, opt::none, 3 };
+    opt::masked_column column{ options };
+    EXPECT_EQ(column.size(), 3U);
+    EXPECT_EQ(column.count(), 2U);
+    EXPECT_TRUE(column.get(1).is_none());
+    column.set(1, 2);
+    column.reset(0);
+    EXPECT_EQ(column.get(1), opt::some(2));
+    EXPECT_EQ(column.to_options(), (std::vector<opt::option<int>>{ opt::none, 2, 3 }));
+}
+
+TEST(TimeSeries, Fills) {
+    using column = std::vector<opt::option<double>>;
+    const column bid{ opt::none, 1.0, opt::none, opt::none, opt::none, 5.0, opt::none };
+
+    EXPECT_EQ(opt::ts::ffilled(bid), (column{ opt::none, 1.0, 1.0, 1.0, 1.0, 5.0, 5.0 }));
+    EXPECT_EQ(opt::ts::bfilled(bid), (column{ 1.0, 1.0, 5.0, 5.0, 5.0, 5.0, opt::none }));
+    EXPECT_EQ(opt::ts::filled_with(bid, 0.0), (column{ 0.0, 1.0, 0.0, 0.0, 0.0, 5.0, 0.0 }));
+    EXPECT_EQ(opt::ts::interpolated(bid), (column{ opt::none, 1.0, 2.0, 3.0, 4.0, 5.0, opt::none }));
+
+    // A limit fills at most that many rows of each gap, next to the source value.
+    EXPECT_EQ(opt::ts::ffilled(bid, 2), (column{ opt::none, 1.0, 1.0, 1.0, opt::none, 5.0, 5.0 }));
+    EXPECT_EQ(opt::ts::bfilled(bid, 1), (column{ 1.0, 1.0, opt::none, opt::none, 5.0, 5.0, opt::none }));
+    EXPECT_EQ(opt::ts::interpolated(bid, 1), (column{ opt::none, 1.0, 2.0, opt::none, opt::none, 5.0, opt::none }));
+
+    // The masked layout, with gaps that cross the 64-row words, gives the same.
+    column series(200);
+    for (std::size_t i = 0; i < series.size(); ++i) {
+        if (i % 50 < 20 || i % 7 == 0) {
+            series[i] = static_cast<double>(i);
+        }
+    }
+    opt::masked_column masked{ series };
+    opt::ts::interpolate(masked);
+    auto in_place = series;
+    opt::ts::interpolate(in_place);
+    EXPECT_EQ(masked.to_options(), in_place);
+    EXPECT_EQ(opt::ts::ffilled(opt::masked_column{ series }, 3).to_options(), opt::ts::ffilled(series, 3));
+    EXPECT_EQ(opt::ts::bfilled(opt::masked_column{ series }).to_options(), opt::ts::bfilled(series));
+}
+
+// =============================
+// 53. Rolling Windows
+// =============================
+TEST(TimeSeries, Rolling) {
+    const std::vector<opt::option<int>> ticks{ 4, opt::none, 2, 7, opt::none, opt::none, 1 };
+
+    // `none`s take up a place in the window but not in the aggregate.
+    EXPECT_EQ(opt::ts::rolling_count(ticks, 3), (std::vector<std::size_t>{ 1, 1, 2, 2, 2, 1, 1 }));
+    EXPECT_EQ(opt::ts::rolling_sum(ticks, 3), (std::vector<opt::option<long long>>{ 4, 4, 6, 9, 9, 7, 1 }));
+    EXPECT_EQ(opt::ts::rolling_min(ticks, 3), (std::vector<opt::option<int>>{ 4, 4, 2, 2, 2, 7, 1 }));
+    EXPECT_EQ(opt::ts::rolling_max(ticks, 3), (std::vector<opt::option<int>>{ 4, 4, 4, 7, 7, 7, 1 }));
+    EXPECT_EQ(opt::ts::rolling_mean(ticks, 3, 2),
+              (std::vector<opt::option<double>>{ opt::none, opt::none, 3.0, 4.5, 4.5, opt::none, opt::none }));
+    EXPECT_THROW((void) opt::ts::rolling_sum(ticks, 0), opt::option_panic);
+
+    // The streaming window agrees with the batch kernels.
+    opt::ts::rolling_window<int> live{ 3, 2 };
+    const auto max = opt::ts::rolling_max(ticks, 3, 2);
+    for (std::size_t i = 0; i < ticks.size(); ++i) {
+        live.push(ticks[i]);
+        EXPECT_EQ(live.max(), max[i]);
+    }
+    EXPECT_EQ(live.count(), 1U);
+    EXPECT_TRUE(live.sum().is_none());
+    live.clear();
+    live.push(opt::some(5));
+    live.push(opt::some(3));
+    EXPECT_EQ(live.sum(), opt::some(8LL));
+    EXPECT_EQ(live.min(), opt::some(3));
+}
+
+// =============================
+// 54. Kleene Logic
+// =============================
+TEST(Kleene, Scalar) {
+    using opt::kleene::and_;
+    using opt::kleene::not_;
+    using opt::kleene::or_;
+    using opt::kleene::xor_;
+    constexpr opt::option<bool> t{ true };
+    constexpr opt::option<bool> f{ false };
+    constexpr opt::option<bool> u{};
+
+    static_assert(and_(f, u) == f && and_(u, f) == f && and_(t, u).is_none() && and_(t, t) == t);
+    static_assert(or_(t, u) == t && or_(u, t) == t && or_(f, u).is_none() && or_(f, f) == f);
+    static_assert(xor_(t, f) == t && xor_(t, u).is_none());
+    static_assert(not_(f) == t && not_(u).is_none());
+    // Unlike `option::and_`, which only looks at presence.
+    EXPECT_EQ(f.and_(t), t);
+    EXPECT_EQ(and_(f, t), f);
+}
+
+TEST(Kleene, Columns) {
+    // Every pair of { true, false, none }, across a word boundary.
+    std::vector<opt::option<bool>> a;
+    std::vector<opt::option<bool>> b;
+    const opt::option<bool> values[]{ true, false, opt::none };
+    for (std::size_t i = 0; i < 90; ++i) {
+        a.push_back(values[i % 3]);
+        b.push_back(values[i / 3 % 3]);
+    }
+    const opt::kleene::column ca{ a };
+    const opt::kleene::column cb{ b };
+    const auto both = ca & cb;
+    const auto either = ca | cb;
+    const auto one = ca ^ cb;
+    const auto neither = !(ca | cb);
+    for (std::size_t i = 0; i < a.size(); ++i) {
+        EXPECT_EQ(both.get(i), opt::kleene::and_(a[i], b[i]));
+        EXPECT_EQ(either.get(i), opt::kleene::or_(a[i], b[i]));
+        EXPECT_EQ(one.get(i), opt::kleene::xor_(a[i], b[i]));
+        EXPECT_EQ(neither.get(i), opt::kleene::not_(opt::kleene::or_(a[i], b[i])));
+    }
+    EXPECT_EQ(ca.to_options(), a);
+    EXPECT_EQ(both.count_true(), 10U);
+
+    const opt::kleene::column shorter{ std::vector<opt::option<bool>>(3) };
+    EXPECT_THROW((void) (ca & shorter), opt::option_panic);
+}
+
+// =============================
+// 55. Batch Arithmetic
+// =============================
+
+TEST(Batch, Options) {
+    const std::vector<opt::option<double>> bid{ 1.0, opt::none, 3.0, 4.0 };
+    const std::vector<opt::option<double>> ask{ 2.0, 2.0, opt::none, 0.0 };
+
+    const std::vector<opt::option<double>> sum{ 3.0, opt::none, opt::none, 4.0 };
+    EXPECT_EQ(opt::batch::add(bid, ask), sum);
+    const std::vector<opt::option<double>> quotient{ 0.5, opt::none, opt::none, opt::none };
+    EXPECT_EQ(opt::batch::div(bid, ask), quotient);
+    const std::vector<opt::option<double>> doubled{ 2.0, opt::none, 6.0, 8.0 };
+    EXPECT_EQ(opt::batch::mul(bid, 2.0), doubled);
+    const std::vector<opt::option<double>> spread{ 9.0, opt::none, 7.0, 6.0 };
+    EXPECT_EQ(opt::batch::sub(10.0, bid), spread);
+    const std::vector<opt::option<double>> lower{ 1.0, opt::none, opt::none, 0.0 };
+    EXPECT_EQ(opt::batch::min(bid, ask), lower);
+    const std::vector<opt::option<double>> capped{ 2.0, opt::none, 3.0, 4.0 };
+    EXPECT_EQ(opt::batch::max(bid, 2.0), capped);
+
+    const std::vector<opt::option<int>> ints{ -7, std::numeric_limits<int>::min(), opt::none, 6 };
+    const std::vector<opt::option<int>> abs{ 7, opt::none, opt::none, 6 };
+    EXPECT_EQ(opt::batch::abs(ints), abs);
+    const std::vector<opt::option<int>> halves{ -3, std::numeric_limits<int>::min() / 2, opt::none, 3 };
+    EXPECT_EQ(opt::batch::div(ints, 2), halves);
+    const std::vector<opt::option<int>> negated{ 7, opt::none, opt::none, -6 };
+    EXPECT_EQ(opt::batch::div(ints, -1), negated);
+    EXPECT_EQ(opt::batch::div(ints, 0), (std::vector<opt::option<int>>(4)));
+    const std::vector<opt::option<int>> wrapped{ -6, std::numeric_limits<int>::min() + 1, opt::none, 7 };
+    EXPECT_EQ(opt::batch::add(ints, 1), wrapped);
+    EXPECT_EQ(opt::batch::sub(std::numeric_limits<int>::min(), std::vector<opt::option<int>>{ 1 }).front(),
+              opt::option<int>{ std::numeric_limits<int>::max() });
+
+    EXPECT_THROW(opt::batch::add(bid, std::vector<opt::option<double>>(3)), opt::option_panic);
+}
+
+TEST(Batch, MaskedColumns) {
+    std::vector<opt::option<std::int64_t>> a(200), b(200);
+    for (std::size_t i = 0; i < a.size(); ++i) {
+        if (i % 7 != 0) {
+            a[i] = static_cast<std::int64_t>(i) - 100;
+        }
+        if (i % 5 != 0) {
+            b[i] = static_cast<std::int64_t>(i % 11) - 5;
+        }
+    }
+    const opt::masked_column<std::int64_t> ma{ a }, mb{ b };
+
+    EXPECT_EQ(opt::batch::add(ma, mb).to_options(), opt::batch::add(a, b));
+    EXPECT_EQ(opt::batch::sub(ma, mb).to_options(), opt::batch::sub(a, b));
+    EXPECT_EQ(opt::batch::mul(ma, 3).to_options(), opt::batch::mul(a, 3));
+    EXPECT_EQ(opt::batch::max(ma, mb).to_options(), opt::batch::max(a, b));
+    EXPECT_EQ(opt::batch::abs(ma).to_options(), opt::batch::abs(a));
+
+    const auto quotient = opt::batch::div(ma, mb);
+    EXPECT_EQ(quotient.to_options(), opt::batch::div(a, b));
+    EXPECT_EQ(quotient.size(), 200u);
+    for (std::size_t i = 0; i < quotient.size(); ++i) {
+        EXPECT_EQ(quotient.is_some(i), a[i].is_some() && b[i].is_some() && *b[i] != 0);
+        if (!quotient.is_some(i)) {
+            EXPECT_EQ(quotient.values()[i], 0);
+        }
+    }
+    EXPECT_EQ(quotient.validity().back() >> (200 % 64), 0u);
+
+    const auto reciprocal = opt::batch::div(100, ma);
+    EXPECT_EQ(reciprocal.to_options(), opt::batch::div(100, a));
+    EXPECT_TRUE(reciprocal.get(100).is_none());
+    EXPECT_THROW(opt::batch::add(ma, opt::masked_column<std::int64_t>(3)), opt::option_panic);
+}
+
+// =============================
+// 56. Column Profiles
+// =============================
+
+TEST(ColumnStats, Profile) {
+    std::vector<opt::option<double>> latencies;
+    for (int i = 0; i < 1000; ++i) {
+        latencies.push_back(i % 10 == 0 ? opt::option<double>{} : opt::option<double>{ static_cast<double>(i % 200) });
+    }
+    opt::stats::profile_options options;
+    options.histogram = { .lo = 0.0, .hi = 100.0, .bins = 4 };
+    const auto p = opt::stats::profile(latencies, options);
+    EXPECT_EQ(p.rows(), 1000u);
+    EXPECT_EQ(p.nones(), 100u);
+    EXPECT_EQ(p.somes(), 900u);
+    EXPECT_EQ(p.min(), opt::option<double>{ 1.0 });
+    EXPECT_EQ(p.max(), opt::option<double>{ 199.0 });
+    EXPECT_NEAR(p.distinct(), 180.0, 10.0);
+    const std::vector<std::uint64_t> counts{ p.histogram().counts().begin(), p.histogram().counts().end() };
+    EXPECT_EQ(counts, (std::vector<std::uint64_t>{ 110, 115, 110, 115 }));
+    EXPECT_EQ(p.histogram().below(), 0u);
+    EXPECT_EQ(p.histogram().above(), 450u);
+    EXPECT_EQ(p.histogram().edge(1), 25.0);
+
+    // One row at a time, in parallel and from a masked column, the profile is the same.
+    opt::stats::column_profile<double> streamed{ options };
+    for (const auto &latency : latencies) {
+        streamed.add(latency);
+    }
+    options.threads = 3;
+    const auto parallel = opt::stats::profile(latencies, options);
+    const auto masked = opt::stats::profile(opt::masked_column<double>{ latencies }, options);
+    const opt::stats::column_profile<double> *profiles[]{ &streamed, &parallel, &masked };
+    for (const auto *q : profiles) {
+        EXPECT_EQ(q->nones(), p.nones());
+        EXPECT_EQ(q->min(), p.min());
+        EXPECT_EQ(q->max(), p.max());
+        EXPECT_EQ(q->distinct(), p.distinct());
+        EXPECT_TRUE(std::ranges::equal(q->histogram().counts(), p.histogram().counts()));
+    }
+
+    options.histogram.scale = opt::stats::histogram_scale::log;
+    EXPECT_THROW(opt::stats::profile(latencies, options), opt::option_panic);
+    options.histogram = {};
+    options.precision = 2;
+    EXPECT_THROW(opt::stats::profile(latencies, options), opt::option_panic);
+}
+
+TEST(ColumnStats, NaN) {
+    // NaNs are present but left out of the bounds, wherever they fall in a block.
+    const double nan = std::numeric_limits<double>::quiet_NaN();
+    std::vector<opt::option<double>> column;
+    for (int i = 0; i < 1000; ++i) {
+        column.push_back(i % 256 == 0 || i % 7 == 3 ? opt::option<double>{ nan } : opt::option<double>{ i * 0.5 });
+    }
+    opt::stats::column_profile<double> streamed;
+    for (const auto &row : column) {
+        streamed.add(row);
+    }
+    const auto blocks = opt::stats::profile(column);
+    const auto parallel = opt::stats::profile(column, { .threads = 3 });
+    const auto masked = opt::stats::profile(opt::masked_column<double>{ column });
+    const opt::stats::column_profile<double> *profiles[]{ &streamed, &blocks, &parallel, &masked };
+    for (const auto *q : profiles) {
+        EXPECT_EQ(q->somes(), 1000u);
+        EXPECT_EQ(q->min(), opt::option<double>{ 0.5 });
+        EXPECT_EQ(q->max(), opt::option<double>{ 999 * 0.5 });
+    }
+
+    const auto only_nan = opt::stats::profile(std::vector<opt::option<double>>(300, opt::option<double>{ nan }));
+    EXPECT_EQ(only_nan.somes(), 300u);
+    EXPECT_TRUE(only_nan.min().is_none() && only_nan.max().is_none());
+}
+
+TEST(ColumnStats, Distinct) {
+    std::vector<opt::option<std::string>> names;
+    for (int i = 0; i < 50000; ++i) {
+        names.push_back(i % 3 == 0 ? opt::option<std::string>{}
+                                   : opt::option<std::string>{ std::to_string(i % 20000) });
+    }
+    const auto p = opt::stats::profile(names);
+    EXPECT_EQ(p.nones(), 16667u);
+    EXPECT_EQ(p.min(), opt::option<std::string>{ "0" });
+    EXPECT_NEAR(p.distinct(), 20000.0, 20000.0 * 0.05);
+
+    opt::stats::column_profile<std::string> left, right;
+    for (int i = 0; i < 5000; ++i) {
+        left.add(std::to_string(i));
+        right.add(std::to_string(i + 2500));
+    }
+    left.merge(right);
+    EXPECT_EQ(left.rows(), 10000u);
+    EXPECT_NEAR(left.distinct(), 7500.0, 7500.0 * 0.05);
+    EXPECT_THROW(left.merge(opt::stats::column_profile<std::string>{ opt::stats::profile_options{ .precision = 10 } }),
+                 opt::option_panic);
+}
+
+// =============================
+// 57. Result
+// =============================
+
+namespace {
+    enum class parse_error : std::uint8_t { empty, bad_digit };
+
+    struct missing {
+        friend constexpr auto operator==(missing, missing) noexcept -> bool = default;
+    };
+
+    constexpr auto parse_digit(std::string_view s) -> opt::result<int, parse_error> {
+        if (s.empty()) {
+            return opt::err(parse_error::empty);
+        }
+        if (s[0] < '0' || s[0] > '9') {
+            return opt::err(parse_error::bad_digit);
+        }
+        return s[0] - '0';
+    }
+} // namespace
+
+TEST(Result, Basic) {
+    const auto seven = parse_digit("7");
+    const auto bad = parse_digit("x");
+    EXPECT_TRUE(seven.is_ok());
+    EXPECT_TRUE(bad.is_err());
+    EXPECT_EQ(seven, 7);
+    EXPECT_EQ(bad, opt::err(parse_error::bad_digit));
+    // Results of other value types compare by value or by error.
+    EXPECT_EQ(seven, (opt::result<long, parse_error>{ 7L }));
+    EXPECT_NE(seven, (opt::result<long, parse_error>{ 8L }));
+    EXPECT_NE(seven, (opt::result<long, parse_error>{ opt::err(parse_error::bad_digit) }));
+    EXPECT_EQ(bad, (opt::result<long, parse_error>{ opt::err(parse_error::bad_digit) }));
+    EXPECT_EQ(seven.unwrap(), 7);
+    EXPECT_EQ(bad.unwrap_err(), parse_error::bad_digit);
+    EXPECT_THROW((void)bad.unwrap(), opt::option_panic);
+    EXPECT_THROW((void)seven.expect_err("digit"), opt::option_panic);
+    EXPECT_EQ(seven.ok(), opt::option<int>{ 7 });
+    EXPECT_TRUE(bad.ok().is_none());
+    EXPECT_EQ(bad.err(), opt::option<parse_error>{ parse_error::bad_digit });
+    EXPECT_TRUE(seven.is_ok_and([](int v) { return v > 5; }));
+    EXPECT_TRUE(bad.is_err_and([](parse_error e) { return e == parse_error::bad_digit; }));
+
+    EXPECT_EQ(seven.map([](int v) { return v * 2; }), 14);
+    EXPECT_EQ(bad.map([](int v) { return v * 2; }), opt::err(parse_error::bad_digit));
+    EXPECT_EQ(bad.map_err([](parse_error) { return std::string{ "bad" }; }), opt::err(std::string{ "bad" }));
+    EXPECT_EQ(seven.map_or(0, [](int v) { return v + 1; }), 8);
+    EXPECT_EQ(bad.map_or_else([](parse_error) { return -1; }, [](int v) { return v; }), -1);
+    EXPECT_EQ(seven.and_then([](int v) { return parse_digit(v > 5 ? "" : "1"); }), opt::err(parse_error::empty));
+    EXPECT_EQ(bad.or_else([](parse_error) { return opt::result<int, std::string>{ 0 }; }), 0);
+    EXPECT_EQ(bad.and_(parse_digit("1")), opt::err(parse_error::bad_digit));
+    EXPECT_EQ(bad.or_(opt::result<int, missing>{ 3 }), 3);
+    EXPECT_EQ(bad.unwrap_or(4), 4);
+    EXPECT_EQ(bad.unwrap_or_else([](parse_error e) { return static_cast<int>(e) * 10; }), 10);
+    EXPECT_EQ(bad.unwrap_or_default(), 0);
+    int seen = 0;
+    (void)seven.inspect([&](int v) { seen = v; }).inspect_err([&](parse_error) { seen = -1; });
+    EXPECT_EQ(seen, 7);
+
+    static_assert(parse_digit("3").unwrap() == 3);
+    static_assert(parse_digit("3") == opt::result<long, parse_error>{ 3L });
+    static_assert(parse_digit("").is_err());
+}
+
+TEST(Result, Conversions) {
+    const opt::option<int> some{ 5 };
+    const opt::option<int> none;
+    EXPECT_EQ(opt::ok_or(some, parse_error::empty), 5);
+    EXPECT_EQ(opt::ok_or(none, parse_error::empty), opt::err(parse_error::empty));
+    EXPECT_EQ(opt::ok_or_else(none, [] { return std::string{ "none" }; }), opt::err(std::string{ "none" }));
+
+    const std::expected<int, parse_error> expected{ std::unexpect, parse_error::empty };
+    const opt::result<int, parse_error> from{ expected };
+    EXPECT_EQ(from, opt::err(parse_error::empty));
+    EXPECT_EQ(parse_digit("2").to_expected(), (std::expected<int, parse_error>{ 2 }));
+
+    const opt::result<opt::option<int>, parse_error> nested{ opt::option<int>{ 4 } };
+    EXPECT_EQ(nested.transpose(), (opt::option<opt::result<int, parse_error>>{ 4 }));
+    const opt::result<opt::result<int, parse_error>, parse_error> twice{ parse_digit("8") };
+    EXPECT_EQ(twice.flatten(), 8);
+
+    int x = 9;
+    const opt::result<int &, parse_error> ref{ x };
+    EXPECT_EQ(&ref.unwrap(), &x);
+    EXPECT_EQ(ref.copied(), 9);
+    const opt::result<std::string, std::string> text{ std::in_place, 3, 'a' };
+    EXPECT_EQ(text, std::string{ "aaa" });
+    EXPECT_EQ(text.map([](const std::string &s) { return s.size(); }), 3u);
+}
+
+TEST(Result, Layout) {
+    // An empty error takes option's layout, with the null pointer as the niche of references.
+    static_assert(sizeof(opt::result<int &, missing>) == sizeof(int *));
+    static_assert(sizeof(opt::result<int, missing>) == sizeof(opt::option<int>));
+    static_assert(sizeof(opt::result<int, parse_error>) == 2 * sizeof(int));
+    static_assert(std::is_trivially_copyable_v<opt::result<int, parse_error>>);
+    static_assert(!std::is_trivially_copyable_v<opt::result<std::string, parse_error>>);
+
+    int x = 1;
+    const opt::result<int &, missing> found{ x };
+    const opt::result<int &, missing> lost{ opt::err(missing{}) };
+    EXPECT_EQ(found, 1);
+    EXPECT_EQ(lost, opt::err(missing{}));
+
+    opt::result<std::string, std::string> r{ "value" };
+    r = opt::result<std::string, std::string>{ opt::err(std::string{ "error" }) };
+    EXPECT_EQ(r, opt::err(std::string{ "error" }));
+    r = opt::result<std::string, std::string>{ "again" };
+    EXPECT_EQ(r, std::string{ "again" });
+}
+
+// =============================
+// 58. Pull Iterators
+// =============================
+
+namespace {
+    // A source that is not a range: the Collatz sequence from `n` down to 1.
+    struct collatz {
+        int n;
+
+        constexpr auto next() -> opt::option<int> {
+            if (n == 0) {
+                return opt::none;
+            }
+            const int current = n;
+            n = n == 1 ? 0 : n % 2 == 0 ? n / 2 : 3 * n + 1;
+            return current;
+        }
+    };
+} // namespace
+
+TEST(Iter, Adaptors) {
+    std::vector<int> ids{ 4, 8, -1, 15, 16, 23 };
+    auto doubled = opt::iter::from(ids)
+                       .take_while([](int id) { return id >= 0; })
+                       .map([](int id) { return id * 2; });
+    EXPECT_EQ(doubled.size_hint(), (opt::iter::size_bounds{ 0, opt::option<std::size_t>{ 6 } }));
+    EXPECT_EQ(doubled.next(), opt::option<int>{ 8 });
+    EXPECT_EQ(doubled.fold(0, std::plus{}), 16);
+    EXPECT_TRUE(doubled.next().is_none());
+
+    auto odd = opt::iter::from(ids).filter([](int id) { return id % 2 != 0; });
+    EXPECT_EQ(odd.collect<std::vector<int>>(), (std::vector<int>{ -1, 15, 23 }));
+
+    const auto parse = [](const std::string &s) -> opt::option<int> {
+        if (s.empty() || s.find_first_not_of("0123456789") != std::string::npos) {
+            return opt::none;
+        }
+        return std::stoi(s);
+    };
+    const std::vector<std::string> words{ "12", "x", "", "7" };
+    EXPECT_EQ(opt::iter::from(words).filter_map(parse).collect<std::vector<int>>(), (std::vector<int>{ 12, 7 }));
+
+    auto every_third = opt::iter::from(std::views::iota(0, 10)).step_by(3);
+    EXPECT_EQ(every_third.size_hint(), (opt::iter::size_bounds{ 4, opt::option<std::size_t>{ 4 } }));
+    EXPECT_EQ(every_third.collect<std::vector<int>>(), (std::vector<int>{ 0, 3, 6, 9 }));
+    EXPECT_THROW((void)opt::iter::from(ids).step_by(0), opt::option_panic);
+
+    std::vector<int> tail{ 42 };
+    auto both = opt::iter::from(ids).chain(opt::iter::from(tail));
+    EXPECT_EQ(both.size_hint(), (opt::iter::size_bounds{ 7, opt::option<std::size_t>{ 7 } }));
+    EXPECT_EQ(both.count(), 7U);
+
+    // Elements of lvalue ranges are references into them.
+    for (int &id : opt::iter::from(ids).filter([](int id) { return id < 0; })) {
+        id = 0;
+    }
+    EXPECT_EQ(ids[2], 0);
+
+    const std::vector<char> names{ 'a', 'b', 'c' };
+    std::vector<std::pair<int, char>> pairs;
+    for (auto [id, name] : opt::iter::from(ids).zip(opt::iter::from(names))) {
+        pairs.emplace_back(id, name);
+    }
+    EXPECT_EQ(pairs, (std::vector<std::pair<int, char>>{ { 4, 'a' }, { 8, 'b' }, { 0, 'c' } }));
+}
+
+TEST(Iter, Bridges) {
+    EXPECT_EQ(opt::iter::from(collatz{ 6 }).collect<std::vector<int>>(),
+              (std::vector<int>{ 6, 3, 10, 5, 16, 8, 4, 2, 1 }));
+    EXPECT_EQ(opt::iter::size_hint(collatz{ 6 }), opt::iter::size_bounds{});
+
+    int calls = 0;
+    auto countdown = opt::iter::from_fn([&calls]() -> opt::option<int> {
+        return calls < 3 ? opt::option<int>{ ++calls } : opt::option<int>{};
+    });
+    EXPECT_EQ(countdown.fold(0, std::plus{}), 6);
+
+    // try_fold stops at the first `none`, and leaves the rest in the source.
+    auto digits = opt::iter::from(std::views::iota(1, 10));
+    const auto checked_sum = [](int acc, int x) -> opt::option<int> {
+        return acc + x <= 10 ? opt::option<int>{ acc + x } : opt::option<int>{};
+    };
+    EXPECT_TRUE(digits.try_fold(0, checked_sum).is_none());
+    EXPECT_EQ(digits.next(), opt::option<int>{ 6 });
+    EXPECT_EQ(opt::iter::from(std::views::iota(1, 5)).try_fold(0, checked_sum), opt::option<int>{ 10 });
+
+    // Sources are input ranges, for std::ranges algorithms and views.
+    auto evens = opt::iter::from(collatz{ 7 }).filter([](int x) { return x % 2 == 0; });
+    static_assert(std::ranges::input_range<decltype(evens)>);
+    EXPECT_EQ(std::ranges::max(evens), 52);
+    auto squares = opt::iter::from(std::views::iota(1)).map([](int x) { return x * x; });
+    std::vector<int> first;
+    std::ranges::copy(squares | std::views::take(4), std::back_inserter(first));
+    EXPECT_EQ(first, (std::vector<int>{ 1, 4, 9, 16 }));
+
+    // An option is a range of zero or one element.
+    opt::option<int> some{ 5 };
+    EXPECT_EQ(opt::iter::from(some).chain(opt::iter::from(some)).count(), 2U);
+}
+
+// =============================
+// 59. Text Scanning
+// =============================
+
+TEST(Text, Search) {
+    using opt::text::find;
+    EXPECT_EQ(find("key=value", '='), opt::option<std::size_t>{ 3 });
+    EXPECT_TRUE(find("key", '=').is_none());
+    EXPECT_EQ(find("abcabd", "abd"), opt::option<std::size_t>{ 3 });
+    EXPECT_EQ(find("abc", ""), opt::option<std::size_t>{ 0 });
+    EXPECT_TRUE(find("ab", "abc").is_none());
+    EXPECT_EQ(opt::text::rfind("a/b/c", '/'), opt::option<std::size_t>{ 3 });
+    EXPECT_EQ(opt::text::find_any("a,b;c", ",;"), opt::option<std::size_t>{ 1 });
+    EXPECT_TRUE(opt::text::find_any("abc", "").is_none());
+
+    // Past a register's width, and with more delimiters than get a register each.
+    const std::string line = std::string(100, 'x') + ";" + std::string(50, 'y') + "|";
+    EXPECT_EQ(find(line, ';'), opt::option<std::size_t>{ 100 });
+    EXPECT_EQ(find(line, "y|"), opt::option<std::size_t>{ 150 });
+    EXPECT_EQ(opt::text::find_any(line, "|;"), opt::option<std::size_t>{ 100 });
+    EXPECT_EQ(opt::text::find_any(line, "0123456789|"), opt::option<std::size_t>{ 151 });
+    EXPECT_EQ(opt::text::find_any(line.substr(101), "0123456789|"), opt::option<std::size_t>{ 50 });
+
+    static_assert(find("key=value", '=') == opt::option<std::size_t>{ 3 });
+    static_assert(opt::text::find_any("a b\tc", "\t") == opt::option<std::size_t>{ 3 });
+}
+
+TEST(Text, Split) {
+    using pair = std::pair<std::string_view, std::string_view>;
+    EXPECT_EQ(opt::text::split_once("key=value", '='), (opt::option<pair>{ pair{ "key", "value" } }));
+    EXPECT_EQ(opt::text::split_once("a::b::c", "::"), (opt::option<pair>{ pair{ "a", "b::c" } }));
+    EXPECT_EQ(opt::text::rsplit_once("a/b/c", '/'), (opt::option<pair>{ pair{ "a/b", "c" } }));
+    EXPECT_TRUE(opt::text::split_once("key", '=').is_none());
+    EXPECT_EQ(opt::text::strip_prefix("v1.2", "v"), opt::option<std::string_view>{ "1.2" });
+    EXPECT_EQ(opt::text::strip_prefix("-3", '-'), opt::option<std::string_view>{ "3" });
+    EXPECT_TRUE(opt::text::strip_prefix("1.2", "v").is_none());
+    EXPECT_EQ(opt::text::strip_suffix("a.txt", ".txt"), opt::option<std::string_view>{ "a" });
+    EXPECT_EQ(opt::text::strip_suffix("a;", ';'), opt::option<std::string_view>{ "a" });
+    static_assert(opt::text::split_once("k=v", '=').is_some());
+
+    std::string_view rest = "  alpha \t beta  ";
+    EXPECT_EQ(opt::text::next_token(rest, " \t"), opt::option<std::string_view>{ "alpha" });
+    EXPECT_EQ(rest, " \t beta  ");
+    EXPECT_EQ(opt::text::next_token(rest, " \t"), opt::option<std::string_view>{ "beta" });
+    EXPECT_TRUE(opt::text::next_token(rest, " \t").is_none());
+    EXPECT_TRUE(rest.empty());
+}
+
+TEST(Text, Tokenizer) {
+    std::vector<std::string_view> words;
+    for (std::string_view word : opt::text::tokenizer{ ",a,,bb,ccc,", "," }) {
+        words.push_back(word);
+    }
+    EXPECT_EQ(words, (std::vector<std::string_view>{ "a", "bb", "ccc" }));
+
+    const auto parse = [](std::string_view s) -> opt::option<int> {
+        int value = 0;
+        for (const char c : s) {
+            if (c < '0' || c > '9') {
+                return opt::none;
+            }
+            value = value * 10 + (c - '0');
+        }
+        return value;
+    };
+    EXPECT_EQ(opt::text::tokenizer("12 x 30\t4", " \t").filter_map(parse).fold(0, std::plus{}), 46);
+
+    opt::text::tokenizer fields{ "a b c", " " };
+    EXPECT_EQ(fields.size_hint(), (opt::iter::size_bounds{ 0, opt::option<std::size_t>{ 3 } }));
+    EXPECT_EQ(fields.next(), opt::option<std::string_view>{ "a" });
+    EXPECT_EQ(fields.remaining(), " b c");
+
+    constexpr std::size_t tokens = opt::text::tokenizer{ "x;y;;z", ";" }.count();
+    static_assert(tokens == 3);
+}
+
+// =============================
+// 60. Gather and Scatter
+// =============================
+
+TEST(Batch, Gather) {
+    const std::vector<double> price{ 10.0, 20.0, 30.0 };
+    const std::vector<opt::option<std::uint32_t>> match{ 2U, opt::none, 0U, 2U };
+    using doubles = std::vector<opt::option<double>>;
+    EXPECT_EQ(opt::batch::gather(price, match), (doubles{ 30.0, opt::none, 10.0, 30.0 }));
+    EXPECT_EQ(opt::batch::gather(price, std::span<const opt::option<std::uint32_t>>{ match }.first(2)),
+              (doubles{ 30.0, opt::none }));
+
+    // `none` values gather as `none`, from options and from masked columns.
+    const std::vector<opt::option<int>> qty{ 5, opt::none, 7 };
+    const std::vector<opt::option<int>> at{ 1, 2, opt::none, 0 };
+    using ints = std::vector<opt::option<int>>;
+    EXPECT_EQ(opt::batch::gather(qty, at), (ints{ opt::none, 7, opt::none, 5 }));
+    const opt::masked_column<int> masked{ qty };
+    EXPECT_EQ(opt::batch::gather(masked, at).to_options(), (ints{ opt::none, 7, opt::none, 5 }));
+
+    // Past a block of 64 rows, with negative and out-of-range indices.
+    std::vector<int> big(200);
+    for (std::size_t i = 0; i < big.size(); ++i) {
+        big[i] = static_cast<int>(i) * 3;
+    }
+    std::vector<opt::option<std::int64_t>> many(150);
+    for (std::size_t i = 0; i < many.size(); ++i) {
+        if (i % 3 != 0) {
+            many[i] = static_cast<std::int64_t>(199 - i);
+        }
+    }
+    const auto gathered = opt::batch::gather(big, many);
+    for (std::size_t i = 0; i < many.size(); ++i) {
+        EXPECT_EQ(gathered[i], i % 3 != 0 ? opt::option<int>{ static_cast<int>(199 - i) * 3 } : opt::option<int>{});
+    }
+    const std::vector<opt::option<int>> negative{ 0, -1 };
+    EXPECT_THROW((void)opt::batch::gather(price, negative), opt::option_panic);
+    EXPECT_THROW((void)opt::batch::gather(std::vector<int>{}, negative), opt::option_panic);
+    EXPECT_EQ(opt::batch::gather(std::vector<int>{}, std::vector<opt::option<int>>{ opt::none }), (ints{ opt::none }));
+}
+
+TEST(Batch, Scatter) {
+    const std::vector<int> qty{ 1, 2, 3, 4 };
+    const std::vector<opt::option<std::uint32_t>> to{ 2U, opt::none, 0U, 2U };
+    std::vector<int> out(3, -1);
+    opt::batch::scatter(qty, to, out);
+    EXPECT_EQ(out, (std::vector<int>{ 3, -1, 4 }));
+
+    const std::vector<opt::option<int>> maybe{ opt::none, 2, 3, 4 };
+    std::vector<opt::option<int>> slots(3, opt::option<int>{ 9 });
+    opt::batch::scatter(maybe, std::vector<opt::option<std::uint32_t>>{ 1U, opt::none, 0U, opt::none }, slots);
+    EXPECT_EQ(slots, (std::vector<opt::option<int>>{ 3, opt::none, 9 }));
+
+    opt::masked_column<int> target{ std::vector<opt::option<int>>{ 9, 9, 9 } };
+    opt::batch::scatter(opt::masked_column<int>{ maybe }, std::vector<opt::option<int>>{ 1, opt::none, 0, opt::none },
+                        target);
+    EXPECT_EQ(target.to_options(), (std::vector<opt::option<int>>{ 3, opt::none, 9 }));
+
+    // Nothing is written when an index is out of range.
+    const std::vector<opt::option<std::uint32_t>> bad{ 0U, 1U, 2U, 3U };
+    EXPECT_THROW(opt::batch::scatter(qty, bad, out), opt::option_panic);
+    EXPECT_EQ(out, (std::vector<int>{ 3, -1, 4 }));
+    EXPECT_THROW(opt::batch::scatter(qty, std::vector<opt::option<std::uint32_t>>{ 0U }, out), opt::option_panic);
+}
+
 // =============================
 //  Main entry for GoogleTest
 // =============================
@@ -9,6 +9,27 @@ opt_defaults()
 -- startswith so e.g. `--toolchain=msvc[vs=2026]` still matches "msvc"
 local toolchain = get_config("toolchain") or ""
 
+-- The assert-based tests of the opt-in builds, one set per toolchain. NDEBUG is
+-- undefined so that their asserts still run in release mode.
+local function opt_assert_tests(suffix)
+    target("test_stats_" .. suffix)
+        set_kind("binary")
+        add_files("tests/test_stats.cpp")
+        add_defines("OPT_OPTION_STATS=1")
+        add_undefines("NDEBUG")
+
+    target("test_profiler_" .. suffix)
+        set_kind("binary")
+        add_files("tests/test_profiler.cpp")
+        add_defines("OPT_OPTION_PROFILE=1", "OPT_OPTION_PROFILE_PERIOD=1")
+        add_undefines("NDEBUG")
+
+    target("test_core_" .. suffix)
+        set_kind("binary")
+        add_files("tests/test_core.cpp")
+        add_undefines("NDEBUG")
+end
+
 if toolchain:startswith("clang") then
     -- Clang (libc++)
     set_languages("clatest", "cxxlatest")
@@ -32,6 +53,8 @@ if toolchain:startswith("clang") then
         add_files("tests/test_unit.cpp")
         add_packages("gtest")
 
+    opt_assert_tests("clang")
+
     target("bench_clang")
         set_kind("binary")
         add_files("benchmarks/bench.cpp")
@@ -57,6 +80,8 @@ elseif toolchain:startswith("gcc") then
         add_files("tests/test_unit.cpp")
         add_packages("gtest")
 
+    opt_assert_tests("gcc")
+
     target("bench_gcc")
         set_kind("binary")
         add_files("benchmarks/bench.cpp")
@@ -83,6 +108,8 @@ elseif toolchain:startswith("msvc") then
         add_files("tests/test_unit.cpp")
         add_packages("gtest")
 
+    opt_assert_tests("msvc")
+
     target("bench_msvc")
         set_kind("binary")
         add_files("benchmarks/bench.cpp")
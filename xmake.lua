@@ -1,4 +1,5 @@
 includes("xmake.common.lua")
+includes("benchmarks/compile")
 opt_defaults()
 
 add_rules("plugin.compile_commands.autoupdate", {outputdir = ".vscode"})
@@ -33,6 +34,20 @@ target("test_unit_full_module")
     opt_use_module()
     opt_use_libcxx_test_support()
 
+target("test_stats")
+    set_kind("binary")
+    add_files("tests/test_stats.cpp")
+    add_defines("OPT_OPTION_STATS=1")
+
+target("test_profiler")
+    set_kind("binary")
+    add_files("tests/test_profiler.cpp")
+    add_defines("OPT_OPTION_PROFILE=1", "OPT_OPTION_PROFILE_PERIOD=1")
+
+target("test_core")
+    set_kind("binary")
+    add_files("tests/test_core.cpp")
+
 target("test_death")
     set_kind("binary")
     add_files("tests/test_death.cpp")
@@ -44,3 +59,26 @@ target("bench")
     add_files("benchmarks/bench.cpp")
     add_packages("benchmark")
     set_optimize("fastest")
+
+-- `bench.cpp` at -O0 and -Og, with and without `OPT_OPTION_DEBUG_PERF`, to track
+-- what debug builds cost: `xmake build bench_O0 bench_O0_perf`, then run both.
+for _, level in ipairs({"O0", "Og"}) do
+    for _, perf in ipairs({false, true}) do
+        target("bench_" .. level .. (perf and "_perf" or ""))
+            set_kind("binary")
+            set_default(false)
+            set_runtimes("MD")
+            add_files("benchmarks/bench.cpp")
+            add_packages("benchmark")
+            set_symbols("debug")
+            if level == "O0" then
+                set_optimize("none")
+            else
+                add_cxflags("-Og")
+            end
+            if perf then
+                add_defines("OPT_OPTION_DEBUG_PERF=1")
+            end
+        target_end()
+    end
+end